@@ -0,0 +1,249 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "pros/motors.h"
+#include "pros/misc.h"
+#include "pros/adi.h"
+
+namespace host {
+/**
+ * @brief What a motor has been told to do
+ *
+ */
+enum class MotorCommand { VOLTAGE, VELOCITY, POSITION, BRAKE };
+
+/**
+ * @brief State of a V5 smart motor
+ *
+ * Commands and measurements are in the frame of the motor itself, so reversing a motor flips them in the pros::Motor
+ * wrapper, not here. Positions are degrees of the output shaft, and velocities are rpm of the output shaft.
+ */
+struct MotorState {
+        /** whether the motor is plugged in. Unplugged motors fail every call with ENODEV */
+        bool connected = true;
+        pros::motor_gearset_e_t gearset = pros::E_MOTOR_GEARSET_18;
+        pros::motor_encoder_units_e_t units = pros::E_MOTOR_ENCODER_DEGREES;
+        pros::motor_brake_mode_e_t brakeMode = pros::E_MOTOR_BRAKE_COAST;
+        bool reversed = false;
+        // the command, written by pros::Motor
+        MotorCommand command = MotorCommand::VOLTAGE;
+        /** commanded voltage in millivolts, for VOLTAGE */
+        int32_t voltage = 0;
+        /** commanded velocity in rpm, for VELOCITY and POSITION */
+        int32_t targetVelocity = 0;
+        /** commanded position in degrees, for POSITION */
+        double targetPosition = 0;
+        int32_t currentLimit = 2500;
+        /** voltage limit in millivolts. 0 means no limit */
+        int32_t voltageLimit = 0;
+        /** whether a simulator updates the motor instead of the ideal backend */
+        bool simulated = false;
+        // measurements, written by the backend
+        double position = 0;
+        double velocity = 0;
+        /** voltage applied to the motor in millivolts */
+        int32_t appliedVoltage = 0;
+        /** current draw in milliamps */
+        int32_t current = 0;
+        /** output torque in Nm */
+        double torque = 0;
+        double temperature = 25;
+        /** position of the zero set by tare_position, in degrees, after reversal */
+        double zero = 0;
+};
+
+/**
+ * @brief State of a V5 rotation sensor
+ *
+ * Position and velocity are in the frame of the sensor, before it is reversed
+ */
+struct RotationState {
+        bool connected = true;
+        bool reversed = false;
+        /** position in centidegrees */
+        double position = 0;
+        /** velocity in centidegrees per second */
+        double velocity = 0;
+        /** position of the zero set by reset_position, in centidegrees, after reversal */
+        double zero = 0;
+};
+
+/**
+ * @brief State of a V5 inertial sensor
+ *
+ * Angles are in degrees, clockwise positive, and unbounded
+ */
+struct ImuState {
+        bool connected = true;
+        /** how long calibration takes, in milliseconds */
+        uint32_t calibrationTime = 2000;
+        /** when the current calibration finishes. 0 if the sensor isn't calibrating */
+        uint32_t calibrationEnd = 0;
+        double rotation = 0;
+        double pitch = 0;
+        double roll = 0;
+        /** yaw rate in degrees per second */
+        double gyroRate = 0;
+        /** acceleration in g */
+        double accelX = 0;
+        double accelY = 0;
+        double accelZ = 1;
+        // offsets set by tare and set functions
+        double rotationOffset = 0;
+        double headingOffset = 0;
+        double pitchOffset = 0;
+        double rollOffset = 0;
+        double yawOffset = 0;
+};
+
+/**
+ * @brief State of a V5 optical sensor
+ *
+ */
+struct OpticalState {
+        bool connected = true;
+        double hue = 0;
+        double saturation = 0;
+        double brightness = 0;
+        int32_t proximity = 0;
+        int32_t led = 0;
+};
+
+/**
+ * @brief State of one of the brain's 3-wire ports
+ *
+ * Quadrature encoders report their count through the top port, before it is reversed
+ */
+struct AdiState {
+        int32_t value = 0;
+        pros::adi_port_config_e_t config = pros::E_ADI_TYPE_UNDEFINED;
+        // encoder settings, written by pros::ADIEncoder
+        bool reversed = false;
+        int32_t zero = 0;
+};
+
+/**
+ * @brief State of a V5 controller
+ *
+ */
+struct ControllerState {
+        bool connected = true;
+        /** joystick values from -127 to 127, indexed by pros::controller_analog_e_t */
+        int32_t analog[4] = {};
+        /** button states, indexed by pros::controller_digital_e_t */
+        bool digital[18] = {};
+        /** button states the last time a new press was checked for */
+        bool pressed[18] = {};
+        /** the last rumble pattern */
+        std::string rumble;
+        /** the lines of the controller screen */
+        std::string text[3];
+};
+
+/**
+ * @brief Get the state of the motor on a smart port
+ *
+ * Device state can be read and written by the host program between runs, and by tick handlers. Every port has every
+ * kind of device, so there is no need to set anything up before using one.
+ *
+ * @param port the smart port, from 1 to 21
+ * @return MotorState&
+ */
+MotorState& motor(uint8_t port);
+
+/**
+ * @brief Get the state of the rotation sensor on a smart port
+ *
+ * @param port the smart port, from 1 to 21
+ * @return RotationState&
+ */
+RotationState& rotation(uint8_t port);
+
+/**
+ * @brief Get the state of the inertial sensor on a smart port
+ *
+ * @param port the smart port, from 1 to 21
+ * @return ImuState&
+ */
+ImuState& imu(uint8_t port);
+
+/**
+ * @brief Get the state of the optical sensor on a smart port
+ *
+ * @param port the smart port, from 1 to 21
+ * @return OpticalState&
+ */
+OpticalState& optical(uint8_t port);
+
+/**
+ * @brief Get the state of one of the brain's 3-wire ports
+ *
+ * @param port the port, from 1 to 8
+ * @return AdiState&
+ */
+AdiState& adi(uint8_t port);
+
+/**
+ * @brief Get the state of a controller
+ *
+ * @param id the controller
+ * @return ControllerState&
+ */
+ControllerState& controller(pros::controller_id_e_t id);
+
+/**
+ * @brief Get the text on a line of the brain screen
+ *
+ * @param line the line, from 0 to 7
+ * @return std::string&
+ */
+std::string& lcdLine(int16_t line);
+
+/**
+ * @brief Set the battery voltage
+ *
+ * @param voltage the voltage in millivolts. 12800 by default
+ */
+void setBatteryVoltage(int32_t voltage);
+
+/**
+ * @brief Get the battery voltage
+ *
+ * @return int32_t the voltage in millivolts
+ */
+int32_t getBatteryVoltage();
+
+/**
+ * @brief Set the competition status
+ *
+ * @param status bit mask of COMPETITION_DISABLED, COMPETITION_AUTONOMOUS and COMPETITION_CONNECTED
+ */
+void setCompetitionStatus(uint8_t status);
+
+/**
+ * @brief Get the competition status
+ *
+ * @return uint8_t bit mask of COMPETITION_DISABLED, COMPETITION_AUTONOMOUS and COMPETITION_CONNECTED
+ */
+uint8_t getCompetitionStatus();
+
+/**
+ * @brief Enable or disable the ideal motor backend
+ *
+ * The ideal backend moves every motor at the speed it was told to, with no acceleration or load. It is enough for
+ * code that waits on motor positions to make progress. Motors marked as simulated are always left to their simulator,
+ * so the ideal backend can keep moving the mechanisms a simulator doesn't model. Enabled by default.
+ *
+ * @param enabled whether the ideal backend updates motors
+ */
+void setIdealMotors(bool enabled);
+
+/**
+ * @brief Get the free speed of a gearset
+ *
+ * @param gearset the gearset
+ * @return double free speed in rpm
+ */
+double freeSpeed(pros::motor_gearset_e_t gearset);
+} // namespace host
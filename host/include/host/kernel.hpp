@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+namespace host {
+/**
+ * @brief How time moves on the host
+ *
+ * VIRTUAL jumps straight to the next wake up whenever every task is blocked, so a 15 second autonomous routine runs
+ * in however long the computation takes. REALTIME paces the same ticks against std::chrono::steady_clock, which is
+ * what you want when something outside the process is watching.
+ */
+enum class TimeMode { VIRTUAL, REALTIME };
+
+/**
+ * @brief Why a run ended
+ *
+ */
+enum class RunResult {
+    /** the entry function returned */
+    FINISHED,
+    /** the time limit was reached before the entry function returned */
+    TIMEOUT,
+    /** every task was blocked forever */
+    DEADLOCK
+};
+
+/**
+ * @brief Set how time moves
+ *
+ * Must be called before the first run. VIRTUAL by default
+ *
+ * @param mode the time mode
+ */
+void setTimeMode(TimeMode mode);
+
+/**
+ * @brief Get the current kernel time
+ *
+ * Safe to call from anywhere, including tick handlers
+ *
+ * @return uint64_t time in microseconds
+ */
+uint64_t micros();
+
+/**
+ * @brief Get the current kernel time
+ *
+ * @return uint32_t time in milliseconds
+ */
+uint32_t millis();
+
+/**
+ * @brief Add a function that is called every millisecond of kernel time
+ *
+ * Tick handlers are how device backends move the simulated world forwards. They are called by the scheduler, in the
+ * order they were added, between task switches, so no task is running while they are. They must not call any RTOS
+ * function other than millis() and micros().
+ *
+ * @param handler function that takes the time of the tick in milliseconds
+ */
+void onTick(std::function<void(uint32_t)> handler);
+
+/**
+ * @brief Run a function as an RTOS task, and schedule every task until it returns
+ *
+ * The host kernel is a single core scheduler built on std::thread: every task has its own thread, but only the
+ * highest priority ready task is allowed to run, exactly like FreeRTOS on the V5 brain. Tasks switch when they block,
+ * when they wake a higher priority task, or when they delay.
+ *
+ * Tasks outlive the run that created them, so the odometry task started in one run keeps going in the next. When a
+ * run ends, every other task is frozen until the next one starts. If the time limit is reached, the entry task is
+ * deleted where it stands.
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * host::run([] {
+ *     initialize();
+ *     autonomous();
+ * }, 15000);
+ * @endcode
+ *
+ * @param entry the function to run
+ * @param timeLimit the longest the run can take, in milliseconds of kernel time. 0 for no limit, which is the default
+ * @return RunResult why the run ended
+ */
+RunResult run(std::function<void()> entry, uint32_t timeLimit = 0);
+} // namespace host
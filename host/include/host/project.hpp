@@ -0,0 +1,15 @@
+#pragma once
+
+#include "host/simulator.hpp"
+
+namespace host {
+/**
+ * @brief Get the simulator for the example project's drivetrain
+ *
+ * The simulator models the drivetrain, inertial sensor and horizontal tracking wheel declared in src/main.cpp. It is
+ * created and started the first time this is called, so the project has to be linked in.
+ *
+ * @return DrivetrainSimulator&
+ */
+DrivetrainSimulator& projectSimulator();
+} // namespace host
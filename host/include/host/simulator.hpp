@@ -0,0 +1,196 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "pros/motors.hpp"
+#include "lemlib/pose.hpp"
+
+namespace host {
+/**
+ * @brief Electrical and mechanical model of a V5 smart motor
+ *
+ * Constants are for the motor itself, before the cartridge, so the same model works for every gearset. The defaults
+ * give 3600 rpm free speed at 12 V, and 2.1 Nm of stall torque through the red cartridge at the default 2.5 A current
+ * limit, with the torque curve flat up to about half of the free speed, like the published V5 curves.
+ */
+struct MotorModel {
+        /** torque per amp, in Nm/A */
+        double torqueConstant = 0.0233;
+        /** back EMF per unit of speed, in V/(rad/s) */
+        double backEmfConstant = 12.0 / 377;
+        /** winding resistance in ohms */
+        double resistance = 2.4;
+        /** inertia of the rotor in kg m^2 */
+        double rotorInertia = 3e-6;
+        /** efficiency of the cartridge and drivetrain gears */
+        double efficiency = 0.85;
+        /** gain of the motor's velocity controller, as a fraction of full voltage per fraction of free speed error */
+        double velocityGain = 4;
+        /** gain of the motor's position controller, as rpm per degree of error */
+        double positionGain = 2;
+};
+
+/**
+ * @brief Physical model of a differential drivetrain
+ *
+ * Lengths are in inches like the rest of LemLib, everything else is SI. The defaults match the example project: a six
+ * motor drivetrain on blue cartridges geared to 450 rpm, with 3.25" omni wheels on a 10" track.
+ */
+struct DrivetrainModel {
+        /** distance between the left and right wheels */
+        double trackWidth = 10;
+        /** distance between the front and back wheels */
+        double wheelBase = 10;
+        double wheelDiameter = 3.25;
+        /** speed of the wheels when the motors run at the free speed of their cartridge, in rpm */
+        double wheelRpm = 450;
+        /** robot mass in kg */
+        double mass = 6.5;
+        /** moment of inertia about the center of the robot, in kg m^2 */
+        double inertia = 0.2;
+        /** coefficient of friction between the wheels and the tiles, in the direction the wheels roll */
+        double wheelFriction = 1.0;
+        /** coefficient of friction sideways. Omni wheels slide sideways on their rollers */
+        double lateralFriction = 0.3;
+        /** rolling resistance as a fraction of the weight on the wheels */
+        double rollingResistance = 0.015;
+        /** how quickly friction builds up with slip, in N per m/s of slip. Higher values slip less before sliding */
+        double slipStiffness = 2000;
+        MotorModel motor;
+};
+
+/**
+ * @brief Headless simulator for a differential drivetrain
+ *
+ * Models the motors' torque-speed curves and current limits, the mass and inertia of the robot, and friction limits
+ * on the wheels, so the robot can spin its wheels when it accelerates too hard and slide sideways in fast turns. Every
+ * millisecond of kernel time it reads what the drivetrain motors were told to do, steps the physics, and writes the
+ * motor encoders, tracking wheels and inertial sensor back to the device state, where LemLib odometry reads them.
+ *
+ * The simulator trusts the robot's configuration: a reversed motor or sensor is assumed to be mounted backwards, so
+ * the robot drives forwards when LemLib thinks it should.
+ *
+ * @code {.cpp}
+ * host::DrivetrainSimulator sim(leftMotors, rightMotors);
+ * sim.addImu(10);
+ * sim.addTrackingWheel(5, lemlib::Omniwheel::NEW_325, -3.7, true);
+ * sim.start();
+ * host::run(autonomous, 15000);
+ * lemlib::Pose truth = sim.getPose();
+ * @endcode
+ */
+class DrivetrainSimulator {
+    public:
+        /**
+         * @brief Create a new drivetrain simulator
+         *
+         * @param left the left side of the drivetrain
+         * @param right the right side of the drivetrain
+         * @param model physical model of the drivetrain. Defaults to the example project's drivetrain
+         */
+        DrivetrainSimulator(pros::Motor_Group& left, pros::Motor_Group& right, DrivetrainModel model = {});
+        /**
+         * @brief Simulate an inertial sensor mounted on the robot
+         *
+         * @param port the smart port of the sensor
+         */
+        void addImu(uint8_t port);
+        /**
+         * @brief Simulate a tracking wheel on a rotation sensor
+         *
+         * The offset follows the same convention as lemlib::TrackingWheel: distance to the right of the tracking
+         * center for vertical wheels, and distance in front of it for horizontal wheels.
+         *
+         * @param port the smart port of the rotation sensor
+         * @param diameter diameter of the wheel, in inches
+         * @param offset offset of the wheel from the tracking center, in inches
+         * @param horizontal whether the wheel measures sideways motion instead of forwards motion
+         */
+        void addTrackingWheel(uint8_t port, double diameter, double offset, bool horizontal);
+        /**
+         * @brief Start simulating
+         *
+         * Takes the drivetrain motors from the ideal motor backend, and registers the simulator with the kernel. The
+         * simulator must outlive every run after this is called.
+         */
+        void start();
+        /**
+         * @brief Put the robot at rest somewhere on the field
+         *
+         * Sensors keep their readings, so odometry sees a jump unless it is reset too.
+         *
+         * @param pose the new pose of the robot, with the heading in degrees
+         */
+        void setPose(lemlib::Pose pose);
+        /**
+         * @brief Get the true pose of the robot
+         *
+         * @return lemlib::Pose the pose, with the heading in degrees
+         */
+        lemlib::Pose getPose() const;
+        /**
+         * @brief Get the true velocity of the robot, in its own frame
+         *
+         * @return lemlib::Pose sideways and forwards speed in inches per second, and yaw rate in degrees per second
+         */
+        lemlib::Pose getVelocity() const;
+        /**
+         * @brief Check whether any wheel is slipping
+         *
+         * @return true the wheels on at least one side are spinning faster or slower than the ground
+         */
+        bool isSlipping() const;
+        /**
+         * @brief Advance the simulation
+         *
+         * Called every millisecond once the simulator is started, and available to step it by hand without the
+         * kernel.
+         *
+         * @param dt time to advance by, in seconds
+         */
+        void step(double dt);
+    private:
+        struct Motor {
+                uint8_t port;
+                /** whether the motor is on the left side */
+                bool left;
+                /** position held by a motor in hold mode, in degrees */
+                double holdPosition = 0;
+                bool holding = false;
+        };
+
+        struct TrackingWheel {
+                uint8_t port;
+                double diameter;
+                double offset;
+                bool horizontal;
+        };
+
+        /**
+         * @brief Calculate the current a motor draws
+         *
+         * @param motor the motor
+         * @param speed speed of the motor's output shaft, in rpm, in the frame of the motor
+         * @return double the current in amps, in the frame of the motor
+         */
+        double motorCurrent(Motor& motor, double speed);
+
+        DrivetrainModel model;
+        std::vector<Motor> motors;
+        std::vector<TrackingWheel> trackingWheels;
+        std::vector<uint8_t> imus;
+        // pose in meters and radians, heading clockwise from the y axis
+        double x = 0;
+        double y = 0;
+        double heading = 0;
+        // velocity in the robot's frame, in m/s and rad/s. Yaw rate is clockwise
+        double forward = 0;
+        double sideways = 0;
+        double yawRate = 0;
+        // surface speed of the wheels on each side, in m/s
+        double leftWheel = 0;
+        double rightWheel = 0;
+        bool slipping = false;
+        bool started = false;
+};
+} // namespace host
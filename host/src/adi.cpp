@@ -0,0 +1,113 @@
+#include <cerrno>
+#include <cstddef>
+#include "pros/error.h"
+#include "pros/adi.hpp"
+#include "host/devices.hpp"
+
+namespace {
+/**
+ * @brief Convert a 3-wire port to a number, accepting 1-8, 'a'-'h' and 'A'-'H' like the firmware
+ *
+ * @return uint8_t the port from 1 to 8, or 0 if it isn't valid
+ */
+uint8_t portNumber(uint8_t port) {
+    if (port >= 'a' && port <= 'h') return port - 'a' + 1;
+    if (port >= 'A' && port <= 'H') return port - 'A' + 1;
+    if (port >= 1 && port <= 8) return port;
+    return 0;
+}
+
+/**
+ * @brief Get the state of a 3-wire port, setting errno if it isn't valid
+ *
+ * @return host::AdiState* the state, or nullptr if the port isn't valid
+ */
+host::AdiState* getState(uint8_t port) {
+    if (port == 0) {
+        errno = ENXIO;
+        return nullptr;
+    }
+    return &host::adi(port);
+}
+} // namespace
+
+namespace pros {
+ADIPort::ADIPort(std::uint8_t adi_port, adi_port_config_e_t type)
+    : _smart_port(INTERNAL_ADI_PORT),
+      _adi_port(portNumber(adi_port)) {
+    if (type != E_ADI_TYPE_UNDEFINED) set_config(type);
+}
+
+std::int32_t ADIPort::get_config() const {
+    host::AdiState* state = getState(_adi_port);
+    return state == nullptr ? PROS_ERR : state->config;
+}
+
+std::int32_t ADIPort::get_value() const {
+    host::AdiState* state = getState(_adi_port);
+    return state == nullptr ? PROS_ERR : state->value;
+}
+
+std::int32_t ADIPort::set_config(adi_port_config_e_t type) const {
+    host::AdiState* state = getState(_adi_port);
+    if (state == nullptr) return PROS_ERR;
+    state->config = type;
+    return 1;
+}
+
+std::int32_t ADIPort::set_value(std::int32_t value) const {
+    host::AdiState* state = getState(_adi_port);
+    if (state == nullptr) return PROS_ERR;
+    state->value = value;
+    return 1;
+}
+
+ADIAnalogIn::ADIAnalogIn(std::uint8_t adi_port)
+    : ADIPort(adi_port, E_ADI_ANALOG_IN) {}
+
+std::int32_t ADIAnalogIn::calibrate() const { return get_value(); }
+
+std::int32_t ADIAnalogIn::get_value_calibrated() const { return get_value(); }
+
+std::int32_t ADIAnalogIn::get_value_calibrated_HR() const { return get_value() * 16; }
+
+ADIAnalogOut::ADIAnalogOut(std::uint8_t adi_port)
+    : ADIPort(adi_port, E_ADI_ANALOG_OUT) {}
+
+ADIDigitalOut::ADIDigitalOut(std::uint8_t adi_port, bool init_state)
+    : ADIPort(adi_port, E_ADI_DIGITAL_OUT) {
+    set_value(init_state);
+}
+
+ADIDigitalIn::ADIDigitalIn(std::uint8_t adi_port)
+    : ADIPort(adi_port, E_ADI_DIGITAL_IN) {}
+
+std::int32_t ADIDigitalIn::get_new_press() const {
+    // the host doesn't track edges on 3-wire ports, so any press is new
+    return get_value() != 0;
+}
+
+ADIMotor::ADIMotor(std::uint8_t adi_port)
+    : ADIPort(adi_port, E_ADI_LEGACY_PWM) {}
+
+std::int32_t ADIMotor::stop() const { return set_value(0); }
+
+ADIEncoder::ADIEncoder(std::uint8_t adi_port_top, std::uint8_t adi_port_bottom, bool reversed)
+    : ADIPort(adi_port_top, E_ADI_LEGACY_ENCODER) {
+    host::AdiState* state = getState(_adi_port);
+    if (state != nullptr) state->reversed = reversed;
+}
+
+std::int32_t ADIEncoder::reset() const {
+    host::AdiState* state = getState(_adi_port);
+    if (state == nullptr) return PROS_ERR;
+    state->zero = state->reversed ? -state->value : state->value;
+    return 1;
+}
+
+std::int32_t ADIEncoder::get_value() const {
+    host::AdiState* state = getState(_adi_port);
+    if (state == nullptr) return PROS_ERR;
+    return (state->reversed ? -state->value : state->value) - state->zero;
+}
+} // namespace pros
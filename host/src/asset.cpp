@@ -0,0 +1,244 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "lemlib/asset.hpp"
+
+namespace {
+/**
+ * @brief An element type the tool can write
+ *
+ */
+struct ElementFormat {
+        const char* name;
+        lemlib::AssetType type;
+        size_t size;
+        size_t alignment;
+};
+
+const ElementFormat elementFormats[] = {
+    {"path", lemlib::AssetType::PATH_POINT, sizeof(lemlib::AssetPoint), alignof(lemlib::AssetPoint)},
+    {"float32", lemlib::AssetType::FLOAT32, sizeof(float), alignof(float)},
+    {"int32", lemlib::AssetType::INT32, sizeof(int32_t), alignof(int32_t)},
+    {"uint32", lemlib::AssetType::UINT32, sizeof(uint32_t), alignof(uint32_t)},
+    {"int16", lemlib::AssetType::INT16, sizeof(int16_t), alignof(int16_t)},
+    {"uint16", lemlib::AssetType::UINT16, sizeof(uint16_t), alignof(uint16_t)},
+    {"uint8", lemlib::AssetType::UINT8, sizeof(uint8_t), alignof(uint8_t)},
+};
+
+/**
+ * @brief Print how to use the program
+ *
+ */
+void usage(const char* name) {
+    std::printf("usage: %s [--type TYPE] INPUT OUTPUT\n"
+                "  converts text into a typed asset, to put in static/ and load with ASSET()\n"
+                "  --type      path (default): INPUT is a path in the text format, one 'x, y, speed' per line\n"
+                "              float32, int32, uint32, int16, uint16, uint8: INPUT is numbers separated by\n"
+                "              spaces, commas or new lines\n"
+                "              raw: INPUT is copied as it is, like a text path\n"
+                "  --compress  compress the asset. lemlib::decompressAssets() decompresses it at startup\n",
+                name);
+}
+
+/**
+ * @brief Append an LZ4 sequence: literals, then a match unless length is 0
+ *
+ */
+void appendSequence(std::vector<uint8_t>& out, const uint8_t* literals, size_t literalCount, size_t offset,
+                    size_t length) {
+    const size_t matchCode = length == 0 ? 0 : length - 4;
+    out.push_back(std::min<size_t>(literalCount, 15) << 4 | std::min<size_t>(matchCode, 15));
+    if (literalCount >= 15) {
+        size_t rest = literalCount - 15;
+        for (; rest >= 255; rest -= 255) out.push_back(255);
+        out.push_back(rest);
+    }
+    out.insert(out.end(), literals, literals + literalCount);
+    if (length == 0) return;
+    out.push_back(offset & 0xff);
+    out.push_back(offset >> 8);
+    if (matchCode >= 15) {
+        size_t rest = matchCode - 15;
+        for (; rest >= 255; rest -= 255) out.push_back(255);
+        out.push_back(rest);
+    }
+}
+
+/**
+ * @brief Compress data into an LZ4 block
+ *
+ * A greedy compressor that finds matches with a hash table of 4 byte sequences. Slower compressors would do a bit
+ * better, but this is only run when an asset changes.
+ */
+std::vector<uint8_t> lz4Compress(const std::vector<uint8_t>& in) {
+    std::vector<uint8_t> out;
+    std::vector<int64_t> table(1 << 16, -1);
+    const size_t n = in.size();
+    size_t anchor = 0;
+    size_t i = 0;
+    // the format needs the last match to start 12 bytes before the end, and the last 5 bytes to be literals
+    while (n >= 13 && i < n - 12) {
+        uint32_t sequence;
+        std::memcpy(&sequence, in.data() + i, sizeof(sequence));
+        const uint32_t hash = (sequence * 2654435761u) >> 16;
+        const int64_t candidate = table[hash];
+        table[hash] = i;
+        if (candidate < 0 || i - candidate > 65535 || std::memcmp(in.data() + candidate, in.data() + i, 4) != 0) {
+            i++;
+            continue;
+        }
+        size_t length = 4;
+        while (i + length < n - 5 && in[candidate + length] == in[i + length]) length++;
+        appendSequence(out, in.data() + anchor, i - anchor, i - candidate, length);
+        i += length;
+        anchor = i;
+    }
+    appendSequence(out, in.data() + anchor, n - anchor, 0, 0);
+    return out;
+}
+
+/**
+ * @brief Append a number to the elements, as the given type
+ *
+ */
+void appendNumber(std::vector<uint8_t>& data, lemlib::AssetType type, size_t size, double number) {
+    uint8_t bytes[4];
+    switch (type) {
+        case lemlib::AssetType::FLOAT32: {
+            const float value = number;
+            std::memcpy(bytes, &value, sizeof(value));
+            break;
+        }
+        case lemlib::AssetType::INT32: {
+            const int32_t value = number;
+            std::memcpy(bytes, &value, sizeof(value));
+            break;
+        }
+        case lemlib::AssetType::UINT32: {
+            const uint32_t value = number;
+            std::memcpy(bytes, &value, sizeof(value));
+            break;
+        }
+        case lemlib::AssetType::INT16: {
+            const int16_t value = number;
+            std::memcpy(bytes, &value, sizeof(value));
+            break;
+        }
+        case lemlib::AssetType::UINT16: {
+            const uint16_t value = number;
+            std::memcpy(bytes, &value, sizeof(value));
+            break;
+        }
+        default: bytes[0] = number;
+    }
+    data.insert(data.end(), bytes, bytes + size);
+}
+/**
+ * @brief Read text and convert it into a typed asset
+ *
+ */
+std::vector<uint8_t> typedAsset(const ElementFormat& format, FILE* in) {
+    std::vector<uint8_t> data;
+    uint32_t count = 0;
+    if (format.type == lemlib::AssetType::PATH_POINT) {
+        // read points until the end of the path, like the text parser does
+        char line[256];
+        while (std::fgets(line, sizeof(line), in) != nullptr && std::strncmp(line, "endData", 7) != 0) {
+            lemlib::AssetPoint point;
+            if (std::sscanf(line, "%f, %f, %f", &point.x, &point.y, &point.speed) != 3) continue;
+            const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&point);
+            data.insert(data.end(), bytes, bytes + sizeof(point));
+            count++;
+        }
+    } else {
+        double number;
+        while (std::fscanf(in, " %lf ,", &number) == 1) {
+            appendNumber(data, format.type, format.size, number);
+            count++;
+        }
+    }
+
+    lemlib::AssetHeader header {};
+    std::memcpy(header.magic, "LAST", 4);
+    header.version = lemlib::ASSET_VERSION;
+    header.type = format.type;
+    header.alignment = format.alignment;
+    header.count = count;
+    header.elementSize = format.size;
+    header.dataOffset = (sizeof(header) + format.alignment - 1) / format.alignment * format.alignment;
+    std::fprintf(stderr, "converted %u %s elements\n", count, format.name);
+
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&header);
+    std::vector<uint8_t> file(bytes, bytes + sizeof(header));
+    file.resize(header.dataOffset, 0);
+    file.insert(file.end(), data.begin(), data.end());
+    return file;
+}
+} // namespace
+
+/**
+ * @brief Convert a text path or a list of numbers into a typed asset, and compress assets
+ *
+ */
+int main(int argc, char** argv) {
+    const char* typeName = "path";
+    bool compress = false;
+    std::vector<const char*> paths;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--type") == 0 && i + 1 < argc) typeName = argv[++i];
+        else if (std::strcmp(argv[i], "--compress") == 0) compress = true;
+        else if (argv[i][0] != '-') paths.push_back(argv[i]);
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    const ElementFormat* format = nullptr;
+    for (const ElementFormat& candidate : elementFormats) {
+        if (std::strcmp(candidate.name, typeName) == 0) format = &candidate;
+    }
+    const bool raw = std::strcmp(typeName, "raw") == 0;
+    if ((format == nullptr && !raw) || paths.size() != 2) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    FILE* in = std::fopen(paths[0], "rb");
+    if (in == nullptr) {
+        std::fprintf(stderr, "could not open %s\n", paths[0]);
+        return 1;
+    }
+    std::vector<uint8_t> file;
+    if (raw) {
+        for (int c = std::fgetc(in); c != EOF; c = std::fgetc(in)) file.push_back(c);
+    } else {
+        file = typedAsset(*format, in);
+    }
+    std::fclose(in);
+
+    if (compress) {
+        const std::vector<uint8_t> compressed = lz4Compress(file);
+        lemlib::CompressedAssetHeader header;
+        std::memcpy(header.magic, "LZ4B", 4);
+        header.rawSize = file.size();
+        header.compressedSize = compressed.size();
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&header);
+        std::fprintf(stderr, "compressed %zu bytes to %zu\n", file.size(), sizeof(header) + compressed.size());
+        if (sizeof(header) + compressed.size() >= file.size()) {
+            std::fprintf(stderr, "the asset doesn't compress, so it is smaller without --compress\n");
+        }
+        file.assign(bytes, bytes + sizeof(header));
+        file.insert(file.end(), compressed.begin(), compressed.end());
+    }
+
+    FILE* out = std::fopen(paths[1], "wb");
+    if (out == nullptr) {
+        std::fprintf(stderr, "could not open %s\n", paths[1]);
+        return 1;
+    }
+    std::fwrite(file.data(), 1, file.size(), out);
+    std::fclose(out);
+    return 0;
+}
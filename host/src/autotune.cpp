@@ -0,0 +1,105 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "main.h"
+#include "lemlib/api.hpp"
+#include "host/kernel.hpp"
+#include "host/project.hpp"
+
+// the robot declared in src/main.cpp
+extern lemlib::Chassis chassis;
+extern lemlib::ControllerSettings linearController;
+extern lemlib::ControllerSettings angularController;
+
+namespace {
+struct Options {
+        lemlib::AutotuneSettings settings;
+        bool angular = true;
+        bool lateral = true;
+};
+
+/**
+ * @brief Print the result of an experiment next to the gains in src/main.cpp
+ *
+ */
+void report(const char* name, const lemlib::AutotuneResult& result, const lemlib::ControllerSettings& current) {
+    if (!result.success) {
+        std::printf("%s: no stable oscillation before the timeout\n\n", name);
+        return;
+    }
+    std::printf("%s: Ku %.3f, Tu %.0f ms, amplitude %.3f\n", name, result.ultimateGain, result.ultimatePeriod,
+                result.amplitude);
+    std::printf("  %-20s %10s %10s\n", "", "autotune", "main.cpp");
+    std::printf("  %-20s %10.3f %10.3f\n", "kP", result.kP, current.kP);
+    std::printf("  %-20s %10.4f %10.4f\n", "kI", result.kI, current.kI);
+    std::printf("  %-20s %10.3f %10.3f\n", "kD", result.kD, current.kD);
+    std::printf("  %-20s %10.2f %10.2f\n", "windup range", result.windupRange, current.windupRange);
+    std::printf("  %-20s %10.2f %10.2f\n", "small error", result.smallError, current.smallError);
+    std::printf("  %-20s %10.0f %10.0f\n", "small error timeout", result.smallErrorTimeout, current.smallErrorTimeout);
+    std::printf("  %-20s %10.2f %10.2f\n", "large error", result.largeError, current.largeError);
+    std::printf("  %-20s %10.0f %10.0f\n\n", "large error timeout", result.largeErrorTimeout, current.largeErrorTimeout);
+}
+
+/**
+ * @brief Print how to use the program
+ *
+ */
+void usage(const char* name) {
+    std::printf("usage: %s [options]\n"
+                "  --angular         only tune the angular controller\n"
+                "  --lateral         only tune the lateral controller\n"
+                "  --amplitude N     relay output, out of 127. 60 by default\n"
+                "  --hysteresis N    hysteresis band of the relay, in degrees or inches. 0.5 by default\n"
+                "  --cycles N        oscillations to measure. 4 by default\n"
+                "  --timeout MS      timeout of each experiment. 10000 by default\n"
+                "  --integral        propose a PID controller instead of a PD controller\n",
+                name);
+}
+} // namespace
+
+/**
+ * @brief Run the relay autotuner against the drivetrain simulator
+ *
+ * Runs the angular and then the lateral experiment on the example project's chassis, and prints the ultimate gain and
+ * period of each, and the gains they propose next to the ones in src/main.cpp.
+ */
+int main(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(arg, "--angular") == 0) options.lateral = false;
+        else if (std::strcmp(arg, "--lateral") == 0) options.angular = false;
+        else if (std::strcmp(arg, "--amplitude") == 0 && hasValue) {
+            options.settings.relayAmplitude = std::atof(argv[++i]);
+        } else if (std::strcmp(arg, "--hysteresis") == 0 && hasValue) {
+            options.settings.hysteresis = std::atof(argv[++i]);
+        } else if (std::strcmp(arg, "--cycles") == 0 && hasValue) options.settings.cycles = std::atoi(argv[++i]);
+        else if (std::strcmp(arg, "--timeout") == 0 && hasValue) options.settings.timeout = std::atoi(argv[++i]);
+        else if (std::strcmp(arg, "--integral") == 0) options.settings.integral = true;
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    // results are printed below, so only keep failures from the chassis' own log
+    lemlib::infoSink()->setLowestLevel(lemlib::Level::WARN);
+    host::projectSimulator();
+    lemlib::AutotuneResult angular, lateral;
+    const host::RunResult result = host::run([&] {
+        // the parts of initialize() that motions depend on
+        chassis.calibrate();
+        chassis.setPose(0, 0, 0);
+        lemlib::setVoltageCompensation(12000);
+        if (options.angular) angular = chassis.autotuneAngular(options.settings);
+        // let the robot come to a stop between experiments
+        pros::delay(1000);
+        if (options.lateral) lateral = chassis.autotuneLateral(options.settings);
+    });
+    if (result != host::RunResult::FINISHED) return 1;
+
+    if (options.angular) report("angular", angular, angularController);
+    if (options.lateral) report("lateral", lateral, linearController);
+    return (options.angular && !angular.success) || (options.lateral && !lateral.success);
+}
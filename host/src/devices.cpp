@@ -0,0 +1,95 @@
+#include <algorithm>
+#include <cmath>
+#include "host/devices.hpp"
+#include "host/kernel.hpp"
+
+namespace host {
+namespace {
+// index 0 is unused so ports can be used directly
+MotorState motors[22];
+RotationState rotations[22];
+ImuState imus[22];
+OpticalState opticals[22];
+AdiState adiPorts[9];
+ControllerState controllers[2];
+std::string lcdLines[8];
+int32_t batteryVoltage = 12800;
+uint8_t competitionStatus = 0;
+bool idealMotors = true;
+
+/**
+ * @brief Move a motor at exactly the speed it was told to for one millisecond
+ *
+ */
+void stepIdealMotor(MotorState& state) {
+    const double maxSpeed = freeSpeed(state.gearset);
+    const double voltage = state.voltageLimit == 0 ? state.voltage
+                                                   : std::clamp(state.voltage, -state.voltageLimit, state.voltageLimit);
+    switch (state.command) {
+        case MotorCommand::VOLTAGE: state.velocity = std::clamp(voltage / 12000, -1.0, 1.0) * maxSpeed; break;
+        case MotorCommand::VELOCITY: state.velocity = std::clamp<double>(state.targetVelocity, -maxSpeed, maxSpeed); break;
+        case MotorCommand::POSITION: {
+            const double speed = std::min<double>(std::abs(state.targetVelocity), maxSpeed);
+            const double error = state.targetPosition - state.position;
+            // rpm to degrees per millisecond
+            const double step = speed * 0.006;
+            state.velocity = std::abs(error) <= step ? error / 0.006 : std::copysign(speed, error);
+            break;
+        }
+        case MotorCommand::BRAKE: state.velocity = 0; break;
+    }
+    state.position += state.velocity * 0.006;
+    state.appliedVoltage = state.velocity / maxSpeed * 12000;
+}
+
+/**
+ * @brief Update every device for one millisecond
+ *
+ * @param time the time of the tick, in milliseconds
+ */
+void step(uint32_t time) {
+    for (ImuState& state : imus) {
+        if (state.calibrationEnd != 0 && time >= state.calibrationEnd) state.calibrationEnd = 0;
+    }
+    if (!idealMotors) return;
+    for (MotorState& state : motors) {
+        if (!state.simulated) stepIdealMotor(state);
+    }
+}
+
+// register the device backend with the kernel
+const bool registered = (onTick(step), true);
+} // namespace
+
+MotorState& motor(uint8_t port) { return motors[std::clamp<uint8_t>(port, 0, 21)]; }
+
+RotationState& rotation(uint8_t port) { return rotations[std::clamp<uint8_t>(port, 0, 21)]; }
+
+ImuState& imu(uint8_t port) { return imus[std::clamp<uint8_t>(port, 0, 21)]; }
+
+OpticalState& optical(uint8_t port) { return opticals[std::clamp<uint8_t>(port, 0, 21)]; }
+
+AdiState& adi(uint8_t port) { return adiPorts[std::clamp<uint8_t>(port, 0, 8)]; }
+
+ControllerState& controller(pros::controller_id_e_t id) { return controllers[id == pros::E_CONTROLLER_PARTNER]; }
+
+std::string& lcdLine(int16_t line) { return lcdLines[std::clamp<int16_t>(line, 0, 7)]; }
+
+void setBatteryVoltage(int32_t voltage) { batteryVoltage = voltage; }
+
+int32_t getBatteryVoltage() { return batteryVoltage; }
+
+void setCompetitionStatus(uint8_t status) { competitionStatus = status; }
+
+uint8_t getCompetitionStatus() { return competitionStatus; }
+
+void setIdealMotors(bool enabled) { idealMotors = enabled; }
+
+double freeSpeed(pros::motor_gearset_e_t gearset) {
+    switch (gearset) {
+        case pros::E_MOTOR_GEARSET_36: return 100;
+        case pros::E_MOTOR_GEARSET_06: return 600;
+        default: return 200;
+    }
+}
+} // namespace host
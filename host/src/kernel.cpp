@@ -0,0 +1,593 @@
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "pros/rtos.h"
+#include "host/kernel.hpp"
+
+namespace host {
+namespace {
+// wake tick of a task that is blocked forever
+constexpr uint32_t NEVER = UINT32_MAX;
+
+/**
+ * @brief What a blocked task is waiting for
+ *
+ */
+enum class Wait { NONE, DELAY, NOTIFY, MUTEX, JOIN };
+
+/**
+ * @brief Task control block
+ *
+ */
+struct Task {
+        std::string name;
+        uint32_t priority = 0;
+        pros::task_state_e_t state = pros::E_TASK_STATE_READY;
+        Wait wait = Wait::NONE;
+        void* waitObject = nullptr;
+        uint32_t wakeTick = NEVER;
+        bool timedOut = false;
+        uint32_t notifyValue = 0;
+        bool notified = false;
+        // signalled when the task is picked to run
+        std::condition_variable cv;
+};
+
+/**
+ * @brief Non-recursive mutex with priority ordered waiters
+ *
+ */
+struct Mutex {
+        Task* owner = nullptr;
+        std::deque<Task*> waiters;
+};
+
+/**
+ * @brief Scheduler state
+ *
+ */
+struct Kernel {
+        std::mutex lock;
+        // every task that hasn't been deleted, in the order they were created
+        std::vector<Task*> tasks;
+        std::deque<Task*> ready;
+        // the task that is allowed to run
+        Task* current = nullptr;
+        // owner of mutexes taken from outside of any task
+        Task external;
+        std::vector<std::function<void(uint32_t)>> tickHandlers;
+        std::atomic<uint32_t> ticks = 0;
+        TimeMode mode = TimeMode::VIRTUAL;
+        std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+        // state of the current run
+        bool active = false;
+        Task* entry = nullptr;
+        uint32_t deadline = NEVER;
+        RunResult result = RunResult::FINISHED;
+        std::condition_variable runCv;
+};
+
+/**
+ * @brief Get the kernel
+ *
+ * Created on first use so global constructors can create tasks and mutexes, and never destroyed so frozen tasks can
+ * still be waiting on it when the process exits
+ *
+ * @return Kernel&
+ */
+Kernel& kernel() {
+    static Kernel* k = new Kernel;
+    return *k;
+}
+
+// the task running on this thread, or nullptr if this thread isn't a task
+thread_local Task* self = nullptr;
+
+using Lock = std::unique_lock<std::mutex>;
+
+/**
+ * @brief Get the wall clock time since the kernel started
+ *
+ * @return uint64_t time in microseconds
+ */
+uint64_t realMicros(Kernel& k) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - k.epoch).count();
+}
+
+/**
+ * @brief Get the current tick
+ *
+ * @return uint32_t time in milliseconds
+ */
+uint32_t nowTick(Kernel& k) { return k.mode == TimeMode::VIRTUAL ? k.ticks.load() : realMicros(k) / 1000; }
+
+/**
+ * @brief Move a blocked task to the ready queue
+ *
+ * @param task the task
+ * @param timedOut whether the task woke because its timeout passed
+ */
+void wake(Kernel& k, Task* task, bool timedOut) {
+    if (task->wait == Wait::MUTEX) {
+        auto& waiters = static_cast<Mutex*>(task->waitObject)->waiters;
+        for (auto it = waiters.begin(); it != waiters.end(); it++) {
+            if (*it == task) {
+                waiters.erase(it);
+                break;
+            }
+        }
+    }
+    task->timedOut = timedOut;
+    task->wait = Wait::NONE;
+    task->waitObject = nullptr;
+    task->wakeTick = NEVER;
+    task->state = pros::E_TASK_STATE_READY;
+    k.ready.push_back(task);
+}
+
+/**
+ * @brief Remove a task from the scheduler
+ *
+ * Its thread is left waiting forever, as there is no way to stop a std::thread from the outside
+ *
+ * @param task the task
+ */
+void removeTask(Kernel& k, Task* task) {
+    if (task->state == pros::E_TASK_STATE_BLOCKED && task->wait == Wait::MUTEX) wake(k, task, true);
+    task->state = pros::E_TASK_STATE_DELETED;
+    for (auto it = k.ready.begin(); it != k.ready.end();) it = *it == task ? k.ready.erase(it) : it + 1;
+    for (auto it = k.tasks.begin(); it != k.tasks.end(); it++) {
+        if (*it == task) {
+            k.tasks.erase(it);
+            break;
+        }
+    }
+    // wake the tasks joining it
+    for (Task* other : k.tasks) {
+        if (other->state == pros::E_TASK_STATE_BLOCKED && other->wait == Wait::JOIN && other->waitObject == task)
+            wake(k, other, false);
+    }
+}
+
+/**
+ * @brief End the current run
+ *
+ * @param result why the run ended
+ */
+void finish(Kernel& k, RunResult result) {
+    k.active = false;
+    k.result = result;
+    // an entry task that didn't return is deleted where it stands
+    if (k.entry != nullptr) removeTask(k, k.entry);
+    k.entry = nullptr;
+}
+
+/**
+ * @brief Move kernel time forwards, calling the tick handlers on the way
+ *
+ * @param tick the tick to move to, in milliseconds
+ */
+void advanceTo(Kernel& k, uint32_t tick) {
+    while (k.ticks < tick) {
+        k.ticks++;
+        for (auto& handler : k.tickHandlers) handler(k.ticks);
+    }
+    for (size_t i = 0; i < k.tasks.size(); i++) {
+        Task* task = k.tasks[i];
+        if (task->state == pros::E_TASK_STATE_BLOCKED && task->wakeTick <= k.ticks) wake(k, task, true);
+    }
+}
+
+/**
+ * @brief Take the highest priority ready task off the ready queue
+ *
+ * @return Task* the task, or nullptr if no task is ready
+ */
+Task* pickNext(Kernel& k) {
+    auto best = k.ready.end();
+    for (auto it = k.ready.begin(); it != k.ready.end(); it++) {
+        if (best == k.ready.end() || (*it)->priority > (*best)->priority) best = it;
+    }
+    if (best == k.ready.end()) return nullptr;
+    Task* task = *best;
+    k.ready.erase(best);
+    return task;
+}
+
+/**
+ * @brief Pick the next task to run, moving time forwards until one is ready
+ *
+ * Called by whichever thread is giving up the cpu. If the run has ended, no task is picked and the thread waiting in
+ * run() is woken instead.
+ */
+void dispatch(Kernel& k, Lock& lock) {
+    while (true) {
+        if (k.mode == TimeMode::REALTIME) advanceTo(k, std::min(nowTick(k), k.deadline));
+        if (k.active && k.ticks >= k.deadline) finish(k, RunResult::TIMEOUT);
+        if (!k.active) {
+            k.current = nullptr;
+            k.runCv.notify_all();
+            return;
+        }
+        Task* next = pickNext(k);
+        if (next != nullptr) {
+            k.current = next;
+            next->state = pros::E_TASK_STATE_RUNNING;
+            next->cv.notify_one();
+            return;
+        }
+        // every task is blocked, so move time to the next wake up
+        uint32_t wakeTick = NEVER;
+        for (Task* task : k.tasks) {
+            if (task->state == pros::E_TASK_STATE_BLOCKED) wakeTick = std::min(wakeTick, task->wakeTick);
+        }
+        if (wakeTick == NEVER) {
+            finish(k, RunResult::DEADLOCK);
+            continue;
+        }
+        wakeTick = std::min(wakeTick, k.deadline);
+        if (k.mode == TimeMode::REALTIME) {
+            lock.unlock();
+            std::this_thread::sleep_until(k.epoch + std::chrono::milliseconds(wakeTick));
+            lock.lock();
+        }
+        advanceTo(k, wakeTick);
+    }
+}
+
+/**
+ * @brief Give up the cpu, and wait until the calling task is picked to run again
+ *
+ */
+void switchAway(Kernel& k, Lock& lock) {
+    Task* me = self;
+    dispatch(k, lock);
+    me->cv.wait(lock, [&] { return k.current == me; });
+}
+
+/**
+ * @brief Let a higher priority task run, if one is ready
+ *
+ */
+void yieldIfOutranked(Kernel& k, Lock& lock) {
+    if (self == nullptr || k.current != self) return;
+    for (Task* task : k.ready) {
+        if (task->priority > self->priority) {
+            self->state = pros::E_TASK_STATE_READY;
+            // a preempted task keeps its place in line
+            k.ready.push_front(self);
+            switchAway(k, lock);
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Block the calling task
+ *
+ * @param wait what the task is waiting for
+ * @param object the mutex or task being waited for
+ * @param timeout the longest time to wait for, in milliseconds
+ * @return true the task was woken by an event
+ * @return false the timeout passed
+ */
+bool block(Kernel& k, Lock& lock, Wait wait, void* object, uint32_t timeout) {
+    Task* me = self;
+    me->state = pros::E_TASK_STATE_BLOCKED;
+    me->wait = wait;
+    me->waitObject = object;
+    me->wakeTick = timeout == TIMEOUT_MAX ? NEVER : nowTick(k) + timeout;
+    me->timedOut = false;
+    switchAway(k, lock);
+    return !me->timedOut;
+}
+
+/**
+ * @brief Thread function of every task
+ *
+ */
+void taskMain(Task* task, pros::task_fn_t function, void* parameters) {
+    Kernel& k = kernel();
+    {
+        Lock lock(k.lock);
+        self = task;
+        task->cv.wait(lock, [&] { return k.current == task; });
+    }
+    function(parameters);
+    Lock lock(k.lock);
+    if (k.entry == task) {
+        k.entry = nullptr;
+        finish(k, RunResult::FINISHED);
+    }
+    removeTask(k, task);
+    dispatch(k, lock);
+}
+
+/**
+ * @brief Create a task, and add it to the ready queue
+ *
+ * @return Task* the new task
+ */
+Task* createTask(Kernel& k, pros::task_fn_t function, void* parameters, uint32_t priority, const char* name) {
+    Task* task = new Task;
+    task->name = std::string(name == nullptr ? "" : name).substr(0, TASK_NAME_MAX_LEN);
+    task->priority = priority;
+    k.tasks.push_back(task);
+    k.ready.push_back(task);
+    std::thread(taskMain, task, function, parameters).detach();
+    return task;
+}
+} // namespace
+
+void setTimeMode(TimeMode mode) {
+    Kernel& k = kernel();
+    Lock lock(k.lock);
+    k.mode = mode;
+    k.epoch = std::chrono::steady_clock::now() - std::chrono::milliseconds(k.ticks);
+}
+
+uint64_t micros() {
+    Kernel& k = kernel();
+    return k.mode == TimeMode::VIRTUAL ? uint64_t(k.ticks) * 1000 : realMicros(k);
+}
+
+uint32_t millis() { return micros() / 1000; }
+
+void onTick(std::function<void(uint32_t)> handler) {
+    Kernel& k = kernel();
+    Lock lock(k.lock);
+    k.tickHandlers.push_back(std::move(handler));
+}
+
+RunResult run(std::function<void()> entry, uint32_t timeLimit) {
+    Kernel& k = kernel();
+    if (self != nullptr) throw std::logic_error("host::run can't be called from a task");
+    Lock lock(k.lock);
+    auto function = new std::function<void()>(std::move(entry));
+    k.entry = createTask(
+        k,
+        [](void* parameters) {
+            std::unique_ptr<std::function<void()>> ptr {static_cast<std::function<void()>*>(parameters)};
+            (*ptr)();
+        },
+        function, TASK_PRIORITY_DEFAULT, "entry");
+    k.active = true;
+    k.deadline = timeLimit == 0 ? NEVER : nowTick(k) + timeLimit;
+    dispatch(k, lock);
+    k.runCv.wait(lock, [&] { return !k.active && k.current == nullptr; });
+    return k.result;
+}
+} // namespace host
+
+using namespace host;
+
+namespace pros::c {
+uint32_t millis() { return host::millis(); }
+
+uint64_t micros() { return host::micros(); }
+
+task_t task_create(task_fn_t function, void* const parameters, uint32_t prio, const uint16_t stack_depth,
+                   const char* const name) {
+    Kernel& k = kernel();
+    Lock lock(k.lock);
+    Task* task = createTask(k, function, parameters, prio, name);
+    yieldIfOutranked(k, lock);
+    return task;
+}
+
+void task_delete(task_t task) {
+    Kernel& k = kernel();
+    Lock lock(k.lock);
+    Task* target = task == nullptr ? self : static_cast<Task*>(task);
+    if (target == nullptr || target->state == E_TASK_STATE_DELETED) return;
+    if (target == k.entry) {
+        k.entry = nullptr;
+        finish(k, RunResult::FINISHED);
+    }
+    removeTask(k, target);
+    if (target == self) {
+        dispatch(k, lock);
+        // a deleted task never runs again
+        target->cv.wait(lock, [] { return false; });
+    }
+    yieldIfOutranked(k, lock);
+}
+
+void task_delay(const uint32_t milliseconds) {
+    if (self == nullptr) return;
+    Kernel& k = kernel();
+    Lock lock(k.lock);
+    if (milliseconds == 0) {
+        // yield to tasks of the same priority
+        self->state = E_TASK_STATE_READY;
+        k.ready.push_back(self);
+        switchAway(k, lock);
+    } else {
+        block(k, lock, Wait::DELAY, nullptr, milliseconds);
+    }
+}
+
+void delay(const uint32_t milliseconds) { task_delay(milliseconds); }
+
+void task_delay_until(uint32_t* const prev_time, const uint32_t delta) {
+    const uint32_t wakeTime = *prev_time + delta;
+    const int32_t remaining = int32_t(wakeTime - host::millis());
+    if (remaining > 0) task_delay(remaining);
+    *prev_time = wakeTime;
+}
+
+uint32_t task_get_priority(task_t task) {
+    Kernel& k = kernel();
+    Lock lock(k.lock);
+    Task* target = task == nullptr ? self : static_cast<Task*>(task);
+    return target == nullptr ? 0 : target->priority;
+}
+
+void task_set_priority(task_t task, uint32_t prio) {
+    Kernel& k = kernel();
+    Lock lock(k.lock);
+    Task* target = task == nullptr ? self : static_cast<Task*>(task);
+    if (target == nullptr) return;
+    target->priority = prio;
+    yieldIfOutranked(k, lock);
+}
+
+task_state_e_t task_get_state(task_t task) {
+    Kernel& k = kernel();
+    Lock lock(k.lock);
+    Task* target = task == nullptr ? self : static_cast<Task*>(task);
+    return target == nullptr ? E_TASK_STATE_INVALID : target->state;
+}
+
+void task_suspend(task_t task) {
+    Kernel& k = kernel();
+    Lock lock(k.lock);
+    Task* target = task == nullptr ? self : static_cast<Task*>(task);
+    if (target == nullptr || target->state == E_TASK_STATE_DELETED) return;
+    if (target->state == E_TASK_STATE_BLOCKED) wake(k, target, true);
+    for (auto it = k.ready.begin(); it != k.ready.end();) it = *it == target ? k.ready.erase(it) : it + 1;
+    target->state = E_TASK_STATE_SUSPENDED;
+    if (target == self) switchAway(k, lock);
+}
+
+void task_resume(task_t task) {
+    Kernel& k = kernel();
+    Lock lock(k.lock);
+    Task* target = static_cast<Task*>(task);
+    if (target == nullptr || target->state != E_TASK_STATE_SUSPENDED) return;
+    target->state = E_TASK_STATE_READY;
+    k.ready.push_back(target);
+    yieldIfOutranked(k, lock);
+}
+
+uint32_t task_get_count(void) {
+    Kernel& k = kernel();
+    Lock lock(k.lock);
+    return k.tasks.size();
+}
+
+char* task_get_name(task_t task) {
+    Kernel& k = kernel();
+    Lock lock(k.lock);
+    Task* target = task == nullptr ? self : static_cast<Task*>(task);
+    return target == nullptr ? nullptr : target->name.data();
+}
+
+task_t task_get_by_name(const char* name) {
+    Kernel& k = kernel();
+    Lock lock(k.lock);
+    for (Task* task : k.tasks) {
+        if (task->name == name) return task;
+    }
+    return nullptr;
+}
+
+task_t task_get_current() { return self; }
+
+uint32_t task_notify_ext(task_t task, uint32_t value, notify_action_e_t action, uint32_t* prev_value) {
+    Kernel& k = kernel();
+    Lock lock(k.lock);
+    Task* target = static_cast<Task*>(task);
+    if (target == nullptr || target->state == E_TASK_STATE_DELETED) return 0;
+    if (prev_value != nullptr) *prev_value = target->notifyValue;
+    switch (action) {
+        case E_NOTIFY_ACTION_NONE: break;
+        case E_NOTIFY_ACTION_BITS: target->notifyValue |= value; break;
+        case E_NOTIFY_ACTION_INCR: target->notifyValue++; break;
+        case E_NOTIFY_ACTION_OWRITE: target->notifyValue = value; break;
+        case E_NOTIFY_ACTION_NO_OWRITE:
+            if (target->notified) return 0;
+            target->notifyValue = value;
+            break;
+    }
+    target->notified = true;
+    if (target->state == E_TASK_STATE_BLOCKED && target->wait == Wait::NOTIFY) {
+        wake(k, target, false);
+        yieldIfOutranked(k, lock);
+    }
+    return 1;
+}
+
+uint32_t task_notify(task_t task) { return task_notify_ext(task, 0, E_NOTIFY_ACTION_INCR, nullptr); }
+
+uint32_t task_notify_take(bool clear_on_exit, uint32_t timeout) {
+    if (self == nullptr) return 0;
+    Kernel& k = kernel();
+    Lock lock(k.lock);
+    if (self->notifyValue == 0 && timeout != 0) block(k, lock, Wait::NOTIFY, nullptr, timeout);
+    const uint32_t value = self->notifyValue;
+    if (value != 0) self->notifyValue = clear_on_exit ? 0 : value - 1;
+    self->notified = false;
+    return value;
+}
+
+bool task_notify_clear(task_t task) {
+    Kernel& k = kernel();
+    Lock lock(k.lock);
+    Task* target = task == nullptr ? self : static_cast<Task*>(task);
+    if (target == nullptr) return false;
+    // like FreeRTOS, this clears the pending state but not the value
+    const bool notified = target->notified;
+    target->notified = false;
+    return notified;
+}
+
+void task_join(task_t task) {
+    if (self == nullptr) return;
+    Kernel& k = kernel();
+    Lock lock(k.lock);
+    Task* target = static_cast<Task*>(task);
+    if (target == nullptr || target == self || target->state == E_TASK_STATE_DELETED) return;
+    block(k, lock, Wait::JOIN, target, TIMEOUT_MAX);
+}
+
+mutex_t mutex_create(void) { return new host::Mutex; }
+
+bool mutex_take(mutex_t mutex, uint32_t timeout) {
+    Kernel& k = kernel();
+    Lock lock(k.lock);
+    auto m = static_cast<host::Mutex*>(mutex);
+    Task* me = self == nullptr ? &k.external : self;
+    if (m->owner == nullptr) {
+        m->owner = me;
+        return true;
+    }
+    // threads that aren't tasks can't block
+    if (self == nullptr || timeout == 0) return false;
+    m->waiters.push_back(me);
+    // ownership is handed over by mutex_give
+    return block(k, lock, Wait::MUTEX, m, timeout);
+}
+
+bool mutex_give(mutex_t mutex) {
+    Kernel& k = kernel();
+    Lock lock(k.lock);
+    auto m = static_cast<host::Mutex*>(mutex);
+    Task* me = self == nullptr ? &k.external : self;
+    if (m->owner != me) return false;
+    if (m->waiters.empty()) {
+        m->owner = nullptr;
+        return true;
+    }
+    // hand the mutex to the highest priority waiter
+    auto best = m->waiters.begin();
+    for (auto it = m->waiters.begin(); it != m->waiters.end(); it++) {
+        if ((*it)->priority > (*best)->priority) best = it;
+    }
+    Task* next = *best;
+    m->waiters.erase(best);
+    m->owner = next;
+    next->wait = Wait::NONE;
+    wake(k, next, false);
+    yieldIfOutranked(k, lock);
+    return true;
+}
+
+void mutex_delete(mutex_t mutex) { delete static_cast<host::Mutex*>(mutex); }
+} // namespace pros::c
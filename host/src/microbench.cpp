@@ -0,0 +1,277 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+#include "lemlib/api.hpp"
+#include "lemlib/chassis/odom.hpp"
+#include "lemlib/logger/baseSink.hpp"
+#include "lemlib/logger/buffer.hpp"
+#include "host/devices.hpp"
+#include "host/simulator.hpp"
+
+// path following internals from src/lemlib/chassis/pursuit.cpp
+std::vector<lemlib::Pose> getData(const asset& path);
+int findClosest(lemlib::Pose pose, const std::vector<lemlib::Pose>& path);
+lemlib::Pose lookaheadPoint(lemlib::Pose lastLookahead, lemlib::Pose pose, const std::vector<lemlib::Pose>& path,
+                            float lookaheadDist);
+
+// gcc can't tell that the replacement operator new below pairs with the replacement operator delete
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+namespace {
+// every allocation the program makes, so benchmarks can report allocations per operation
+size_t allocations = 0;
+size_t allocatedBytes = 0;
+} // namespace
+
+void* operator new(std::size_t size) {
+    allocations++;
+    allocatedBytes += size;
+    if (void* pointer = std::malloc(size == 0 ? 1 : size)) return pointer;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) { return operator new(size); }
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+
+void operator delete[](void* pointer) noexcept { operator delete(pointer); }
+
+void operator delete(void* pointer, std::size_t) noexcept { operator delete(pointer); }
+
+void operator delete[](void* pointer, std::size_t) noexcept { operator delete(pointer); }
+
+namespace {
+/**
+ * @brief Stop the compiler from optimizing away a value
+ *
+ */
+template <typename T> void keep(T&& value) { asm volatile("" : : "g"(&value) : "memory"); }
+
+const char* filter = nullptr;
+
+/**
+ * @brief Time a function and print its cost per call
+ *
+ * The number of calls is doubled until a round takes long enough to time, then the fastest of five rounds is
+ * reported, so background noise makes results worse rather than better.
+ *
+ * @param name name of the benchmark
+ * @param function the function to time
+ * @param maxIterations most calls in one round, for benchmarks that use memory on every call
+ * @param operations operations done by every call, for benchmarks that can only time several at once
+ */
+template <typename F>
+void bench(const char* name, F&& function, size_t maxIterations = SIZE_MAX, size_t operations = 1) {
+    using Clock = std::chrono::steady_clock;
+    if (filter != nullptr && std::strstr(name, filter) == nullptr) return;
+    auto round = [&](size_t iterations) {
+        const Clock::time_point start = Clock::now();
+        for (size_t i = 0; i < iterations; i++) function();
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    };
+
+    size_t iterations = 1;
+    while (iterations < maxIterations && round(iterations) < 2e7) iterations = std::min(iterations * 2, maxIterations);
+    double best = INFINITY;
+    size_t startAllocations = 0;
+    size_t startBytes = 0;
+    for (int i = 0; i < 5; i++) {
+        startAllocations = allocations;
+        startBytes = allocatedBytes;
+        best = std::min(best, round(iterations));
+    }
+    const double calls = double(iterations) * operations;
+    std::printf("%-40s %12.1f %12.2f %12.1f\n", name, best / calls, double(allocations - startAllocations) / calls,
+                double(allocatedBytes - startBytes) / calls);
+}
+
+/**
+ * @brief Make a path in the format LemLib reads, along a sine wave
+ *
+ * @param points number of points on the path
+ * @return std::string the path file
+ */
+std::string makePath(int points) {
+    std::string path;
+    char line[64];
+    for (int i = 0; i < points; i++) {
+        // 0.5" spacing, like path.jerryio's default point density
+        const float y = i * 0.5;
+        const float velocity = i == points - 1 ? 0 : 100 - 50.0f * i / points;
+        std::snprintf(line, sizeof(line), "%.3f, %.3f, %.3f\n", 12 * std::sin(y / 24), y, velocity);
+        path += line;
+    }
+    return path + "endData\n";
+}
+
+/**
+ * @brief Sink that formats messages the same way the info sink does, but doesn't send them anywhere
+ *
+ */
+class NullSink : public lemlib::BaseSink {
+    public:
+        NullSink(lemlib::Level lowestLevel) {
+            setFormat("[LemLib] {level}: {message}");
+            setLowestLevel(lowestLevel);
+        }
+    protected:
+        void sendMessage(const lemlib::Message&) override {}
+};
+
+void benchOdometry() {
+    // the drivetrain and sensors of the example project: IMEs, a horizontal rotation sensor and an IMU
+    static pros::MotorGroup left({-1, -2, -3});
+    static pros::MotorGroup right({4, 5, 6});
+    static pros::Rotation rotation(7, true);
+    static pros::Imu imu(8);
+    static lemlib::TrackingWheel leftWheel(&left, lemlib::Omniwheel::NEW_325, -5, 450);
+    static lemlib::TrackingWheel rightWheel(&right, lemlib::Omniwheel::NEW_325, 5, 450);
+    static lemlib::TrackingWheel horizontal(&rotation, lemlib::Omniwheel::NEW_325, -3.7);
+    left.set_gearing(pros::E_MOTOR_GEARSET_06);
+    right.set_gearing(pros::E_MOTOR_GEARSET_06);
+    lemlib::Drivetrain drivetrain(&left, &right, 10, lemlib::Omniwheel::NEW_325, 450, 2);
+    lemlib::setSensors(lemlib::OdomSensors(&leftWheel, &rightWheel, &horizontal, nullptr, &imu), drivetrain);
+
+    // move the sensors a little on every call, so odometry always has something to integrate
+    auto move = [] {
+        for (uint8_t port = 1; port <= 6; port++) host::motor(port).position += 0.5;
+        host::rotation(7).position += 3;
+        host::imu(8).rotation += 0.01;
+    };
+    bench("sensors moving (baseline)", move);
+    bench("lemlib::update", [&] {
+        move();
+        lemlib::update();
+    });
+    bench("TrackingWheel (rotation)", [&] {
+        move();
+        keep(horizontal.getDistanceTraveled());
+    });
+    bench("TrackingWheel (3 motor IMEs)", [&] {
+        move();
+        keep(leftWheel.getDistanceTraveled());
+    });
+    bench("lemlib::getPose", [] { keep(lemlib::getPose(true)); });
+}
+
+void benchPaths() {
+    for (int points : {30, 150, 600}) {
+        const std::string text = makePath(points);
+        const asset path = {reinterpret_cast<uint8_t*>(const_cast<char*>(text.data())), text.size()};
+        const std::vector<lemlib::Pose> data = getData(path);
+        // the robot is halfway along the path, and the last lookahead point was just ahead of it
+        const lemlib::Pose pose(data[points / 2].x + 1, data[points / 2].y, 0);
+        const lemlib::Pose lastLookahead(data[points / 2 + 2].x, data[points / 2 + 2].y, points / 2 + 2);
+        const std::string suffix = " (" + std::to_string(points) + " points)";
+        bench(("getData" + suffix).c_str(), [&] { keep(getData(path)); });
+        bench(("findClosest" + suffix).c_str(), [&] { keep(findClosest(pose, data)); });
+        bench(("lookaheadPoint" + suffix).c_str(), [&] { keep(lookaheadPoint(lastLookahead, pose, data, 10)); });
+    }
+}
+
+void benchControllers() {
+    lemlib::PID lateral(10, 0, 3, 3);
+    lemlib::ExitCondition smallExit(1, 100);
+    float error = 24;
+    bench("PID::update", [&] {
+        error = error > 0.1 ? error * 0.99f : 24;
+        keep(lateral.update(error));
+    });
+    bench("ExitCondition::update", [&] {
+        error = error > 0.1 ? error * 0.99f : 24;
+        keep(smallExit.update(error));
+    });
+}
+
+void benchMotions() {
+    // a drivetrain like the example project's, on its own ports, with the simulator stepped by hand
+    static pros::MotorGroup left({-11, -12, -13});
+    static pros::MotorGroup right({14, 15, 16});
+    static pros::Imu imu(17);
+    left.set_gearing(pros::E_MOTOR_GEARSET_06);
+    right.set_gearing(pros::E_MOTOR_GEARSET_06);
+    static host::DrivetrainSimulator simulator(left, right);
+    simulator.addImu(17);
+    const lemlib::Drivetrain drivetrain(&left, &right, 10, lemlib::Omniwheel::NEW_325, 450, 2);
+    static lemlib::TrackingWheel leftWheel(&left, lemlib::Omniwheel::NEW_325, -5, 450);
+    static lemlib::TrackingWheel rightWheel(&right, lemlib::Omniwheel::NEW_325, 5, 450);
+    const lemlib::OdomSensors sensors(&leftWheel, &rightWheel, nullptr, nullptr, &imu);
+    static lemlib::Chassis chassis(drivetrain, {10, 0, 3, 3, 1, 100, 3, 500, 20}, {2, 0, 10, 3, 1, 100, 3, 500, 0},
+                                   sensors);
+    lemlib::setSensors(sensors, drivetrain);
+
+    // the kernel never runs here, so time only moves when a motion waits on the simulated clock, which steps the robot
+    // and odometry like the tick handlers and the odometry task would
+    static lemlib::SimulatedClock clock;
+    clock.onStep([](uint32_t time) {
+        simulator.step(0.001);
+        if (time % 10 == 0) lemlib::update();
+    });
+    lemlib::Clock& previous = lemlib::getClock();
+    lemlib::setClock(clock);
+    bench("moveToPoint 24in (simulated)", [] {
+        simulator.setPose(lemlib::Pose(0, 0, 0));
+        chassis.setPose(0, 0, 0);
+        chassis.moveToPoint(0, 24, 2000);
+    });
+
+    // the robot stays still, far from the target, so the motion runs every iteration of its loop until it times out.
+    // Time moves a whole tick per step, and nothing else runs, so what is left is the cost of one iteration, with the
+    // start and end of the motion spread over its 100 iterations
+    static lemlib::SimulatedClock tickClock(10000);
+    lemlib::setClock(tickClock);
+    bench("moveToPoint tick", [] {
+        chassis.setPose(0, 0, 0);
+        chassis.moveToPoint(10, 240, 1000);
+    }, SIZE_MAX, 100);
+    lemlib::setClock(previous);
+}
+
+void benchLogger() {
+    static NullSink sink(lemlib::Level::INFO);
+    static NullSink quietSink(lemlib::Level::FATAL);
+    const float x = 12.345, y = -6.789, theta = 90.125;
+    bench("BaseSink::log (3 floats)", [&] { sink.info("x: {}, y: {}, theta: {}", x, y, theta); });
+    bench("BaseSink::log (string)", [&] { sink.info("motion started"); });
+    bench("BaseSink::log (filtered)", [&] { quietSink.info("x: {}, y: {}, theta: {}", x, y, theta); });
+    // the macro checks the level before the pose is fetched
+    bench("LEMLIB_DEBUG (filtered)", [&] { LEMLIB_DEBUG(&quietSink, "pose: {}", lemlib::getPose()); });
+    // the buffer's task never runs here, so the queue fills up and then every push overwrites the oldest message, which
+    // costs the same as a push to a buffer that is being drained. It is never destroyed, as its destructor would need
+    // the kernel to remove its task
+    static lemlib::Buffer* buffer =
+        new lemlib::Buffer([](const std::string&) {}, 256, lemlib::OverflowPolicy::DROP_OLDEST);
+    const std::string message = "[LemLib] INFO: x: 12.345, y: -6.789, theta: 90.125";
+    bench("Buffer::pushToBuffer", [&] { buffer->pushToBuffer(message); }, 100000);
+    // deferred messages are queued in the stdout buffer, which never drains here either
+    static NullSink deferredSink(lemlib::Level::INFO);
+    deferredSink.setDeferred(true);
+    lemlib::bufferedStdout().setOverflowPolicy(lemlib::OverflowPolicy::DROP_OLDEST);
+    const lemlib::Pose pose(x, y, theta);
+    bench("BaseSink::log (deferred 3 floats)", [&] { deferredSink.info("x: {}, y: {}, theta: {}", x, y, theta); },
+          100000);
+    bench("BaseSink::log (deferred pose)", [&] { deferredSink.info("pose: {}", pose); }, 100000);
+}
+} // namespace
+
+/**
+ * @brief Microbenchmarks for LemLib's hot paths
+ *
+ * Run with a substring of a benchmark name to only run matching benchmarks.
+ */
+int main(int argc, char** argv) {
+    if (argc > 1) filter = argv[1];
+    std::printf("%-40s %12s %12s %12s\n", "benchmark", "ns/op", "allocs/op", "bytes/op");
+    benchOdometry();
+    benchPaths();
+    benchControllers();
+    benchMotions();
+    benchLogger();
+    return 0;
+}
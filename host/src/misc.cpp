@@ -0,0 +1,232 @@
+#include <cerrno>
+#include <cstdarg>
+#include <cstdio>
+#include "pros/error.h"
+#include "pros/misc.hpp"
+#include "pros/llemu.hpp"
+#include "host/devices.hpp"
+
+namespace {
+/**
+ * @brief Get the state of a controller, setting errno if it isn't connected
+ *
+ * @return host::ControllerState* the state, or nullptr if the controller isn't connected
+ */
+host::ControllerState* getState(pros::controller_id_e_t id) {
+    if (id != pros::E_CONTROLLER_MASTER && id != pros::E_CONTROLLER_PARTNER) {
+        errno = EINVAL;
+        return nullptr;
+    }
+    host::ControllerState& state = host::controller(id);
+    if (!state.connected) {
+        errno = EACCES;
+        return nullptr;
+    }
+    return &state;
+}
+
+bool lcdInitialized = false;
+} // namespace
+
+namespace pros::c {
+uint8_t competition_get_status(void) { return host::getCompetitionStatus(); }
+
+int32_t controller_is_connected(controller_id_e_t id) { return host::controller(id).connected; }
+
+int32_t controller_get_analog(controller_id_e_t id, controller_analog_e_t channel) {
+    host::ControllerState* state = getState(id);
+    if (state == nullptr || channel < 0 || channel > 3) return 0;
+    return state->analog[channel];
+}
+
+int32_t controller_get_battery_capacity(controller_id_e_t id) { return getState(id) == nullptr ? PROS_ERR : 100; }
+
+int32_t controller_get_battery_level(controller_id_e_t id) { return getState(id) == nullptr ? PROS_ERR : 100; }
+
+int32_t controller_get_digital(controller_id_e_t id, controller_digital_e_t button) {
+    host::ControllerState* state = getState(id);
+    if (state == nullptr || button < E_CONTROLLER_DIGITAL_L1 || button > E_CONTROLLER_DIGITAL_A) return 0;
+    return state->digital[button];
+}
+
+int32_t controller_get_digital_new_press(controller_id_e_t id, controller_digital_e_t button) {
+    host::ControllerState* state = getState(id);
+    if (state == nullptr || button < E_CONTROLLER_DIGITAL_L1 || button > E_CONTROLLER_DIGITAL_A) return 0;
+    const bool newPress = state->digital[button] && !state->pressed[button];
+    state->pressed[button] = state->digital[button];
+    return newPress;
+}
+
+int32_t controller_set_text(controller_id_e_t id, uint8_t line, uint8_t col, const char* str) {
+    host::ControllerState* state = getState(id);
+    if (state == nullptr || line > 2) return PROS_ERR;
+    std::string& text = state->text[line];
+    if (text.size() < col) text.resize(col, ' ');
+    text.replace(col, std::string::npos, str);
+    return 1;
+}
+
+int32_t controller_print(controller_id_e_t id, uint8_t line, uint8_t col, const char* fmt, ...) {
+    char buffer[32];
+    va_list args;
+    va_start(args, fmt);
+    std::vsnprintf(buffer, sizeof(buffer), fmt, args);
+    va_end(args);
+    return controller_set_text(id, line, col, buffer);
+}
+
+int32_t controller_clear_line(controller_id_e_t id, uint8_t line) {
+    host::ControllerState* state = getState(id);
+    if (state == nullptr || line > 2) return PROS_ERR;
+    state->text[line].clear();
+    return 1;
+}
+
+int32_t controller_clear(controller_id_e_t id) {
+    host::ControllerState* state = getState(id);
+    if (state == nullptr) return PROS_ERR;
+    for (std::string& text : state->text) text.clear();
+    return 1;
+}
+
+int32_t controller_rumble(controller_id_e_t id, const char* rumble_pattern) {
+    host::ControllerState* state = getState(id);
+    if (state == nullptr) return PROS_ERR;
+    state->rumble = rumble_pattern;
+    return 1;
+}
+
+int32_t battery_get_voltage(void) { return host::getBatteryVoltage(); }
+
+int32_t battery_get_current(void) { return 0; }
+
+double battery_get_temperature(void) { return 25; }
+
+double battery_get_capacity(void) { return 100; }
+
+int32_t usd_is_installed(void) { return 0; }
+
+bool lcd_is_initialized(void) { return lcdInitialized; }
+
+bool lcd_initialize(void) {
+    lcdInitialized = true;
+    return true;
+}
+
+bool lcd_shutdown(void) {
+    lcdInitialized = false;
+    return true;
+}
+
+bool lcd_set_text(int16_t line, const char* text) {
+    if (!lcdInitialized || line < 0 || line > 7) {
+        errno = lcdInitialized ? EINVAL : ENXIO;
+        return false;
+    }
+    host::lcdLine(line) = text;
+    return true;
+}
+
+bool lcd_print(int16_t line, const char* fmt, ...) {
+    char buffer[64];
+    va_list args;
+    va_start(args, fmt);
+    std::vsnprintf(buffer, sizeof(buffer), fmt, args);
+    va_end(args);
+    return lcd_set_text(line, buffer);
+}
+
+bool lcd_clear_line(int16_t line) { return lcd_set_text(line, ""); }
+
+bool lcd_clear(void) {
+    for (int16_t line = 0; line < 8; line++) lcd_clear_line(line);
+    return lcdInitialized;
+}
+
+bool lcd_register_btn0_cb(lcd_btn_cb_fn_t cb) { return lcdInitialized; }
+
+bool lcd_register_btn1_cb(lcd_btn_cb_fn_t cb) { return lcdInitialized; }
+
+bool lcd_register_btn2_cb(lcd_btn_cb_fn_t cb) { return lcdInitialized; }
+
+uint8_t lcd_read_buttons(void) { return 0; }
+} // namespace pros::c
+
+namespace pros {
+Controller::Controller(controller_id_e_t id)
+    : _id(id) {}
+
+std::int32_t Controller::is_connected(void) { return c::controller_is_connected(_id); }
+
+std::int32_t Controller::get_analog(controller_analog_e_t channel) { return c::controller_get_analog(_id, channel); }
+
+std::int32_t Controller::get_battery_capacity(void) { return c::controller_get_battery_capacity(_id); }
+
+std::int32_t Controller::get_battery_level(void) { return c::controller_get_battery_level(_id); }
+
+std::int32_t Controller::get_digital(controller_digital_e_t button) { return c::controller_get_digital(_id, button); }
+
+std::int32_t Controller::get_digital_new_press(controller_digital_e_t button) {
+    return c::controller_get_digital_new_press(_id, button);
+}
+
+std::int32_t Controller::set_text(std::uint8_t line, std::uint8_t col, const char* str) {
+    return c::controller_set_text(_id, line, col, str);
+}
+
+std::int32_t Controller::set_text(std::uint8_t line, std::uint8_t col, const std::string& str) {
+    return c::controller_set_text(_id, line, col, str.c_str());
+}
+
+std::int32_t Controller::clear_line(std::uint8_t line) { return c::controller_clear_line(_id, line); }
+
+std::int32_t Controller::rumble(const char* rumble_pattern) { return c::controller_rumble(_id, rumble_pattern); }
+
+std::int32_t Controller::clear(void) { return c::controller_clear(_id); }
+
+namespace battery {
+double get_capacity(void) { return c::battery_get_capacity(); }
+
+int32_t get_current(void) { return c::battery_get_current(); }
+
+double get_temperature(void) { return c::battery_get_temperature(); }
+
+int32_t get_voltage(void) { return c::battery_get_voltage(); }
+} // namespace battery
+
+namespace competition {
+std::uint8_t get_status(void) { return c::competition_get_status(); }
+
+std::uint8_t is_autonomous(void) { return (get_status() & COMPETITION_AUTONOMOUS) != 0; }
+
+std::uint8_t is_connected(void) { return (get_status() & COMPETITION_CONNECTED) != 0; }
+
+std::uint8_t is_disabled(void) { return (get_status() & COMPETITION_DISABLED) != 0; }
+} // namespace competition
+
+namespace usd {
+std::int32_t is_installed(void) { return c::usd_is_installed(); }
+} // namespace usd
+
+namespace lcd {
+bool is_initialized(void) { return c::lcd_is_initialized(); }
+
+bool initialize(void) { return c::lcd_initialize(); }
+
+bool shutdown(void) { return c::lcd_shutdown(); }
+
+bool set_text(std::int16_t line, std::string text) { return c::lcd_set_text(line, text.c_str()); }
+
+bool clear(void) { return c::lcd_clear(); }
+
+bool clear_line(std::int16_t line) { return c::lcd_clear_line(line); }
+
+void register_btn0_cb(lcd_btn_cb_fn_t cb) { c::lcd_register_btn0_cb(cb); }
+
+void register_btn1_cb(lcd_btn_cb_fn_t cb) { c::lcd_register_btn1_cb(cb); }
+
+void register_btn2_cb(lcd_btn_cb_fn_t cb) { c::lcd_register_btn2_cb(cb); }
+
+std::uint8_t read_buttons(void) { return c::lcd_read_buttons(); }
+} // namespace lcd
+} // namespace pros
@@ -0,0 +1,481 @@
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+#include "pros/error.h"
+#include "pros/motors.hpp"
+#include "host/devices.hpp"
+#include "host/kernel.hpp"
+
+using host::MotorCommand;
+using host::MotorState;
+
+namespace {
+/**
+ * @brief Get the state of a motor, setting errno like the firmware if it can't be used
+ *
+ * @param port the smart port
+ * @return MotorState* the state, or nullptr if the port is invalid or the motor is unplugged
+ */
+MotorState* getState(uint8_t port) {
+    if (port < 1 || port > 21) {
+        errno = ENXIO;
+        return nullptr;
+    }
+    MotorState& state = host::motor(port);
+    if (!state.connected) {
+        errno = ENODEV;
+        return nullptr;
+    }
+    return &state;
+}
+
+double sign(const MotorState& state) { return state.reversed ? -1 : 1; }
+
+/**
+ * @brief Get how many encoder units there are in a degree
+ *
+ */
+double unitsPerDegree(const MotorState& state) {
+    switch (state.units) {
+        case pros::E_MOTOR_ENCODER_ROTATIONS: return 1.0 / 360;
+        case pros::E_MOTOR_ENCODER_COUNTS:
+            // the encoder counts 50 ticks per revolution of the motor, before the cartridge
+            return 50 * 3600 / host::freeSpeed(state.gearset) / 360;
+        default: return 1;
+    }
+}
+
+/**
+ * @brief Get the position of a motor after reversal and taring
+ *
+ * @return double position in degrees
+ */
+double logicalPosition(const MotorState& state) { return sign(state) * state.position - state.zero; }
+} // namespace
+
+namespace pros {
+Motor::Motor(const std::int8_t port, const motor_gearset_e_t gearset, const bool reverse,
+             const motor_encoder_units_e_t encoder_units)
+    : _port(std::abs(port)) {
+    set_gearing(gearset);
+    set_reversed(port < 0 ? !reverse : reverse);
+    set_encoder_units(encoder_units);
+}
+
+Motor::Motor(const std::int8_t port, const motor_gearset_e_t gearset, const bool reverse)
+    : _port(std::abs(port)) {
+    set_gearing(gearset);
+    set_reversed(port < 0 ? !reverse : reverse);
+}
+
+Motor::Motor(const std::int8_t port, const motor_gearset_e_t gearset)
+    : _port(std::abs(port)) {
+    set_gearing(gearset);
+    if (port < 0) set_reversed(true);
+}
+
+Motor::Motor(const std::int8_t port, const bool reverse)
+    : _port(std::abs(port)) {
+    set_reversed(port < 0 ? !reverse : reverse);
+}
+
+Motor::Motor(const std::int8_t port)
+    : _port(std::abs(port)) {
+    if (port < 0) set_reversed(true);
+}
+
+std::int32_t Motor::operator=(std::int32_t voltage) const { return move(voltage); }
+
+std::int32_t Motor::move(std::int32_t voltage) const {
+    if (voltage > 127) voltage = 127;
+    if (voltage < -127) voltage = -127;
+    return move_voltage(voltage * 12000 / 127);
+}
+
+std::int32_t Motor::move_absolute(const double position, const std::int32_t velocity) const {
+    MotorState* state = getState(_port);
+    if (state == nullptr) return PROS_ERR;
+    state->command = MotorCommand::POSITION;
+    state->targetPosition = sign(*state) * (position / unitsPerDegree(*state) + state->zero);
+    state->targetVelocity = std::abs(velocity);
+    return 1;
+}
+
+std::int32_t Motor::move_relative(const double position, const std::int32_t velocity) const {
+    MotorState* state = getState(_port);
+    if (state == nullptr) return PROS_ERR;
+    state->command = MotorCommand::POSITION;
+    state->targetPosition = state->position + sign(*state) * position / unitsPerDegree(*state);
+    state->targetVelocity = std::abs(velocity);
+    return 1;
+}
+
+std::int32_t Motor::move_velocity(const std::int32_t velocity) const {
+    MotorState* state = getState(_port);
+    if (state == nullptr) return PROS_ERR;
+    state->command = velocity == 0 && state->brakeMode != E_MOTOR_BRAKE_COAST ? MotorCommand::BRAKE
+                                                                              : MotorCommand::VELOCITY;
+    state->targetVelocity = sign(*state) * velocity;
+    return 1;
+}
+
+std::int32_t Motor::move_voltage(const std::int32_t voltage) const {
+    MotorState* state = getState(_port);
+    if (state == nullptr) return PROS_ERR;
+    state->command = voltage == 0 && state->brakeMode != E_MOTOR_BRAKE_COAST ? MotorCommand::BRAKE
+                                                                             : MotorCommand::VOLTAGE;
+    state->voltage = sign(*state) * std::max(-12000, std::min(12000, voltage));
+    return 1;
+}
+
+std::int32_t Motor::brake(void) const { return move_velocity(0); }
+
+std::int32_t Motor::modify_profiled_velocity(const std::int32_t velocity) const {
+    MotorState* state = getState(_port);
+    if (state == nullptr) return PROS_ERR;
+    state->targetVelocity = state->command == MotorCommand::POSITION ? std::abs(velocity) : sign(*state) * velocity;
+    return 1;
+}
+
+double Motor::get_target_position(void) const {
+    MotorState* state = getState(_port);
+    if (state == nullptr) return PROS_ERR_F;
+    return (sign(*state) * state->targetPosition - state->zero) * unitsPerDegree(*state);
+}
+
+std::int32_t Motor::get_target_velocity(void) const {
+    MotorState* state = getState(_port);
+    if (state == nullptr) return PROS_ERR;
+    return sign(*state) * state->targetVelocity;
+}
+
+double Motor::get_actual_velocity(void) const {
+    MotorState* state = getState(_port);
+    if (state == nullptr) return PROS_ERR_F;
+    return sign(*state) * state->velocity;
+}
+
+std::int32_t Motor::get_current_draw(void) const {
+    MotorState* state = getState(_port);
+    if (state == nullptr) return PROS_ERR;
+    return state->current;
+}
+
+std::int32_t Motor::get_direction(void) const {
+    MotorState* state = getState(_port);
+    if (state == nullptr) return PROS_ERR;
+    return sign(*state) * state->velocity < 0 ? -1 : 1;
+}
+
+double Motor::get_efficiency(void) const {
+    MotorState* state = getState(_port);
+    if (state == nullptr) return PROS_ERR_F;
+    return std::abs(state->velocity) / host::freeSpeed(state->gearset) * 100;
+}
+
+std::int32_t Motor::is_over_current(void) const {
+    MotorState* state = getState(_port);
+    if (state == nullptr) return PROS_ERR;
+    return state->current >= state->currentLimit;
+}
+
+std::int32_t Motor::is_stopped(void) const {
+    MotorState* state = getState(_port);
+    if (state == nullptr) return PROS_ERR;
+    return state->velocity == 0;
+}
+
+std::int32_t Motor::get_zero_position_flag(void) const {
+    MotorState* state = getState(_port);
+    if (state == nullptr) return PROS_ERR;
+    return logicalPosition(*state) == 0;
+}
+
+std::uint32_t Motor::get_faults(void) const {
+    MotorState* state = getState(_port);
+    if (state == nullptr) return PROS_ERR;
+    return 0;
+}
+
+std::uint32_t Motor::get_flags(void) const {
+    MotorState* state = getState(_port);
+    if (state == nullptr) return PROS_ERR;
+    return 0;
+}
+
+std::int32_t Motor::get_raw_position(std::uint32_t* const timestamp) const {
+    MotorState* state = getState(_port);
+    if (state == nullptr) return PROS_ERR;
+    if (timestamp != nullptr) *timestamp = host::millis();
+    return sign(*state) * state->position * 50 * 3600 / host::freeSpeed(state->gearset) / 360;
+}
+
+std::int32_t Motor::is_over_temp(void) const {
+    MotorState* state = getState(_port);
+    if (state == nullptr) return PROS_ERR;
+    return state->temperature >= 55;
+}
+
+double Motor::get_position(void) const {
+    MotorState* state = getState(_port);
+    if (state == nullptr) return PROS_ERR_F;
+    return logicalPosition(*state) * unitsPerDegree(*state);
+}
+
+double Motor::get_power(void) const {
+    MotorState* state = getState(_port);
+    if (state == nullptr) return PROS_ERR_F;
+    return std::abs(state->appliedVoltage / 1000.0 * state->current / 1000.0);
+}
+
+double Motor::get_temperature(void) const {
+    MotorState* state = getState(_port);
+    if (state == nullptr) return PROS_ERR_F;
+    return state->temperature;
+}
+
+double Motor::get_torque(void) const {
+    MotorState* state = getState(_port);
+    if (state == nullptr) return PROS_ERR_F;
+    return sign(*state) * state->torque;
+}
+
+std::int32_t Motor::get_voltage(void) const {
+    MotorState* state = getState(_port);
+    if (state == nullptr) return PROS_ERR;
+    return sign(*state) * state->appliedVoltage;
+}
+
+std::int32_t Motor::set_zero_position(const double position) const {
+    MotorState* state = getState(_port);
+    if (state == nullptr) return PROS_ERR;
+    state->zero = sign(*state) * state->position - position / unitsPerDegree(*state);
+    return 1;
+}
+
+std::int32_t Motor::tare_position(void) const { return set_zero_position(0); }
+
+std::int32_t Motor::set_brake_mode(const motor_brake_mode_e_t mode) const {
+    MotorState* state = getState(_port);
+    if (state == nullptr) return PROS_ERR;
+    state->brakeMode = mode;
+    return 1;
+}
+
+std::int32_t Motor::set_current_limit(const std::int32_t limit) const {
+    MotorState* state = getState(_port);
+    if (state == nullptr) return PROS_ERR;
+    state->currentLimit = limit;
+    return 1;
+}
+
+std::int32_t Motor::set_encoder_units(const motor_encoder_units_e_t units) const {
+    MotorState* state = getState(_port);
+    if (state == nullptr) return PROS_ERR;
+    state->units = units;
+    return 1;
+}
+
+std::int32_t Motor::set_gearing(const motor_gearset_e_t gearset) const {
+    MotorState* state = getState(_port);
+    if (state == nullptr) return PROS_ERR;
+    state->gearset = gearset;
+    return 1;
+}
+
+motor_pid_s_t Motor::convert_pid(double kf, double kp, double ki, double kd) { return {}; }
+
+motor_pid_full_s_t Motor::convert_pid_full(double kf, double kp, double ki, double kd, double filter, double limit,
+                                           double threshold, double loopspeed) {
+    return {};
+}
+
+std::int32_t Motor::set_pos_pid(const motor_pid_s_t pid) const { return 1; }
+
+std::int32_t Motor::set_pos_pid_full(const motor_pid_full_s_t pid) const { return 1; }
+
+std::int32_t Motor::set_vel_pid(const motor_pid_s_t pid) const { return 1; }
+
+std::int32_t Motor::set_vel_pid_full(const motor_pid_full_s_t pid) const { return 1; }
+
+std::int32_t Motor::set_reversed(const bool reverse) const {
+    MotorState* state = getState(_port);
+    if (state == nullptr) return PROS_ERR;
+    state->reversed = reverse;
+    return 1;
+}
+
+std::int32_t Motor::set_voltage_limit(const std::int32_t limit) const {
+    MotorState* state = getState(_port);
+    if (state == nullptr) return PROS_ERR;
+    state->voltageLimit = limit;
+    return 1;
+}
+
+motor_brake_mode_e_t Motor::get_brake_mode(void) const {
+    MotorState* state = getState(_port);
+    if (state == nullptr) return E_MOTOR_BRAKE_INVALID;
+    return state->brakeMode;
+}
+
+std::int32_t Motor::get_current_limit(void) const {
+    MotorState* state = getState(_port);
+    if (state == nullptr) return PROS_ERR;
+    return state->currentLimit;
+}
+
+motor_encoder_units_e_t Motor::get_encoder_units(void) const {
+    MotorState* state = getState(_port);
+    if (state == nullptr) return E_MOTOR_ENCODER_INVALID;
+    return state->units;
+}
+
+motor_gearset_e_t Motor::get_gearing(void) const {
+    MotorState* state = getState(_port);
+    if (state == nullptr) return E_MOTOR_GEARSET_INVALID;
+    return state->gearset;
+}
+
+motor_pid_full_s_t Motor::get_pos_pid(void) const { return {}; }
+
+motor_pid_full_s_t Motor::get_vel_pid(void) const { return {}; }
+
+std::int32_t Motor::is_reversed(void) const {
+    MotorState* state = getState(_port);
+    if (state == nullptr) return PROS_ERR;
+    return state->reversed;
+}
+
+std::int32_t Motor::get_voltage_limit(void) const {
+    MotorState* state = getState(_port);
+    if (state == nullptr) return PROS_ERR;
+    return state->voltageLimit;
+}
+
+std::uint8_t Motor::get_port(void) const { return _port; }
+
+Motor_Group::Motor_Group(const std::initializer_list<Motor> motors)
+    : _motors(motors),
+      _motor_count(motors.size()) {}
+
+Motor_Group::Motor_Group(const std::vector<pros::Motor>& motors)
+    : _motors(motors),
+      _motor_count(motors.size()) {}
+
+Motor_Group::Motor_Group(const std::initializer_list<std::int8_t> motor_ports)
+    : Motor_Group(std::vector<std::int8_t>(motor_ports)) {}
+
+Motor_Group::Motor_Group(const std::vector<std::int8_t> motor_ports)
+    : _motor_count(motor_ports.size()) {
+    for (std::int8_t port : motor_ports) _motors.emplace_back(port);
+}
+
+std::int32_t Motor_Group::operator=(std::int32_t voltage) { return move(voltage); }
+
+// runs a command on every motor in the group, failing if any motor fails
+#define FOR_EACH_MOTOR(call)                                                                                           \
+    std::int32_t result = 1;                                                                                           \
+    for (Motor& motor : _motors) {                                                                                     \
+        if (motor.call == PROS_ERR) result = PROS_ERR;                                                                 \
+    }                                                                                                                  \
+    return result;
+
+// collects a value from every motor in the group
+#define COLLECT(type, call)                                                                                            \
+    std::vector<type> values;                                                                                          \
+    for (Motor& motor : _motors) values.push_back(motor.call);                                                         \
+    return values;
+
+std::int32_t Motor_Group::move(std::int32_t voltage) { FOR_EACH_MOTOR(move(voltage)) }
+
+std::int32_t Motor_Group::move_absolute(const double position, const std::int32_t velocity) {
+    FOR_EACH_MOTOR(move_absolute(position, velocity))
+}
+
+std::int32_t Motor_Group::move_relative(const double position, const std::int32_t velocity) {
+    FOR_EACH_MOTOR(move_relative(position, velocity))
+}
+
+std::int32_t Motor_Group::move_velocity(const std::int32_t velocity) { FOR_EACH_MOTOR(move_velocity(velocity)) }
+
+std::int32_t Motor_Group::move_voltage(const std::int32_t voltage) { FOR_EACH_MOTOR(move_voltage(voltage)) }
+
+std::int32_t Motor_Group::brake(void) { FOR_EACH_MOTOR(brake()) }
+
+std::vector<std::uint32_t> Motor_Group::get_voltages(void) { COLLECT(std::uint32_t, get_voltage()) }
+
+std::vector<std::uint32_t> Motor_Group::get_voltage_limits(void) { COLLECT(std::uint32_t, get_voltage_limit()) }
+
+std::vector<std::int32_t> Motor_Group::get_raw_positions(std::vector<std::uint32_t*>& timestamps) {
+    std::vector<std::int32_t> values;
+    for (size_t i = 0; i < _motors.size(); i++)
+        values.push_back(_motors[i].get_raw_position(i < timestamps.size() ? timestamps[i] : nullptr));
+    return values;
+}
+
+pros::Motor& Motor_Group::operator[](int i) { return _motors[i]; }
+
+pros::Motor& Motor_Group::at(int i) {
+    if (i < 0 || i >= int(_motors.size())) throw std::out_of_range("Motor_Group index out of range");
+    return _motors[i];
+}
+
+std::int32_t Motor_Group::size() { return _motor_count; }
+
+std::int32_t Motor_Group::set_zero_position(const double position) { FOR_EACH_MOTOR(set_zero_position(position)) }
+
+std::int32_t Motor_Group::set_brake_modes(motor_brake_mode_e_t mode) { FOR_EACH_MOTOR(set_brake_mode(mode)) }
+
+std::int32_t Motor_Group::set_reversed(const bool reversed) { FOR_EACH_MOTOR(set_reversed(reversed)) }
+
+std::int32_t Motor_Group::set_voltage_limit(const std::int32_t limit) { FOR_EACH_MOTOR(set_voltage_limit(limit)) }
+
+std::int32_t Motor_Group::set_gearing(const motor_gearset_e_t gearset) { FOR_EACH_MOTOR(set_gearing(gearset)) }
+
+std::int32_t Motor_Group::set_encoder_units(const motor_encoder_units_e_t units) {
+    FOR_EACH_MOTOR(set_encoder_units(units))
+}
+
+std::int32_t Motor_Group::tare_position(void) { FOR_EACH_MOTOR(tare_position()) }
+
+std::vector<double> Motor_Group::get_actual_velocities(void) { COLLECT(double, get_actual_velocity()) }
+
+std::vector<std::int32_t> Motor_Group::get_target_velocities(void) { COLLECT(std::int32_t, get_target_velocity()) }
+
+std::vector<double> Motor_Group::get_target_positions(void) { COLLECT(double, get_target_position()) }
+
+std::vector<double> Motor_Group::get_positions(void) { COLLECT(double, get_position()) }
+
+std::vector<double> Motor_Group::get_efficiencies(void) { COLLECT(double, get_efficiency()) }
+
+std::vector<std::int32_t> Motor_Group::are_over_current(void) { COLLECT(std::int32_t, is_over_current()) }
+
+std::vector<std::int32_t> Motor_Group::are_over_temp(void) { COLLECT(std::int32_t, is_over_temp()) }
+
+std::vector<pros::motor_brake_mode_e_t> Motor_Group::get_brake_modes(void) {
+    COLLECT(pros::motor_brake_mode_e_t, get_brake_mode())
+}
+
+std::vector<motor_gearset_e_t> Motor_Group::get_gearing(void) { COLLECT(motor_gearset_e_t, get_gearing()) }
+
+std::vector<std::int32_t> Motor_Group::get_current_draws(void) { COLLECT(std::int32_t, get_current_draw()) }
+
+std::vector<std::int32_t> Motor_Group::get_current_limits(void) { COLLECT(std::int32_t, get_current_limit()) }
+
+std::vector<std::uint8_t> Motor_Group::get_ports(void) { COLLECT(std::uint8_t, get_port()) }
+
+std::vector<std::int32_t> Motor_Group::get_directions(void) { COLLECT(std::int32_t, get_direction()) }
+
+std::vector<pros::motor_encoder_units_e_t> Motor_Group::get_encoder_units(void) {
+    COLLECT(pros::motor_encoder_units_e_t, get_encoder_units())
+}
+
+std::vector<double> Motor_Group::get_temperatures(void) { COLLECT(double, get_temperature()) }
+
+namespace literals {
+const pros::Motor operator"" _mtr(const unsigned long long int m) { return pros::Motor(m); }
+
+const pros::Motor operator"" _rmtr(const unsigned long long int m) { return pros::Motor(m, true); }
+} // namespace literals
+} // namespace pros
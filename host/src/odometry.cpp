@@ -0,0 +1,303 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <vector>
+#include "lemlib/api.hpp"
+#include "lemlib/chassis/odom.hpp"
+#include "host/devices.hpp"
+
+namespace {
+/**
+ * @brief A path the robot follows exactly, with no wheel slip
+ *
+ * The path is given by how far the robot has driven and which way it faces at every moment, so every sensor reading
+ * can be worked out exactly: a wheel at a sideways offset from the center travels the distance driven minus the
+ * offset times the heading. Only the position has to be integrated numerically.
+ */
+struct Trajectory {
+        const char* name;
+        /** how long the trajectory takes, in seconds */
+        double duration;
+        /** distance driven along the path at a time, in inches */
+        std::function<double(double)> distance;
+        /** heading at a time, in radians, clockwise from the y axis like LemLib */
+        std::function<double(double)> heading;
+};
+
+/**
+ * @brief Smooth progress from 0 to 1, starting and ending at rest
+ *
+ * @param u progress in time, from 0 to 1
+ */
+double ease(double u) { return u - std::sin(2 * M_PI * u) / (2 * M_PI); }
+
+const Trajectory trajectories[] = {
+    {"straight", 2, [](double t) { return 72 * ease(t / 2); }, [](double) { return 0.0; }},
+    {"arc", 2.5, [](double t) { return 24 * M_PI * ease(t / 2.5); }, [](double t) { return M_PI * ease(t / 2.5); }},
+    {"s-curve", 3, [](double t) { return 96 * ease(t / 3); },
+     [](double t) { return M_PI / 4 * std::sin(2 * M_PI * ease(t / 3)); }},
+    {"spin", 2, [](double) { return 0.0; }, [](double t) { return 4 * M_PI * ease(t / 2); }},
+    {"laps", 20, [](double t) { return 5 * 2 * M_PI * 30 * ease(t / 20); },
+     [](double t) { return 5 * 2 * M_PI * ease(t / 20); }},
+};
+
+/**
+ * @brief How the sensors are read
+ *
+ */
+struct Options {
+        /** time between odometry updates, in milliseconds */
+        double period = 10;
+        /** largest random shift of each update from its period, in milliseconds */
+        double jitter = 0;
+        /** how old inertial sensor readings are, in milliseconds */
+        double imuLatency = 0;
+        /** standard deviation of inertial sensor noise, in degrees */
+        double imuNoise = 0;
+        /** inertial sensor drift, in degrees per second */
+        double imuDrift = 0;
+        /** resolution of the rotation sensors, in centidegrees */
+        double rotationResolution = 1;
+        /** standard deviation of rotation sensor noise, in centidegrees */
+        double rotationNoise = 0;
+        /** how many times to run every trajectory, each with different noise */
+        int trials = 1;
+        uint32_t seed = 1;
+};
+
+/**
+ * @brief The sensors of a robot, and where they are
+ *
+ */
+struct Configuration {
+        const char* name;
+        lemlib::OdomSensors sensors;
+};
+
+/**
+ * @brief The drivetrain, sensors and every sensor configuration
+ *
+ * The drivetrain is the example project's: 3.25" wheels at 450 rpm on blue cartridges, on a 10" track.
+ */
+struct Robot {
+        Robot()
+            : drivetrain(&left, &right, 10, lemlib::Omniwheel::NEW_325, 450, 2) {
+            left.set_gearing(pros::E_MOTOR_GEARSET_06);
+            right.set_gearing(pros::E_MOTOR_GEARSET_06);
+        }
+
+        pros::MotorGroup left {1, 2, 3};
+        pros::MotorGroup right {4, 5, 6};
+        pros::Rotation verticalLeft {7};
+        pros::Rotation verticalRight {8};
+        pros::Rotation horizontalEncoder {9};
+        pros::Imu imu {10};
+        lemlib::Drivetrain drivetrain;
+        lemlib::TrackingWheel leftImes {&left, lemlib::Omniwheel::NEW_325, -5, 450};
+        lemlib::TrackingWheel rightImes {&right, lemlib::Omniwheel::NEW_325, 5, 450};
+        lemlib::TrackingWheel leftWheel {&verticalLeft, lemlib::Omniwheel::NEW_275, -2.5};
+        lemlib::TrackingWheel rightWheel {&verticalRight, lemlib::Omniwheel::NEW_275, 2.5};
+        lemlib::TrackingWheel horizontal {&horizontalEncoder, lemlib::Omniwheel::NEW_325, -3.7};
+
+        /** the wheels every sensor port reads, as a sideways offset and diameter */
+        struct Wheel {
+                uint8_t port;
+                double offset;
+                double diameter;
+        };
+
+        const Wheel motorWheels[2] = {{0, -5, lemlib::Omniwheel::NEW_325}, {1, 5, lemlib::Omniwheel::NEW_325}};
+        const Wheel rotationWheels[3] = {{7, -2.5, lemlib::Omniwheel::NEW_275},
+                                         {8, 2.5, lemlib::Omniwheel::NEW_275},
+                                         {9, -3.7, lemlib::Omniwheel::NEW_325}};
+
+        std::vector<Configuration> configurations() {
+            return {
+                // src/main.cpp: heading from the inertial sensor, forwards from the motor encoders
+                {"imes+imu", lemlib::OdomSensors(&leftImes, &rightImes, &horizontal, nullptr, &imu)},
+                // heading from the inertial sensor, forwards from a tracking wheel
+                {"wheel+imu", lemlib::OdomSensors(&leftWheel, &rightImes, &horizontal, nullptr, &imu)},
+                // heading from a pair of parallel tracking wheels
+                {"wheels", lemlib::OdomSensors(&leftWheel, &rightWheel, &horizontal, nullptr, nullptr)},
+            };
+        }
+};
+
+/**
+ * @brief How far odometry drifted on one run of a trajectory
+ *
+ */
+struct Drift {
+        /** distance driven, in inches */
+        double distance = 0;
+        /** total rotation, in radians */
+        double rotation = 0;
+        /** position error at the end, in inches */
+        double finalError = 0;
+        /** largest position error along the way, in inches */
+        double maxError = 0;
+        /** heading error at the end, in degrees */
+        double headingError = 0;
+};
+
+/**
+ * @brief Write what every sensor reads at a moment of a trajectory
+ *
+ * @param distance distance driven, in inches
+ * @param heading heading of the robot for the wheels, in radians
+ * @param imuHeading heading of the robot for the inertial sensor, in radians
+ */
+void writeSensors(Robot& robot, const Options& options, std::mt19937& rng, double time, double distance,
+                  double heading, double imuHeading) {
+    std::normal_distribution<double> gaussian(0, 1);
+    for (int side = 0; side < 2; side++) {
+        const Robot::Wheel& wheel = robot.motorWheels[side];
+        // the motors turn 600/450 times for every turn of the wheels. Blue cartridges count 300 ticks per turn
+        const double degrees = (distance - wheel.offset * heading) / (wheel.diameter * M_PI) * 360 * 600 / 450;
+        const double quantized = std::floor(degrees / 1.2) * 1.2;
+        for (uint8_t port = side * 3 + 1; port <= side * 3 + 3; port++) host::motor(port).position = quantized;
+    }
+    for (const Robot::Wheel& wheel : robot.rotationWheels) {
+        const bool sideways = wheel.port == 9;
+        const double travel = sideways ? -wheel.offset * heading : distance - wheel.offset * heading;
+        const double centidegrees =
+            travel / (wheel.diameter * M_PI) * 36000 + gaussian(rng) * options.rotationNoise;
+        host::rotation(wheel.port).position =
+            std::floor(centidegrees / options.rotationResolution) * options.rotationResolution;
+    }
+    host::imu(10).rotation =
+        imuHeading * 180 / M_PI + options.imuDrift * time + gaussian(rng) * options.imuNoise;
+}
+
+/**
+ * @brief Drive a trajectory, updating odometry like the odometry task does
+ *
+ */
+Drift run(Robot& robot, const Configuration& configuration, const Trajectory& trajectory, const Options& options,
+          uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> jitter(-options.jitter, options.jitter);
+
+    // start from rest at the origin, and let odometry catch up with the zeroed sensors before it starts counting
+    lemlib::setSensors(configuration.sensors, robot.drivetrain);
+    writeSensors(robot, options, rng, 0, 0, 0, 0);
+    lemlib::update();
+    lemlib::setPose(lemlib::Pose(0, 0, 0));
+
+    Drift drift;
+    double x = 0, y = 0;
+    double time = 0;
+    double lastDistance = 0, lastHeading = 0;
+    for (int tick = 1; time < trajectory.duration; tick++) {
+        const double next = std::min(tick * options.period / 1000 + jitter(rng) / 1000, trajectory.duration);
+        // the exact position, with the midpoint rule on steps much finer than an update
+        const int steps = std::max(1, int((next - time) / 1e-5));
+        for (int i = 0; i < steps; i++) {
+            const double mid = time + (next - time) * (i + 0.5) / steps;
+            const double ds = trajectory.distance(time + (next - time) * (i + 1) / steps) -
+                              trajectory.distance(time + (next - time) * i / steps);
+            x += ds * std::sin(trajectory.heading(mid));
+            y += ds * std::cos(trajectory.heading(mid));
+        }
+        time = next;
+
+        const double distance = trajectory.distance(time);
+        const double heading = trajectory.heading(time);
+        const double imuHeading = trajectory.heading(std::max(time - options.imuLatency / 1000, 0.0));
+        drift.distance += std::abs(distance - lastDistance);
+        drift.rotation += std::abs(heading - lastHeading);
+        lastDistance = distance;
+        lastHeading = heading;
+
+        writeSensors(robot, options, rng, time, distance, heading, imuHeading);
+        lemlib::update();
+        const lemlib::Pose pose = lemlib::getPose(true);
+        drift.maxError = std::max(drift.maxError, std::hypot(pose.x - x, pose.y - y));
+        drift.finalError = std::hypot(pose.x - x, pose.y - y);
+        drift.headingError = (pose.theta - heading) * 180 / M_PI;
+    }
+    return drift;
+}
+
+/**
+ * @brief Print how to use the program
+ *
+ */
+void usage(const char* name) {
+    std::printf("usage: %s [options]\n"
+                "  --period MS          time between odometry updates. 10 by default\n"
+                "  --jitter MS          largest random shift of each update. 0 by default\n"
+                "  --imu-latency MS     age of inertial sensor readings. 0 by default\n"
+                "  --imu-noise DEG      standard deviation of inertial sensor noise. 0 by default\n"
+                "  --imu-drift DEG/S    inertial sensor drift. 0 by default\n"
+                "  --rotation-res CDEG  resolution of the rotation sensors, in centidegrees. 1 by default\n"
+                "  --rotation-noise CDEG standard deviation of rotation sensor noise. 0 by default\n"
+                "  --trials N           runs of every trajectory, each with different noise. 1 by default\n"
+                "  --seed N             seed of the noise. 1 by default\n",
+                name);
+}
+} // namespace
+
+/**
+ * @brief Benchmark the accuracy of odometry against trajectories with known poses
+ *
+ * Every trajectory is driven with every sensor configuration, and the error between odometry and the true pose is
+ * reported per meter driven and per revolution turned. Motor encoders are always quantized to their real resolution.
+ */
+int main(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(arg, "--period") == 0 && hasValue) options.period = std::max(0.1, std::atof(argv[++i]));
+        else if (std::strcmp(arg, "--jitter") == 0 && hasValue) options.jitter = std::atof(argv[++i]);
+        else if (std::strcmp(arg, "--imu-latency") == 0 && hasValue) options.imuLatency = std::atof(argv[++i]);
+        else if (std::strcmp(arg, "--imu-noise") == 0 && hasValue) options.imuNoise = std::atof(argv[++i]);
+        else if (std::strcmp(arg, "--imu-drift") == 0 && hasValue) options.imuDrift = std::atof(argv[++i]);
+        else if (std::strcmp(arg, "--rotation-res") == 0 && hasValue) {
+            options.rotationResolution = std::max(0.01, std::atof(argv[++i]));
+        } else if (std::strcmp(arg, "--rotation-noise") == 0 && hasValue) options.rotationNoise = std::atof(argv[++i]);
+        else if (std::strcmp(arg, "--trials") == 0 && hasValue) options.trials = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(arg, "--seed") == 0 && hasValue) options.seed = std::strtoul(argv[++i], nullptr, 10);
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    // the odometry task is never started, so the only updates are the ones below
+    static Robot robot;
+
+    std::printf("%-10s %-9s %8s %7s %10s %10s %10s %10s %10s\n", "sensors", "path", "dist m", "revs", "final in",
+                "max in", "in/m", "head deg", "deg/rev");
+    for (const Configuration& configuration : robot.configurations()) {
+        for (const Trajectory& trajectory : trajectories) {
+            // errors are averaged over every trial, by magnitude
+            Drift mean;
+            for (int trial = 0; trial < options.trials; trial++) {
+                const Drift drift = run(robot, configuration, trajectory, options, options.seed + trial);
+                mean.distance = drift.distance;
+                mean.rotation = drift.rotation;
+                mean.finalError += drift.finalError / options.trials;
+                mean.maxError += drift.maxError / options.trials;
+                mean.headingError += std::abs(drift.headingError) / options.trials;
+            }
+            const double meters = mean.distance * 0.0254;
+            const double revolutions = mean.rotation / (2 * M_PI);
+            // drift is only meaningful for trajectories that actually drive or turn
+            char perMeter[16] = "-";
+            char perRevolution[16] = "-";
+            if (meters > 0.01) std::snprintf(perMeter, sizeof(perMeter), "%.3f", mean.finalError / meters);
+            if (revolutions > 0.01) {
+                std::snprintf(perRevolution, sizeof(perRevolution), "%.3f", mean.headingError / revolutions);
+            }
+            std::printf("%-10s %-9s %8.2f %7.2f %10.3f %10.3f %10s %10.3f %10s\n", configuration.name,
+                        trajectory.name, meters, revolutions, mean.finalError, mean.maxError, perMeter,
+                        mean.headingError, perRevolution);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,21 @@
+#include "main.h"
+#include "lemlib/api.hpp"
+#include "host/project.hpp"
+
+// the drivetrain declared in src/main.cpp
+extern pros::MotorGroup leftMotors;
+extern pros::MotorGroup rightMotors;
+
+namespace host {
+DrivetrainSimulator& projectSimulator() {
+    static DrivetrainSimulator* simulator = [] {
+        // the defaults of DrivetrainModel already describe this drivetrain
+        DrivetrainSimulator* simulator = new DrivetrainSimulator(leftMotors, rightMotors);
+        simulator->addImu(10);
+        simulator->addTrackingWheel(5, lemlib::Omniwheel::NEW_325, -3.7, true);
+        simulator->start();
+        return simulator;
+    }();
+    return *simulator;
+}
+} // namespace host
@@ -0,0 +1,80 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "main.h"
+#include "lemlib/api.hpp"
+#include "host/devices.hpp"
+#include "host/kernel.hpp"
+#include "host/project.hpp"
+
+// the chassis declared in src/main.cpp
+extern lemlib::Chassis chassis;
+
+/**
+ * @brief Print how to use the program
+ *
+ */
+static void usage(const char* name) {
+    std::printf("usage: %s [--auton | --opcontrol] [--realtime] [--time-limit MS]\n"
+                "  --auton       run initialize() then autonomous(). This is the default\n"
+                "  --opcontrol   run initialize() then opcontrol()\n"
+                "  --realtime    run at wall clock speed instead of as fast as possible\n"
+                "  --time-limit  stop the routine after MS milliseconds. 15000 for autonomous by default,\n"
+                "                and 105000 for opcontrol\n",
+                name);
+}
+
+/**
+ * @brief Describe why a run ended
+ *
+ */
+static const char* describe(host::RunResult result) {
+    switch (result) {
+        case host::RunResult::FINISHED: return "finished";
+        case host::RunResult::TIMEOUT: return "hit the time limit";
+        default: return "deadlocked";
+    }
+}
+
+/**
+ * @brief Run the project the way the brain does
+ *
+ * initialize() runs to completion first, then the selected routine runs with a time limit, like a match. The drivetrain
+ * is simulated, so the routine moves the robot like it would on the field.
+ */
+int main(int argc, char** argv) {
+    bool opcontrolMode = false;
+    uint32_t timeLimit = 0;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--auton") == 0) opcontrolMode = false;
+        else if (std::strcmp(argv[i], "--opcontrol") == 0) opcontrolMode = true;
+        else if (std::strcmp(argv[i], "--realtime") == 0) host::setTimeMode(host::TimeMode::REALTIME);
+        else if (std::strcmp(argv[i], "--time-limit") == 0 && i + 1 < argc) timeLimit = std::atoi(argv[++i]);
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (timeLimit == 0) timeLimit = opcontrolMode ? 105000 : 15000;
+
+    host::DrivetrainSimulator& simulator = host::projectSimulator();
+    host::RunResult result = host::run(initialize);
+    std::printf("[host] initialize %s at %ums\n", describe(result), host::millis());
+    if (result != host::RunResult::FINISHED) return 1;
+
+    const uint32_t start = host::millis();
+    if (opcontrolMode) {
+        host::setCompetitionStatus(COMPETITION_CONNECTED);
+        result = host::run(opcontrol, timeLimit);
+    } else {
+        host::setCompetitionStatus(COMPETITION_CONNECTED | COMPETITION_AUTONOMOUS);
+        result = host::run(autonomous, timeLimit);
+    }
+    std::printf("[host] %s %s after %ums\n", opcontrolMode ? "opcontrol" : "autonomous", describe(result),
+                host::millis() - start);
+    const lemlib::Pose truth = simulator.getPose();
+    const lemlib::Pose odom = chassis.getPose();
+    std::printf("[host] true pose (%.2f, %.2f, %.2f), odometry pose (%.2f, %.2f, %.2f)\n", truth.x, truth.y, truth.theta,
+                odom.x, odom.y, odom.theta);
+    return result == host::RunResult::DEADLOCK;
+}
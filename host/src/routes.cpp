@@ -0,0 +1,326 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "main.h"
+#include "lemlib/api.hpp"
+#include "host/devices.hpp"
+#include "host/kernel.hpp"
+#include "host/project.hpp"
+
+// the chassis and routines declared in src/main.cpp
+extern lemlib::Chassis chassis;
+void winpointauton();
+void poop();
+void skills();
+void realsix();
+void newwinpoint();
+void sixball();
+void fourball();
+void disruptor();
+void redallianceonestake();
+void redrush();
+void redallianceonestakeelims();
+void redalliancetwostake();
+void redalliancetwostakestop();
+void blueallianceonestake();
+void bluealliancetwostake();
+void bluealliancetwostakestop();
+void skillsRoute();
+void rednegative();
+
+namespace {
+/**
+ * @brief An autonomous routine, and how long it has to run
+ *
+ */
+struct Routine {
+        const char* name;
+        void (*function)();
+        /** time limit in milliseconds. 15 seconds for match autonomous, 60 for skills */
+        uint32_t timeLimit;
+};
+
+const Routine routines[] = {
+    {"winpointauton", winpointauton, 15000},
+    {"poop", poop, 15000},
+    {"skills", skills, 60000},
+    {"realsix", realsix, 15000},
+    {"newwinpoint", newwinpoint, 15000},
+    {"sixball", sixball, 15000},
+    {"fourball", fourball, 15000},
+    {"disruptor", disruptor, 15000},
+    {"redallianceonestake", redallianceonestake, 15000},
+    {"redrush", redrush, 15000},
+    {"redallianceonestakeelims", redallianceonestakeelims, 15000},
+    {"redalliancetwostake", redalliancetwostake, 15000},
+    {"redalliancetwostakestop", redalliancetwostakestop, 15000},
+    {"blueallianceonestake", blueallianceonestake, 15000},
+    {"bluealliancetwostake", bluealliancetwostake, 15000},
+    {"bluealliancetwostakestop", bluealliancetwostakestop, 15000},
+    {"skillsRoute", skillsRoute, 60000},
+    {"rednegative", rednegative, 15000},
+};
+
+/**
+ * @brief A finished motion, and how well it went
+ *
+ */
+struct Motion {
+        lemlib::MotionRecord record;
+        /** time spent stopped before the motion timed out, in milliseconds */
+        uint32_t timeLost;
+        /** distance between the robot and the target at the end, in inches */
+        float distanceError;
+        /** heading error at the end, in degrees */
+        float headingError;
+};
+
+/** where a routine's report goes. The robot's own output goes to stdout, see main() */
+FILE* report = stdout;
+/** last time the simulated robot was moving, in milliseconds */
+uint32_t lastMoving = 0;
+std::vector<Motion> motions;
+
+const char* typeName(lemlib::MotionType type) {
+    switch (type) {
+        case lemlib::MotionType::TURN_TO: return "turnTo";
+        case lemlib::MotionType::MOVE_TO_POSE: return "moveToPose";
+        case lemlib::MotionType::MOVE_TO_POINT: return "moveToPoint";
+        default: return "follow";
+    }
+}
+
+const char* resultName(lemlib::MotionResult result) {
+    switch (result) {
+        case lemlib::MotionResult::SETTLED: return "settled";
+        case lemlib::MotionResult::TIMEOUT: return "timeout";
+        case lemlib::MotionResult::EXITED: return "exited";
+        default: return "cancelled";
+    }
+}
+
+const char* runResultName(host::RunResult result) {
+    switch (result) {
+        case host::RunResult::FINISHED: return "finished";
+        case host::RunResult::TIMEOUT: return "timeout";
+        default: return "deadlock";
+    }
+}
+
+/**
+ * @brief Measure how far a finished motion ended from its target
+ *
+ * Errors are measured with the odometry pose, since that is what the motion was trying to settle.
+ */
+void observe(const lemlib::MotionRecord& record) {
+    Motion motion {record, 0, 0, 0};
+    const lemlib::Pose& pose = record.pose;
+    const float facing = record.forwards ? pose.theta : pose.theta - 180;
+    switch (record.type) {
+        case lemlib::MotionType::TURN_TO: {
+            const float target = lemlib::radToDeg(M_PI_2 - pose.angle(record.target));
+            motion.headingError = lemlib::angleError(target, facing, false);
+            break;
+        }
+        case lemlib::MotionType::MOVE_TO_POSE:
+            motion.distanceError = pose.distance(record.target);
+            motion.headingError = lemlib::angleError(record.target.theta, facing, false);
+            break;
+        default: motion.distanceError = pose.distance(record.target); break;
+    }
+    // a motion that times out while the robot is still moving was just too short, but one that sits still waiting
+    // for its timeout wastes all of that time
+    if (record.result == lemlib::MotionResult::TIMEOUT && record.end > lastMoving) {
+        motion.timeLost = record.end - std::max(lastMoving, record.start);
+    }
+    motions.push_back(motion);
+}
+
+/**
+ * @brief Run one routine against the simulator, and print its report
+ *
+ * The human readable report is printed first, then a line starting with "@json " with the machine readable report,
+ * and a line starting with "@total " with the route time, time lost and number of timeouts.
+ */
+int runRoutine(const Routine& routine) {
+    host::DrivetrainSimulator& simulator = host::projectSimulator();
+    host::onTick([&simulator](uint32_t time) {
+        const lemlib::Pose velocity = simulator.getVelocity();
+        if (std::hypot(velocity.x, velocity.y) > 0.5 || std::abs(velocity.theta) > 5) lastMoving = time;
+    });
+
+    if (host::run(initialize) != host::RunResult::FINISHED) {
+        std::fprintf(report, "%s: initialize did not finish\n", routine.name);
+        return 1;
+    }
+    chassis.setMotionObserver(observe);
+    host::setCompetitionStatus(COMPETITION_CONNECTED | COMPETITION_AUTONOMOUS);
+    const uint32_t start = host::millis();
+    const host::RunResult result = host::run(
+        [&routine] {
+            routine.function();
+            // the last motion may have been started asynchronously
+            while (chassis.isInMotion()) pros::delay(10);
+        },
+        routine.timeLimit);
+    const uint32_t time = host::millis() - start;
+
+    uint32_t timeLost = 0;
+    int timeouts = 0;
+    std::fprintf(report, "%s: %s in %ums\n", routine.name, runResultName(result), time);
+    std::fprintf(report, "  %-4s %-12s %-24s %8s %8s %-9s %8s %8s %8s\n", "#", "motion", "target", "start", "time",
+                 "result", "lost", "error", "heading");
+    for (size_t i = 0; i < motions.size(); i++) {
+        const Motion& motion = motions[i];
+        const lemlib::MotionRecord& record = motion.record;
+        char target[32];
+        std::snprintf(target, sizeof(target), "(%.1f, %.1f, %.1f)", record.target.x, record.target.y,
+                      record.target.theta);
+        std::fprintf(report, "  %-4zu %-12s %-24s %8u %8u %-9s %8u %8.2f %8.2f\n", i, typeName(record.type), target,
+                     record.start - start, record.end - record.start, resultName(record.result), motion.timeLost,
+                     motion.distanceError, motion.headingError);
+        timeLost += motion.timeLost;
+        if (record.result == lemlib::MotionResult::TIMEOUT) timeouts++;
+    }
+    std::fprintf(report, "  %d motions, %d timeouts, %ums lost to timeouts\n", int(motions.size()), timeouts, timeLost);
+#ifdef LEMLIB_PROFILING
+    // cpu time of LemLib's hot paths, measured in real time on this computer rather than simulated time
+    for (const lemlib::ProfileStats& zone : lemlib::getProfile()) {
+        std::fprintf(report, "  %-20s n %-8u mean %8.2fus  p99 %8.2fus  max %8.2fus\n", zone.name, zone.count,
+                     zone.mean, zone.p99, zone.max);
+    }
+#endif
+
+    std::string json;
+    json += "{\"name\":\"" + std::string(routine.name) + "\",\"result\":\"" + runResultName(result) +
+            "\",\"timeLimit\":" + std::to_string(routine.timeLimit) + ",\"time\":" + std::to_string(time) +
+            ",\"timeLost\":" + std::to_string(timeLost) + ",\"timeouts\":" + std::to_string(timeouts) +
+            ",\"motions\":[";
+    for (size_t i = 0; i < motions.size(); i++) {
+        const Motion& motion = motions[i];
+        const lemlib::MotionRecord& record = motion.record;
+        char buffer[512];
+        std::snprintf(buffer, sizeof(buffer),
+                      "%s{\"type\":\"%s\",\"target\":[%.3f,%.3f,%.3f],\"forwards\":%s,\"timeout\":%d,\"start\":%u,"
+                      "\"time\":%u,\"result\":\"%s\",\"timeLost\":%u,\"distanceError\":%.3f,\"headingError\":%.3f,"
+                      "\"pose\":[%.3f,%.3f,%.3f]}",
+                      i == 0 ? "" : ",", typeName(record.type), record.target.x, record.target.y, record.target.theta,
+                      record.forwards ? "true" : "false", record.timeout, record.start - start,
+                      record.end - record.start, resultName(record.result), motion.timeLost, motion.distanceError,
+                      motion.headingError, record.pose.x, record.pose.y, record.pose.theta);
+        json += buffer;
+    }
+    json += "]}";
+    std::fprintf(report, "@json %s\n", json.c_str());
+    std::fprintf(report, "@total %u %u %d\n", time, timeLost, timeouts);
+    return result == host::RunResult::DEADLOCK;
+}
+
+/**
+ * @brief Print how to use the program
+ *
+ */
+void usage(const char* name) {
+    std::printf("usage: %s [--json FILE] [--routine NAME]... | --list\n"
+                "  --json     write a machine readable summary to FILE\n"
+                "  --routine  only run the named routine. Can be given more than once\n"
+                "  --list     list the routines\n",
+                name);
+}
+} // namespace
+
+/**
+ * @brief Benchmark the autonomous routines in src/main.cpp against the drivetrain simulator
+ *
+ * Every routine runs in its own process, so routines can't affect each other through tasks or device state they
+ * leave behind, and they all run at once.
+ */
+int main(int argc, char** argv) {
+    const char* jsonPath = nullptr;
+    std::vector<const Routine*> selected;
+    bool child = false;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) jsonPath = argv[++i];
+        else if (std::strcmp(argv[i], "--routine") == 0 && i + 1 < argc) {
+            const char* name = argv[++i];
+            const Routine* found = nullptr;
+            for (const Routine& routine : routines) {
+                if (std::strcmp(routine.name, name) == 0) found = &routine;
+            }
+            if (found == nullptr) {
+                std::printf("unknown routine %s\n", name);
+                return 1;
+            }
+            selected.push_back(found);
+        } else if (std::strcmp(argv[i], "--child") == 0) child = true;
+        else if (std::strcmp(argv[i], "--list") == 0) {
+            for (const Routine& routine : routines) std::printf("%s\n", routine.name);
+            return 0;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (child) {
+        if (selected.size() != 1) return 1;
+        // initialize() streams binary telemetry over stdout, which would end up in the middle of the report, so the
+        // report goes to the original stdout and everything the robot prints is thrown away
+        report = fdopen(dup(STDOUT_FILENO), "w");
+        if (report == nullptr || std::freopen("/dev/null", "w", stdout) == nullptr) return 1;
+        const int status = runRoutine(*selected[0]);
+        std::fclose(report);
+        return status;
+    }
+    if (selected.empty()) {
+        for (const Routine& routine : routines) selected.push_back(&routine);
+    }
+
+    // start every routine at once, then collect the reports in order
+    std::vector<FILE*> children;
+    for (const Routine* routine : selected) {
+        const std::string command = std::string("'") + argv[0] + "' --child --routine " + routine->name;
+        children.push_back(popen(command.c_str(), "r"));
+    }
+    std::string json = "{\"routines\":[";
+    uint32_t totalTime = 0;
+    uint32_t totalLost = 0;
+    int totalTimeouts = 0;
+    int failures = 0;
+    char* line = nullptr;
+    size_t capacity = 0;
+    for (size_t i = 0; i < children.size(); i++) {
+        std::string routineJson = "null";
+        while (children[i] != nullptr && getline(&line, &capacity, children[i]) != -1) {
+            uint32_t time, lost;
+            int timeouts;
+            if (std::strncmp(line, "@json ", 6) == 0) routineJson.assign(line + 6, std::strcspn(line + 6, "\n"));
+            else if (std::sscanf(line, "@total %u %u %d", &time, &lost, &timeouts) == 3) {
+                totalTime += time;
+                totalLost += lost;
+                totalTimeouts += timeouts;
+            } else std::fputs(line, stdout);
+        }
+        if (children[i] == nullptr || pclose(children[i]) != 0) failures++;
+        json += (i == 0 ? "" : ",") + routineJson;
+    }
+    std::free(line);
+    json += "],\"time\":" + std::to_string(totalTime) + ",\"timeLost\":" + std::to_string(totalLost) +
+            ",\"timeouts\":" + std::to_string(totalTimeouts) + "}\n";
+    std::printf("%zu routines in %ums, %d timeouts, %ums lost to timeouts\n", selected.size(), totalTime,
+                totalTimeouts, totalLost);
+
+    if (jsonPath != nullptr) {
+        FILE* file = std::fopen(jsonPath, "w");
+        if (file == nullptr) {
+            std::printf("could not open %s\n", jsonPath);
+            return 1;
+        }
+        std::fputs(json.c_str(), file);
+        std::fclose(file);
+    }
+    return failures != 0;
+}
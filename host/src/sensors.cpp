@@ -0,0 +1,266 @@
+#include <cerrno>
+#include <cmath>
+#include "pros/error.h"
+#include "pros/rtos.hpp"
+#include "pros/rotation.hpp"
+#include "pros/imu.hpp"
+#include "pros/optical.hpp"
+#include "host/devices.hpp"
+#include "host/kernel.hpp"
+
+namespace {
+/**
+ * @brief Check a smart port like the firmware does, setting errno if it can't be used
+ *
+ * @return true the port is valid and the device is plugged in
+ * @return false the port is invalid or the device is unplugged
+ */
+bool check(uint8_t port, bool connected) {
+    if (port < 1 || port > 21) {
+        errno = ENXIO;
+        return false;
+    }
+    if (!connected) {
+        errno = ENODEV;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Wrap an angle to [0, range)
+ *
+ */
+double wrap(double angle, double range) {
+    angle = std::fmod(angle, range);
+    return angle < 0 ? angle + range : angle;
+}
+} // namespace
+
+namespace pros {
+Rotation::Rotation(const std::uint8_t port, const bool reverse_flag)
+    : _port(port) {
+    set_reversed(reverse_flag);
+}
+
+std::int32_t Rotation::reset() { return reset_position(); }
+
+std::int32_t Rotation::set_data_rate(std::uint32_t rate) const {
+    return check(_port, host::rotation(_port).connected) ? 1 : PROS_ERR;
+}
+
+std::int32_t Rotation::set_position(std::uint32_t position) {
+    host::RotationState& state = host::rotation(_port);
+    if (!check(_port, state.connected)) return PROS_ERR;
+    state.zero = (state.reversed ? -state.position : state.position) - position;
+    return 1;
+}
+
+std::int32_t Rotation::reset_position(void) { return set_position(0); }
+
+std::int32_t Rotation::get_position() {
+    host::RotationState& state = host::rotation(_port);
+    if (!check(_port, state.connected)) return PROS_ERR;
+    return (state.reversed ? -state.position : state.position) - state.zero;
+}
+
+std::int32_t Rotation::get_velocity() {
+    host::RotationState& state = host::rotation(_port);
+    if (!check(_port, state.connected)) return PROS_ERR;
+    return state.reversed ? -state.velocity : state.velocity;
+}
+
+std::int32_t Rotation::get_angle() {
+    host::RotationState& state = host::rotation(_port);
+    if (!check(_port, state.connected)) return PROS_ERR;
+    return wrap(state.reversed ? -state.position : state.position, 36000);
+}
+
+std::int32_t Rotation::set_reversed(bool value) {
+    host::RotationState& state = host::rotation(_port);
+    if (!check(_port, state.connected)) return PROS_ERR;
+    state.reversed = value;
+    return 1;
+}
+
+std::int32_t Rotation::reverse() { return set_reversed(!host::rotation(_port).reversed); }
+
+std::int32_t Rotation::get_reversed() {
+    host::RotationState& state = host::rotation(_port);
+    if (!check(_port, state.connected)) return PROS_ERR;
+    return state.reversed;
+}
+
+std::int32_t Imu::reset(bool blocking) const {
+    host::ImuState& state = host::imu(_port);
+    if (!check(_port, state.connected)) return PROS_ERR;
+    // calibration zeroes every angle
+    state.rotationOffset = -state.rotation;
+    state.headingOffset = -state.rotation;
+    state.yawOffset = -state.rotation;
+    state.pitchOffset = -state.pitch;
+    state.rollOffset = -state.roll;
+    state.calibrationEnd = std::max<uint32_t>(host::millis() + state.calibrationTime, 1);
+    if (blocking) {
+        while (is_calibrating()) pros::delay(10);
+    }
+    return 1;
+}
+
+std::int32_t Imu::set_data_rate(std::uint32_t rate) const {
+    return check(_port, host::imu(_port).connected) ? 1 : PROS_ERR;
+}
+
+// angles can't be read while the sensor is calibrating
+#define READ_IMU(expression)                                                                                           \
+    host::ImuState& state = host::imu(_port);                                                                          \
+    if (!check(_port, state.connected)) return PROS_ERR_F;                                                             \
+    if (state.calibrationEnd != 0) {                                                                                   \
+        errno = EAGAIN;                                                                                                \
+        return PROS_ERR_F;                                                                                             \
+    }                                                                                                                  \
+    return expression;
+
+double Imu::get_rotation() const { READ_IMU(state.rotation + state.rotationOffset) }
+
+double Imu::get_heading() const { READ_IMU(wrap(state.rotation + state.headingOffset, 360)) }
+
+double Imu::get_pitch() const { READ_IMU(wrap(state.pitch + state.pitchOffset + 180, 360) - 180) }
+
+double Imu::get_roll() const { READ_IMU(wrap(state.roll + state.rollOffset + 180, 360) - 180) }
+
+double Imu::get_yaw() const { READ_IMU(wrap(state.rotation + state.yawOffset + 180, 360) - 180) }
+
+pros::c::quaternion_s_t Imu::get_quaternion() const {
+    const pros::c::euler_s_t euler = get_euler();
+    if (euler.yaw == PROS_ERR_F) return {PROS_ERR_F, PROS_ERR_F, PROS_ERR_F, PROS_ERR_F};
+    const double cy = std::cos(euler.yaw * M_PI / 360), sy = std::sin(euler.yaw * M_PI / 360);
+    const double cp = std::cos(euler.pitch * M_PI / 360), sp = std::sin(euler.pitch * M_PI / 360);
+    const double cr = std::cos(euler.roll * M_PI / 360), sr = std::sin(euler.roll * M_PI / 360);
+    return {sr * cp * cy - cr * sp * sy, cr * sp * cy + sr * cp * sy, cr * cp * sy - sr * sp * cy,
+            cr * cp * cy + sr * sp * sy};
+}
+
+pros::c::euler_s_t Imu::get_euler() const { return {get_pitch(), get_roll(), get_yaw()}; }
+
+pros::c::imu_gyro_s_t Imu::get_gyro_rate() const {
+    host::ImuState& state = host::imu(_port);
+    if (!check(_port, state.connected)) return {PROS_ERR_F, PROS_ERR_F, PROS_ERR_F};
+    return {0, 0, state.gyroRate};
+}
+
+pros::c::imu_accel_s_t Imu::get_accel() const {
+    host::ImuState& state = host::imu(_port);
+    if (!check(_port, state.connected)) return {PROS_ERR_F, PROS_ERR_F, PROS_ERR_F};
+    return {state.accelX, state.accelY, state.accelZ};
+}
+
+// sets an angle by moving its offset
+#define SET_IMU(offset, raw, target)                                                                                   \
+    host::ImuState& state = host::imu(_port);                                                                          \
+    if (!check(_port, state.connected)) return PROS_ERR;                                                               \
+    state.offset = (target) - state.raw;                                                                               \
+    return 1;
+
+std::int32_t Imu::set_rotation(const double target) const { SET_IMU(rotationOffset, rotation, target) }
+
+std::int32_t Imu::set_heading(const double target) const { SET_IMU(headingOffset, rotation, target) }
+
+std::int32_t Imu::set_yaw(const double target) const { SET_IMU(yawOffset, rotation, target) }
+
+std::int32_t Imu::set_pitch(const double target) const { SET_IMU(pitchOffset, pitch, target) }
+
+std::int32_t Imu::set_roll(const double target) const { SET_IMU(rollOffset, roll, target) }
+
+std::int32_t Imu::set_euler(const pros::c::euler_s_t target) const {
+    if (set_pitch(target.pitch) == PROS_ERR) return PROS_ERR;
+    set_roll(target.roll);
+    return set_yaw(target.yaw);
+}
+
+std::int32_t Imu::tare_rotation() const { return set_rotation(0); }
+
+std::int32_t Imu::tare_heading() const { return set_heading(0); }
+
+std::int32_t Imu::tare_pitch() const { return set_pitch(0); }
+
+std::int32_t Imu::tare_yaw() const { return set_yaw(0); }
+
+std::int32_t Imu::tare_roll() const { return set_roll(0); }
+
+std::int32_t Imu::tare_euler() const { return set_euler({0, 0, 0}); }
+
+std::int32_t Imu::tare() const {
+    if (tare_euler() == PROS_ERR) return PROS_ERR;
+    tare_heading();
+    return tare_rotation();
+}
+
+pros::c::imu_status_e_t Imu::get_status() const {
+    host::ImuState& state = host::imu(_port);
+    if (!check(_port, state.connected)) return pros::c::E_IMU_STATUS_ERROR;
+    return state.calibrationEnd != 0 ? pros::c::E_IMU_STATUS_CALIBRATING : pros::c::imu_status_e_t(0);
+}
+
+bool Imu::is_calibrating() const { return get_status() == pros::c::E_IMU_STATUS_CALIBRATING; }
+
+Optical::Optical(const std::uint8_t port)
+    : _port(port) {}
+
+Optical::Optical(std::uint8_t port, double time)
+    : _port(port) {}
+
+double Optical::get_hue() {
+    host::OpticalState& state = host::optical(_port);
+    return check(_port, state.connected) ? state.hue : PROS_ERR_F;
+}
+
+double Optical::get_saturation() {
+    host::OpticalState& state = host::optical(_port);
+    return check(_port, state.connected) ? state.saturation : PROS_ERR_F;
+}
+
+double Optical::get_brightness() {
+    host::OpticalState& state = host::optical(_port);
+    return check(_port, state.connected) ? state.brightness : PROS_ERR_F;
+}
+
+std::int32_t Optical::get_proximity() {
+    host::OpticalState& state = host::optical(_port);
+    return check(_port, state.connected) ? state.proximity : PROS_ERR;
+}
+
+std::int32_t Optical::set_led_pwm(uint8_t value) {
+    host::OpticalState& state = host::optical(_port);
+    if (!check(_port, state.connected)) return PROS_ERR;
+    state.led = value;
+    return 1;
+}
+
+std::int32_t Optical::get_led_pwm() {
+    host::OpticalState& state = host::optical(_port);
+    return check(_port, state.connected) ? state.led : PROS_ERR;
+}
+
+pros::c::optical_rgb_s_t Optical::get_rgb() {
+    host::OpticalState& state = host::optical(_port);
+    if (!check(_port, state.connected)) return {PROS_ERR_F, PROS_ERR_F, PROS_ERR_F, PROS_ERR_F};
+    return {0, 0, 0, state.brightness};
+}
+
+pros::c::optical_raw_s_t Optical::get_raw() { return {}; }
+
+pros::c::optical_direction_e_t Optical::get_gesture() { return pros::c::NO_GESTURE; }
+
+pros::c::optical_gesture_s_t Optical::get_gesture_raw() { return {}; }
+
+std::int32_t Optical::enable_gesture() { return 1; }
+
+std::int32_t Optical::disable_gesture() { return 1; }
+
+double Optical::get_integration_time() { return 100; }
+
+std::int32_t Optical::set_integration_time(double time) { return 1; }
+
+std::uint8_t Optical::get_port() { return _port; }
+} // namespace pros
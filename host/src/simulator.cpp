@@ -0,0 +1,214 @@
+#include <algorithm>
+#include <cmath>
+#include "host/simulator.hpp"
+#include "host/devices.hpp"
+#include "host/kernel.hpp"
+
+namespace host {
+namespace {
+constexpr double GRAVITY = 9.81;
+constexpr double METERS_PER_INCH = 0.0254;
+/** free speed of the motor itself, before the cartridge, in rpm */
+constexpr double MOTOR_FREE_SPEED = 3600;
+/** longest physics step, in seconds. Shorter steps keep the stiff friction model stable */
+constexpr double MAX_STEP = 1e-4;
+
+/** convert rpm to radians per second */
+constexpr double rpmToRad(double rpm) { return rpm * M_PI / 30; }
+
+/** convert radians per second to rpm */
+constexpr double radToRpm(double rad) { return rad * 30 / M_PI; }
+
+/**
+ * @brief Friction force from slip, growing with the slip speed until it saturates and the surfaces slide
+ *
+ * @param slip relative speed of the surfaces, in m/s
+ * @param stiffness force per m/s of slip
+ * @param limit largest force friction can provide
+ */
+double friction(double slip, double stiffness, double limit) { return std::clamp(stiffness * slip, -limit, limit); }
+} // namespace
+
+DrivetrainSimulator::DrivetrainSimulator(pros::Motor_Group& left, pros::Motor_Group& right, DrivetrainModel model)
+    : model(model) {
+    for (uint8_t port : left.get_ports()) motors.push_back({port, true});
+    for (uint8_t port : right.get_ports()) motors.push_back({port, false});
+}
+
+void DrivetrainSimulator::addImu(uint8_t port) { imus.push_back(port); }
+
+void DrivetrainSimulator::addTrackingWheel(uint8_t port, double diameter, double offset, bool horizontal) {
+    trackingWheels.push_back({port, diameter, offset, horizontal});
+}
+
+void DrivetrainSimulator::start() {
+    if (started) return;
+    started = true;
+    for (Motor& motor : motors) host::motor(motor.port).simulated = true;
+    onTick([this](uint32_t) { step(0.001); });
+}
+
+void DrivetrainSimulator::setPose(lemlib::Pose pose) {
+    x = pose.x * METERS_PER_INCH;
+    y = pose.y * METERS_PER_INCH;
+    heading = pose.theta * M_PI / 180;
+    forward = sideways = yawRate = 0;
+    leftWheel = rightWheel = 0;
+}
+
+lemlib::Pose DrivetrainSimulator::getPose() const {
+    return lemlib::Pose(x / METERS_PER_INCH, y / METERS_PER_INCH, heading * 180 / M_PI);
+}
+
+lemlib::Pose DrivetrainSimulator::getVelocity() const {
+    return lemlib::Pose(sideways / METERS_PER_INCH, forward / METERS_PER_INCH, yawRate * 180 / M_PI);
+}
+
+bool DrivetrainSimulator::isSlipping() const { return slipping; }
+
+double DrivetrainSimulator::motorCurrent(Motor& motor, double speed) {
+    MotorState& state = host::motor(motor.port);
+    const MotorModel& constants = model.motor;
+    const double cartridgeSpeed = freeSpeed(state.gearset);
+    // the motor's own velocity controller, used for every command except voltage
+    auto velocityControl = [&](double target) {
+        target = std::clamp(target, -cartridgeSpeed, cartridgeSpeed);
+        return 12000 * (target + constants.velocityGain * (target - speed)) / cartridgeSpeed;
+    };
+
+    if (state.command != MotorCommand::BRAKE) motor.holding = false;
+    double voltage = 0;
+    bool open = false;
+    switch (state.command) {
+        case MotorCommand::VOLTAGE:
+            voltage = state.voltage;
+            // zero volts in coast mode leaves the windings open, so the motor spins freely
+            open = voltage == 0;
+            break;
+        case MotorCommand::VELOCITY: voltage = velocityControl(state.targetVelocity); break;
+        case MotorCommand::POSITION: {
+            const double limit = std::abs(state.targetVelocity);
+            voltage = velocityControl(
+                std::clamp(constants.positionGain * (state.targetPosition - state.position), -limit, limit));
+            break;
+        }
+        case MotorCommand::BRAKE:
+            if (state.brakeMode == pros::E_MOTOR_BRAKE_HOLD) {
+                if (!motor.holding) motor.holdPosition = state.position;
+                motor.holding = true;
+                voltage = velocityControl(constants.positionGain * (motor.holdPosition - state.position));
+            }
+            // otherwise the windings are shorted, so back EMF brakes the motor
+            break;
+    }
+
+    double maxVoltage = std::min<double>(12000, getBatteryVoltage());
+    if (state.voltageLimit != 0) maxVoltage = std::min<double>(maxVoltage, state.voltageLimit);
+    voltage = std::clamp(voltage, -maxVoltage, maxVoltage);
+    const double motorSpeed = rpmToRad(speed * MOTOR_FREE_SPEED / cartridgeSpeed);
+    const double limit = state.currentLimit / 1000.0;
+    const double current =
+        open ? 0
+             : std::clamp((voltage / 1000 - constants.backEmfConstant * motorSpeed) / constants.resistance, -limit, limit);
+
+    state.appliedVoltage = open ? 0 : voltage;
+    state.current = current * 1000;
+    state.torque = constants.torqueConstant * current * MOTOR_FREE_SPEED / cartridgeSpeed * constants.efficiency;
+    return current;
+}
+
+void DrivetrainSimulator::step(double dt) {
+    const MotorModel& constants = model.motor;
+    const double radius = model.wheelDiameter * METERS_PER_INCH / 2;
+    const double halfTrack = model.trackWidth * METERS_PER_INCH / 2;
+    const double halfBase = model.wheelBase * METERS_PER_INCH / 2;
+    // gear ratio between the motors themselves and the wheels
+    const double ratio = MOTOR_FREE_SPEED / model.wheelRpm;
+    const double sideWeight = model.mass * GRAVITY / 2;
+    const double tractionLimit = model.wheelFriction * sideWeight;
+    const double lateralLimit = model.lateralFriction * model.mass * GRAVITY;
+    const double rollingLimit = model.rollingResistance * sideWeight;
+
+    // the rotors spin much faster than the wheels, so they add a lot of inertia to each side
+    double leftMass = 0;
+    double rightMass = 0;
+    for (const Motor& motor : motors) {
+        (motor.left ? leftMass : rightMass) += constants.rotorInertia * ratio * ratio / (radius * radius);
+    }
+
+    const double startHeading = heading;
+    const int substeps = std::max(1, static_cast<int>(std::ceil(dt / MAX_STEP)));
+    const double h = dt / substeps;
+    std::vector<double> motorTravel(motors.size(), 0);
+    std::vector<double> wheelTravel(trackingWheels.size(), 0);
+    bool saturated = false;
+    for (int i = 0; i < substeps; i++) {
+        // drive force from the motors on each side
+        double leftDrive = 0;
+        double rightDrive = 0;
+        for (size_t m = 0; m < motors.size(); m++) {
+            Motor& motor = motors[m];
+            const MotorState& state = host::motor(motor.port);
+            const double direction = state.reversed ? -1 : 1;
+            const double wheelSpeed = radToRpm((motor.left ? leftWheel : rightWheel) / radius);
+            const double speed = wheelSpeed * freeSpeed(state.gearset) / model.wheelRpm;
+            const double current = direction * motorCurrent(motor, direction * speed);
+            const double force = constants.torqueConstant * current * ratio * constants.efficiency / radius;
+            (motor.left ? leftDrive : rightDrive) += force;
+            motorTravel[m] += direction * speed * 6 * h;
+        }
+
+        // friction between the wheels and the tiles
+        const double leftGround = forward + yawRate * halfTrack;
+        const double rightGround = forward - yawRate * halfTrack;
+        const double leftTraction = friction(leftWheel - leftGround, model.slipStiffness, tractionLimit);
+        const double rightTraction = friction(rightWheel - rightGround, model.slipStiffness, tractionLimit);
+        const double lateral = friction(-sideways, model.slipStiffness, lateralLimit);
+        const double scrub = friction(-yawRate * halfBase, model.slipStiffness, lateralLimit / 2) * halfBase;
+        saturated |= std::abs(leftTraction) >= tractionLimit || std::abs(rightTraction) >= tractionLimit;
+
+        // wheels
+        leftWheel += (leftDrive - leftTraction - friction(leftWheel, model.slipStiffness, rollingLimit)) / leftMass * h;
+        rightWheel +=
+            (rightDrive - rightTraction - friction(rightWheel, model.slipStiffness, rollingLimit)) / rightMass * h;
+
+        // chassis, in its own rotating frame
+        const double forwardAccel = (leftTraction + rightTraction) / model.mass + yawRate * sideways;
+        const double sidewaysAccel = lateral / model.mass - yawRate * forward;
+        const double yawAccel = ((leftTraction - rightTraction) * halfTrack + scrub) / model.inertia;
+        forward += forwardAccel * h;
+        sideways += sidewaysAccel * h;
+        yawRate += yawAccel * h;
+
+        heading += yawRate * h;
+        x += (forward * std::sin(heading) + sideways * std::cos(heading)) * h;
+        y += (forward * std::cos(heading) - sideways * std::sin(heading)) * h;
+        for (size_t w = 0; w < trackingWheels.size(); w++) {
+            const TrackingWheel& wheel = trackingWheels[w];
+            const double speed = wheel.horizontal ? sideways : forward;
+            wheelTravel[w] += (speed - wheel.offset * METERS_PER_INCH * yawRate) * h;
+        }
+    }
+    slipping = saturated;
+
+    // write the sensors back
+    for (size_t m = 0; m < motors.size(); m++) {
+        MotorState& state = host::motor(motors[m].port);
+        state.position += motorTravel[m];
+        state.velocity = motorTravel[m] / (6 * dt);
+    }
+    for (size_t w = 0; w < trackingWheels.size(); w++) {
+        const TrackingWheel& wheel = trackingWheels[w];
+        RotationState& state = rotation(wheel.port);
+        const double direction = state.reversed ? -1 : 1;
+        const double travel = direction * wheelTravel[w] / (wheel.diameter * METERS_PER_INCH * M_PI) * 36000;
+        state.position += travel;
+        state.velocity = travel / dt;
+    }
+    for (uint8_t port : imus) {
+        ImuState& state = imu(port);
+        state.rotation += (heading - startHeading) * 180 / M_PI;
+        state.gyroRate = yawRate * 180 / M_PI;
+    }
+}
+} // namespace host
@@ -0,0 +1,460 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "main.h"
+#include "lemlib/api.hpp"
+#include "lemlib/chassis/odom.hpp"
+#include "host/devices.hpp"
+#include "host/kernel.hpp"
+#include "host/project.hpp"
+
+// the robot declared in src/main.cpp
+extern lemlib::Chassis chassis;
+extern lemlib::Drivetrain drivetrain;
+extern lemlib::OdomSensors sensors;
+extern lemlib::ControllerSettings linearController;
+extern lemlib::ControllerSettings angularController;
+// odometry's speed estimates, from src/lemlib/chassis/odom.cpp
+extern lemlib::Pose odomSpeed;
+extern lemlib::Pose odomLocalSpeed;
+
+namespace {
+/**
+ * @brief A gain that can be swept
+ *
+ * The baseline is where src/main.cpp keeps the gain. Its value there is the parameter's value until one is given on the
+ * command line, and is what the baseline gain set uses. Gains with a range are drawn uniformly from it for every other
+ * gain set.
+ */
+struct Parameter {
+        const char* name;
+        const float* baseline;
+        float value;
+        float min;
+        float max;
+};
+
+// moveToPose's defaults, which src/main.cpp doesn't change
+const lemlib::MoveToPoseParams moveToPoseDefaults;
+
+Parameter parameters[] = {
+    {"lateral-kp", &linearController.kP},
+    {"lateral-kd", &linearController.kD},
+    {"lateral-slew", &linearController.slew},
+    {"lateral-small-error", &linearController.smallError},
+    {"lateral-large-error", &linearController.largeError},
+    {"angular-kp", &angularController.kP},
+    {"angular-kd", &angularController.kD},
+    {"angular-slew", &angularController.slew},
+    {"angular-small-error", &angularController.smallError},
+    {"angular-large-error", &angularController.largeError},
+    {"lead", &moveToPoseDefaults.lead},
+    {"chase-power", &drivetrain.chasePower},
+};
+
+constexpr int PARAMETER_COUNT = sizeof(parameters) / sizeof(parameters[0]);
+
+/** the value of every parameter, in the order of the parameter table */
+typedef std::vector<float> GainSet;
+
+/**
+ * @brief How the robot and its sensors are disturbed on one trial
+ *
+ */
+struct Scenario {
+        /** where the motion drives to, relative to where the robot starts */
+        lemlib::Pose target;
+        /** battery voltage in millivolts */
+        int32_t battery;
+        /** inertial sensor drift, in degrees per second */
+        double imuDrift;
+        /** standard deviation of inertial sensor noise, in degrees */
+        double imuNoise;
+        /** standard deviation of tracking wheel noise, in centidegrees */
+        double wheelNoise;
+        /** seed of the noise on every tick */
+        uint32_t seed;
+};
+
+/**
+ * @brief How a gain set did over every trial
+ *
+ */
+struct Result {
+        int set;
+        /** completion times, in milliseconds */
+        float meanTime;
+        float p95Time;
+        /** 95th percentile of the distance between the true pose and the target, in inches */
+        float p95Error;
+        /** 95th percentile of the heading error of the true pose, in degrees */
+        float p95Heading;
+        int timeouts;
+};
+
+struct Options {
+        int sets = 200;
+        int trials = 20;
+        uint32_t seed = 1;
+        int jobs = std::max(1u, std::thread::hardware_concurrency());
+        int timeout = 4000;
+        float maxError = 1;
+        float maxHeading = 5;
+        int top = 10;
+        const char* csvPath = nullptr;
+};
+
+/**
+ * @brief Get the 95th percentile of some values
+ *
+ */
+float p95(std::vector<float> values) {
+    std::sort(values.begin(), values.end());
+    return values[std::max<int>(std::ceil(values.size() * 0.95) - 1, 0)];
+}
+
+/**
+ * @brief Draw every gain set. The first one is always the baseline
+ *
+ * Sets only depend on the seed, so every process draws the same ones.
+ */
+std::vector<GainSet> drawSets(const Options& options) {
+    std::mt19937 rng(options.seed);
+    std::vector<GainSet> sets;
+    GainSet baseline;
+    for (const Parameter& parameter : parameters) baseline.push_back(parameter.value);
+    sets.push_back(baseline);
+    for (int i = 1; i < options.sets; i++) {
+        GainSet set;
+        for (const Parameter& parameter : parameters) {
+            set.push_back(std::uniform_real_distribution<float>(parameter.min, parameter.max)(rng));
+        }
+        sets.push_back(set);
+    }
+    return sets;
+}
+
+/**
+ * @brief Draw the scenario of every trial
+ *
+ * Every gain set runs the same scenarios, so differences between sets come from the gains rather than from luck.
+ */
+std::vector<Scenario> drawScenarios(const Options& options) {
+    std::mt19937 rng(options.seed + 1);
+    auto uniform = [&rng](double min, double max) { return std::uniform_real_distribution<double>(min, max)(rng); };
+    std::vector<Scenario> scenarios;
+    for (int i = 0; i < options.trials; i++) {
+        // somewhere ahead of the robot, arriving at up to 60 degrees from the direction of travel
+        const double distance = uniform(12, 48);
+        const double bearing = uniform(-60, 60);
+        const double heading = bearing + uniform(-60, 60);
+        const lemlib::Pose target(distance * std::sin(lemlib::degToRad(bearing)),
+                                  distance * std::cos(lemlib::degToRad(bearing)), heading);
+        scenarios.push_back({target, int32_t(uniform(11500, 12800)), uniform(-0.02, 0.02), uniform(0, 0.05),
+                             uniform(0, 5), uint32_t(rng())});
+    }
+    return scenarios;
+}
+
+// noise of the trial that is running, applied on every tick
+Scenario noise {lemlib::Pose(0, 0), 0, 0, 0, 0, 0};
+std::mt19937 noiseRng;
+double imuOffset = 0;
+double wheelOffset = 0;
+
+/**
+ * @brief Add the noise of the running trial to the inertial sensor and tracking wheel of src/main.cpp
+ *
+ * Drift accumulates, but white noise replaces the noise of the last tick, so it doesn't turn into a random walk.
+ */
+void addNoise(uint32_t) {
+    std::normal_distribution<double> gaussian(0, 1);
+    const double imuSample = gaussian(noiseRng) * noise.imuNoise;
+    const double wheelSample = gaussian(noiseRng) * noise.wheelNoise;
+    host::imu(10).rotation += noise.imuDrift / 1000 + imuSample - imuOffset;
+    host::rotation(5).position += wheelSample - wheelOffset;
+    imuOffset = imuSample;
+    wheelOffset = wheelSample;
+}
+
+/**
+ * @brief Put the robot, its sensors and odometry back where every trial starts
+ *
+ * Sensor readings, noise and odometry would otherwise carry over from the trials before, so a gain set's results would
+ * depend on which sets its worker ran first.
+ */
+void resetTrial(host::DrivetrainSimulator& simulator, lemlib::Chassis& trial) {
+    simulator.setPose(lemlib::Pose(0, 0, 0));
+    for (pros::Motor_Group* group : {drivetrain.leftMotors, drivetrain.rightMotors}) {
+        for (int i = 0; i < group->size(); i++) {
+            host::MotorState& state = host::motor((*group)[i].get_port());
+            state.position = state.velocity = 0;
+        }
+    }
+    host::RotationState& wheel = host::rotation(5);
+    wheel.position = wheel.velocity = 0;
+    host::ImuState& imu = host::imu(10);
+    imu.rotation = imu.gyroRate = 0;
+    imuOffset = wheelOffset = 0;
+    // the filtered battery voltage would still be settling from the last trial's battery
+    lemlib::setVoltageCompensation(12000);
+    // take a sample of the reset sensors, so odometry doesn't see them jump, then forget the jump
+    lemlib::update();
+    trial.setPose(0, 0, 0);
+    odomSpeed = odomLocalSpeed = lemlib::Pose(0, 0, 0);
+}
+
+/**
+ * @brief Run every trial with one gain set
+ *
+ */
+Result runSet(int index, const GainSet& set, const std::vector<Scenario>& scenarios, const Options& options) {
+    auto value = [&set](const char* name) {
+        for (int i = 0; i < PARAMETER_COUNT; i++) {
+            if (std::strcmp(parameters[i].name, name) == 0) return set[i];
+        }
+        return 0.0f;
+    };
+    // gains that aren't swept, like the integral gain and the exit timeouts, are the ones in src/main.cpp
+    lemlib::ControllerSettings lateral = linearController;
+    lateral.kP = value("lateral-kp");
+    lateral.kD = value("lateral-kd");
+    lateral.slew = value("lateral-slew");
+    lateral.smallError = value("lateral-small-error");
+    lateral.largeError = value("lateral-large-error");
+    lemlib::ControllerSettings angular = angularController;
+    angular.kP = value("angular-kp");
+    angular.kD = value("angular-kd");
+    angular.slew = value("angular-slew");
+    angular.smallError = value("angular-small-error");
+    angular.largeError = value("angular-large-error");
+    lemlib::Chassis trial(drivetrain, lateral, angular, sensors);
+    uint32_t time = 0;
+    bool timedOut = false;
+    trial.setMotionObserver([&](const lemlib::MotionRecord& record) {
+        time = record.end - record.start;
+        timedOut = record.result == lemlib::MotionResult::TIMEOUT;
+    });
+
+    host::DrivetrainSimulator& simulator = host::projectSimulator();
+    std::vector<float> times, errors, headings;
+    int timeouts = 0;
+    for (const Scenario& scenario : scenarios) {
+        host::setBatteryVoltage(scenario.battery);
+        resetTrial(simulator, trial);
+        noise = scenario;
+        noiseRng.seed(scenario.seed);
+
+        lemlib::MoveToPoseParams params;
+        params.lead = value("lead");
+        params.chasePower = value("chase-power");
+        trial.moveToPose(scenario.target.x, scenario.target.y, scenario.target.theta, options.timeout, params, false);
+
+        // judge the motion by where the robot really is, not where odometry thinks it is
+        const lemlib::Pose truth = simulator.getPose();
+        times.push_back(time);
+        errors.push_back(truth.distance(scenario.target));
+        headings.push_back(std::abs(lemlib::angleError(scenario.target.theta, truth.theta, false)));
+        if (timedOut) timeouts++;
+        // let the robot coast to a stop so the next trial starts still
+        noise.imuDrift = noise.imuNoise = noise.wheelNoise = 0;
+        pros::delay(500);
+    }
+
+    float total = 0;
+    for (float time : times) total += time;
+    return {index, total / times.size(), p95(times), p95(errors), p95(headings), timeouts};
+}
+
+/**
+ * @brief Whether a gain set meets the accuracy constraint
+ *
+ */
+bool accurate(const Result& result, const Options& options) {
+    return result.timeouts == 0 && result.p95Error <= options.maxError && result.p95Heading <= options.maxHeading;
+}
+
+/**
+ * @brief Run every gain set assigned to one worker, printing a line starting with "@set " for each
+ *
+ * Sets are dealt out round robin, so every worker gets a similar mix.
+ */
+int runWorker(int job, const Options& options) {
+    const std::vector<GainSet> sets = drawSets(options);
+    const std::vector<Scenario> scenarios = drawScenarios(options);
+    host::projectSimulator();
+    host::onTick(addNoise);
+    const host::RunResult result = host::run([&] {
+        // the parts of initialize() that motions depend on
+        chassis.calibrate();
+        chassis.setPose(0, 0, 0);
+        lemlib::setVoltageCompensation(12000);
+        for (size_t i = job; i < sets.size(); i += options.jobs) {
+            const Result result = runSet(i, sets[i], scenarios, options);
+            std::printf("@set %d %f %f %f %f %d\n", result.set, result.meanTime, result.p95Time, result.p95Error,
+                        result.p95Heading, result.timeouts);
+            std::fflush(stdout);
+        }
+    });
+    return result != host::RunResult::FINISHED;
+}
+
+/**
+ * @brief Print how to use the program
+ *
+ */
+void usage(const char* name) {
+    std::printf("usage: %s [options] [--PARAMETER MIN:MAX | --PARAMETER VALUE]...\n"
+                "  --sets N          gain sets to try, including the baseline from src/main.cpp. 200 by default\n"
+                "  --trials N        randomized motions to run with every gain set. 20 by default\n"
+                "  --seed N          seed of the gain sets and trials. 1 by default\n"
+                "  --jobs N          worker processes. One per core by default\n"
+                "  --timeout MS      timeout of every motion. 4000 by default\n"
+                "  --max-error IN    largest 95th percentile distance error of an accurate gain set. 1 by default\n"
+                "  --max-heading DEG largest 95th percentile heading error of an accurate gain set. 5 by default\n"
+                "  --top N           gain sets to print. 10 by default\n"
+                "  --csv FILE        write every gain set and its results to FILE\n"
+                "parameters, and their values in src/main.cpp:\n",
+                name);
+    for (const Parameter& parameter : parameters) std::printf("  --%-20s %g\n", parameter.name, *parameter.baseline);
+}
+
+/**
+ * @brief Parse a parameter range, either MIN:MAX or a single value
+ *
+ */
+bool parseRange(const char* text, Parameter& parameter) {
+    float min, max;
+    if (std::sscanf(text, "%f:%f", &min, &max) == 2 && min <= max) {
+        parameter.min = min;
+        parameter.max = max;
+        return true;
+    }
+    if (std::sscanf(text, "%f", &min) == 1) {
+        parameter.value = parameter.min = parameter.max = min;
+        return true;
+    }
+    return false;
+}
+} // namespace
+
+/**
+ * @brief Monte Carlo sweep of the chassis gains against the drivetrain simulator
+ *
+ * Every gain set drives the same randomized moveToPose trials, each with its own battery voltage and sensor noise.
+ * Gain sets that always settle within the accuracy constraint are ranked by their mean completion time. The host
+ * kernel runs one robot per process, so the sweep runs in parallel as several worker processes.
+ */
+int main(int argc, char** argv) {
+    // src/main.cpp's globals are only guaranteed to be constructed once main() starts
+    for (Parameter& parameter : parameters) parameter.value = parameter.min = parameter.max = *parameter.baseline;
+    Options options;
+    int job = -1;
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        Parameter* parameter = nullptr;
+        for (Parameter& candidate : parameters) {
+            if (std::strncmp(arg, "--", 2) == 0 && std::strcmp(arg + 2, candidate.name) == 0) parameter = &candidate;
+        }
+        if (parameter != nullptr && hasValue && parseRange(argv[i + 1], *parameter)) i++;
+        else if (std::strcmp(arg, "--sets") == 0 && hasValue) options.sets = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(arg, "--trials") == 0 && hasValue) options.trials = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(arg, "--seed") == 0 && hasValue) options.seed = std::strtoul(argv[++i], nullptr, 10);
+        else if (std::strcmp(arg, "--jobs") == 0 && hasValue) options.jobs = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(arg, "--timeout") == 0 && hasValue) options.timeout = std::atoi(argv[++i]);
+        else if (std::strcmp(arg, "--max-error") == 0 && hasValue) options.maxError = std::atof(argv[++i]);
+        else if (std::strcmp(arg, "--max-heading") == 0 && hasValue) options.maxHeading = std::atof(argv[++i]);
+        else if (std::strcmp(arg, "--top") == 0 && hasValue) options.top = std::atoi(argv[++i]);
+        else if (std::strcmp(arg, "--csv") == 0 && hasValue) options.csvPath = argv[++i];
+        else if (std::strcmp(arg, "--worker") == 0 && hasValue) job = std::atoi(argv[++i]);
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    options.jobs = std::min(options.jobs, options.sets);
+    if (job >= 0) return runWorker(job, options);
+
+    // start the workers with the same options, then collect their results
+    std::string arguments;
+    for (int i = 1; i < argc; i++) arguments += std::string(" '") + argv[i] + "'";
+    arguments += " --jobs " + std::to_string(options.jobs);
+    std::vector<FILE*> workers;
+    for (int i = 0; i < options.jobs; i++) {
+        const std::string command = std::string("'") + argv[0] + "'" + arguments + " --worker " + std::to_string(i);
+        workers.push_back(popen(command.c_str(), "r"));
+    }
+    std::vector<Result> results;
+    int failures = 0;
+    char* line = nullptr;
+    size_t capacity = 0;
+    for (FILE* worker : workers) {
+        while (worker != nullptr && getline(&line, &capacity, worker) != -1) {
+            Result result;
+            if (std::sscanf(line, "@set %d %f %f %f %f %d", &result.set, &result.meanTime, &result.p95Time,
+                            &result.p95Error, &result.p95Heading, &result.timeouts) == 6) {
+                results.push_back(result);
+            }
+        }
+        if (worker == nullptr || pclose(worker) != 0) failures++;
+    }
+    std::free(line);
+    if (failures != 0) std::printf("%d workers failed\n", failures);
+
+    // accurate sets first, then by mean and 95th percentile completion time
+    std::sort(results.begin(), results.end(), [&options](const Result& a, const Result& b) {
+        if (accurate(a, options) != accurate(b, options)) return accurate(a, options);
+        if (a.meanTime != b.meanTime) return a.meanTime < b.meanTime;
+        if (a.p95Time != b.p95Time) return a.p95Time < b.p95Time;
+        // results arrive in a different order with a different number of workers, so ties go to the earlier set
+        return a.set < b.set;
+    });
+    const std::vector<GainSet> sets = drawSets(options);
+    int accurateSets = 0;
+    for (const Result& result : results) accurateSets += accurate(result, options);
+    std::printf("%zu gain sets x %d trials, %d accurate (p95 error <= %.2f in, p95 heading <= %.1f deg, no timeouts)\n",
+                results.size(), options.trials, accurateSets, options.maxError, options.maxHeading);
+    std::printf("%-5s %-5s %9s %9s %9s %9s %8s", "rank", "set", "mean ms", "p95 ms", "p95 in", "p95 deg", "timeouts");
+    for (const Parameter& parameter : parameters) {
+        if (parameter.min != parameter.max) std::printf(" %20s", parameter.name);
+    }
+    std::printf("\n");
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& result = results[i];
+        // always show the baseline, so the best sets can be compared against it
+        if (int(i) >= options.top && result.set != 0) continue;
+        std::printf("%-5zu %-5s %9.0f %9.0f %9.2f %9.2f %8d", i + 1,
+                    result.set == 0 ? "base" : std::to_string(result.set).c_str(), result.meanTime, result.p95Time,
+                    result.p95Error, result.p95Heading, result.timeouts);
+        for (int p = 0; p < PARAMETER_COUNT; p++) {
+            if (parameters[p].min != parameters[p].max) std::printf(" %20.3f", sets[result.set][p]);
+        }
+        std::printf("%s\n", accurate(result, options) ? "" : "  (inaccurate)");
+    }
+
+    if (options.csvPath != nullptr) {
+        FILE* file = std::fopen(options.csvPath, "w");
+        if (file == nullptr) {
+            std::printf("could not open %s\n", options.csvPath);
+            return 1;
+        }
+        std::fputs("set,accurate,mean_ms,p95_ms,p95_error_in,p95_heading_deg,timeouts", file);
+        for (const Parameter& parameter : parameters) std::fprintf(file, ",%s", parameter.name);
+        std::fputs("\n", file);
+        for (const Result& result : results) {
+            std::fprintf(file, "%d,%d,%.1f,%.1f,%.3f,%.3f,%d", result.set, accurate(result, options), result.meanTime,
+                         result.p95Time, result.p95Error, result.p95Heading, result.timeouts);
+            for (float value : sets[result.set]) std::fprintf(file, ",%g", value);
+            std::fputs("\n", file);
+        }
+        std::fclose(file);
+    }
+    return failures != 0;
+}
@@ -0,0 +1,207 @@
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "lemlib/telemetry.hpp"
+#include "lemlib/logger/flightRecorderSink.hpp"
+
+namespace {
+/**
+ * @brief How to print one type of record
+ *
+ */
+struct RecordFormat {
+        lemlib::RecordType type;
+        const char* name;
+        const char* header;
+        size_t size;
+        FILE* out;
+};
+
+RecordFormat formats[] = {
+    {lemlib::RecordType::POSE, "pose", "time,x,y,theta", sizeof(lemlib::PoseRecord), stdout},
+    {lemlib::RecordType::SPEED, "speed", "time,x,y,theta", sizeof(lemlib::SpeedRecord), stdout},
+    {lemlib::RecordType::MOTION, "motion", "time,type,running,target_x,target_y,target_theta,distance",
+     sizeof(lemlib::MotionStateRecord), stdout},
+    {lemlib::RecordType::CONTROLLER, "controller", "time,lateral,angular,left,right", sizeof(lemlib::ControllerRecord),
+     stdout},
+    {lemlib::RecordType::TASK, "task", "time,name,cpu,longest_us,stack_free,stack_size", sizeof(lemlib::TaskRecord),
+     stdout},
+    // text records vary in size
+    {lemlib::RecordType::TEXT, "text", "time,message", 0, stdout},
+};
+
+/**
+ * @brief Print how to use the program
+ *
+ */
+void usage(const char* name) {
+    std::printf("usage: %s [--out PREFIX] [FILE]\n"
+                "  decodes the binary telemetry in FILE, or stdin, into csv. FILE can be a flight record\n"
+                "  --out  write each type of record to PREFIX-TYPE.csv, with a header, instead of\n"
+                "         printing every record to stdout with its type as the first column. Records\n"
+                "         of types the decoder doesn't know are only printed without --out, as floats\n",
+                name);
+}
+
+/**
+ * @brief Print a decoded record as a line of csv
+ *
+ */
+void printRecord(const RecordFormat& format, uint32_t time, const uint8_t* payload, size_t size, bool prefix) {
+    if (prefix) std::fprintf(format.out, "%s,", format.name);
+    std::fprintf(format.out, "%u", time);
+    switch (format.type) {
+        case lemlib::RecordType::TEXT: {
+            // quote the message, doubling any quotes in it
+            std::fputs(",\"", format.out);
+            for (size_t i = 0; i < size; i++) {
+                if (payload[i] == '"') std::fputc('"', format.out);
+                std::fputc(payload[i], format.out);
+            }
+            std::fputc('"', format.out);
+            break;
+        }
+        case lemlib::RecordType::MOTION: {
+            lemlib::MotionStateRecord record;
+            std::memcpy(&record, payload, sizeof(record));
+            std::fprintf(format.out, ",%u,%u,%.3f,%.3f,%.3f,%.3f", record.type, record.running, record.targetX,
+                         record.targetY, record.targetTheta, record.distance);
+            break;
+        }
+        case lemlib::RecordType::TASK: {
+            lemlib::TaskRecord record;
+            std::memcpy(&record, payload, sizeof(record));
+            std::fprintf(format.out, ",%.*s,%.3f,%u,%d,%u", int(strnlen(record.name, sizeof(record.name))),
+                         record.name, record.cpu, record.longest, record.stackFree, record.stackSize);
+            break;
+        }
+        default: {
+            // every other record is just floats
+            for (size_t i = 0; i < format.size; i += sizeof(float)) {
+                float value;
+                std::memcpy(&value, payload + i, sizeof(value));
+                std::fprintf(format.out, ",%.3f", value);
+            }
+        }
+    }
+    std::fputc('\n', format.out);
+}
+} // namespace
+
+/**
+ * @brief Decode binary telemetry into csv
+ *
+ * The stream is split on zero bytes, and every chunk is decoded as a frame. Chunks that aren't valid frames are text
+ * printed between frames, or frames that were corrupted on the way, and are skipped and counted.
+ */
+int main(int argc, char** argv) {
+    const char* path = nullptr;
+    const char* prefix = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc) prefix = argv[++i];
+        else if (argv[i][0] != '-' && path == nullptr) path = argv[i];
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    FILE* in = path == nullptr ? stdin : std::fopen(path, "rb");
+    if (in == nullptr) {
+        std::fprintf(stderr, "could not open %s\n", path);
+        return 1;
+    }
+    if (prefix != nullptr) {
+        for (RecordFormat& format : formats) {
+            const std::string file = std::string(prefix) + "-" + format.name + ".csv";
+            format.out = std::fopen(file.c_str(), "w");
+            if (format.out == nullptr) {
+                std::fprintf(stderr, "could not open %s\n", file.c_str());
+                return 1;
+            }
+            std::fprintf(format.out, "%s\n", format.header);
+        }
+    }
+
+    // flight records start with a header and the configuration text, which aren't frames
+    lemlib::FlightRecordHeader header;
+    const size_t headerSize = std::fread(&header, 1, sizeof(header), in);
+    // bytes read ahead that still need decoding
+    std::vector<uint8_t> readAhead;
+    if (headerSize == sizeof(header) && std::memcmp(header.magic, "LREC", 4) == 0) {
+        std::string config(header.configSize, '\0');
+        if (std::fread(config.data(), 1, config.size(), in) != config.size()) config.clear();
+        std::fprintf(stderr, "flight record version %u, built %.24s, opened at %u ms, sampled every %u ms\n",
+                     header.version, header.build, header.startTime, header.period);
+        if (!config.empty()) std::fprintf(stderr, "config: %s\n", config.c_str());
+    } else {
+        // not a flight record, so decode from the start. Seeking doesn't work on pipes, so keep the bytes instead
+        readAhead.assign(reinterpret_cast<uint8_t*>(&header), reinterpret_cast<uint8_t*>(&header) + headerSize);
+    }
+
+    int records = 0;
+    int skipped = 0;
+    std::vector<uint8_t> chunk;
+    uint8_t payload[256];
+    lemlib::PoseStreamDecoder poseStream;
+    size_t readAheadPos = 0;
+    int c;
+    do {
+        c = readAheadPos < readAhead.size() ? readAhead[readAheadPos++] : std::fgetc(in);
+        if (c != 0 && c != EOF) {
+            chunk.push_back(c);
+            continue;
+        }
+        if (chunk.empty()) continue;
+        lemlib::RecordType type;
+        uint32_t time;
+        const int size = lemlib::decodeRecord(chunk.data(), chunk.size(), type, time, payload);
+        chunk.clear();
+        if (size >= 0 && type == lemlib::RecordType::POSE_STREAM) {
+            // print the poses in the stream like pose records
+            uint32_t times[lemlib::MAX_POSE_STREAM_DELTAS];
+            lemlib::PoseRecord poses[lemlib::MAX_POSE_STREAM_DELTAS];
+            const int count = poseStream.decode(time, payload, size, times, poses);
+            for (int i = 0; i < count; i++) {
+                printRecord(formats[0], times[i], reinterpret_cast<const uint8_t*>(&poses[i]), sizeof(poses[i]),
+                            prefix == nullptr);
+            }
+            // records after a lost one can't be decoded until the next keyframe
+            if (count == 0) skipped++;
+            else records++;
+            continue;
+        }
+        const RecordFormat* format = nullptr;
+        for (const RecordFormat& candidate : formats) {
+            if (size < 0) break;
+            if (candidate.type == type && (candidate.size == size_t(size) || type == lemlib::RecordType::TEXT)) {
+                format = &candidate;
+            }
+        }
+        if (format == nullptr && size >= 0 && prefix == nullptr && size % sizeof(float) == 0) {
+            // a record from a channel added by the program. Print it as floats, since that's what most records are
+            std::printf("record%u,%u", static_cast<unsigned>(type), time);
+            for (int i = 0; i < size; i += sizeof(float)) {
+                float value;
+                std::memcpy(&value, payload + i, sizeof(value));
+                std::printf(",%.3f", value);
+            }
+            std::printf("\n");
+            records++;
+            continue;
+        }
+        if (format == nullptr) {
+            skipped++;
+            continue;
+        }
+        printRecord(*format, time, payload, size, prefix == nullptr);
+        records++;
+    } while (c != EOF);
+
+    std::fprintf(stderr, "%d records decoded, %d chunks skipped\n", records, skipped);
+    if (prefix != nullptr) {
+        for (RecordFormat& format : formats) std::fclose(format.out);
+    }
+    return 0;
+}
@@ -11,9 +11,16 @@
 #pragma once
 
 #include "lemlib/util.hpp"
+#include "lemlib/clock.hpp"
 #include "lemlib/pid.hpp"
 #include "lemlib/pose.hpp"
 #include "lemlib/chassis/trackingWheel.hpp"
 #include "lemlib/chassis/chassis.hpp"
+#include "lemlib/chassis/executive.hpp"
+#include "lemlib/output.hpp"
+#include "lemlib/lift.hpp"
+#include "lemlib/profiler.hpp"
+#include "lemlib/taskMonitor.hpp"
+#include "lemlib/telemetry.hpp"
 
 #include "lemlib/logger/logger.hpp"
\ No newline at end of file
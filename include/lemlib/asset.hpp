@@ -2,6 +2,7 @@
 
 #include <stdint.h>
 #include <cstddef>
+#include <vector>
 
 extern "C" {
 
@@ -11,8 +12,262 @@ typedef struct __attribute__((__packed__)) _asset {
 } asset;
 }
 
+
+namespace lemlib {
+/**
+ * @brief The type of the elements of a typed asset
+ *
+ * PATH_POINT elements are AssetPoint, the same points as the text path format
+ */
+enum class AssetType : uint8_t {
+    UINT8 = 1,
+    INT16 = 2,
+    UINT16 = 3,
+    INT32 = 4,
+    UINT32 = 5,
+    FLOAT32 = 6,
+    PATH_POINT = 7
+};
+
+/**
+ * @brief Version of the typed asset format this build reads
+ *
+ */
+constexpr uint16_t ASSET_VERSION = 1;
+
+/**
+ * @brief The start of a typed asset
+ *
+ * The header is followed by padding, then count elements of the given type, starting dataOffset bytes from the start
+ * of the asset. dataOffset is a multiple of alignment, and assets are linked at addresses aligned to 16 bytes, so the
+ * elements can be used where they are without copying. Multi-byte values are little endian. Make typed assets with
+ * host/build/asset.
+ *
+ * @param magic "LAST"
+ * @param version version of the format
+ * @param type the type of the elements
+ * @param alignment alignment of the elements, in bytes. A power of 2, at most 16
+ * @param count number of elements
+ * @param elementSize size of each element, in bytes
+ * @param dataOffset where the elements start, in bytes from the start of the asset
+ */
+struct AssetHeader {
+        char magic[4];
+        uint16_t version;
+        AssetType type;
+        uint8_t alignment;
+        uint32_t count;
+        uint32_t elementSize;
+        uint32_t dataOffset;
+};
+
+/**
+ * @brief A point of a path stored as a typed asset
+ *
+ * @param x x position, in inches
+ * @param y y position, in inches
+ * @param speed speed at the point, from 0 to 127
+ */
+struct AssetPoint {
+        float x;
+        float y;
+        float speed;
+};
+
+/**
+ * @brief The AssetType of each element type
+ *
+ */
+template <typename T> struct AssetTypeOf;
+
+template <> struct AssetTypeOf<uint8_t> {
+        static constexpr AssetType value = AssetType::UINT8;
+};
+
+template <> struct AssetTypeOf<int16_t> {
+        static constexpr AssetType value = AssetType::INT16;
+};
+
+template <> struct AssetTypeOf<uint16_t> {
+        static constexpr AssetType value = AssetType::UINT16;
+};
+
+template <> struct AssetTypeOf<int32_t> {
+        static constexpr AssetType value = AssetType::INT32;
+};
+
+template <> struct AssetTypeOf<uint32_t> {
+        static constexpr AssetType value = AssetType::UINT32;
+};
+
+template <> struct AssetTypeOf<float> {
+        static constexpr AssetType value = AssetType::FLOAT32;
+};
+
+template <> struct AssetTypeOf<AssetPoint> {
+        static constexpr AssetType value = AssetType::PATH_POINT;
+};
+
+/**
+ * @brief A read-only view of the elements of a typed asset
+ *
+ * The view points straight at the linked asset, so it is valid for the whole program and never copies.
+ */
+template <typename T> class AssetSpan {
+    public:
+        /**
+         * @brief Construct a new, empty Asset Span object
+         *
+         */
+        AssetSpan() = default;
+
+        /**
+         * @brief Construct a new Asset Span object
+         *
+         * @param data the first element
+         * @param count number of elements
+         */
+        AssetSpan(const T* data, size_t count)
+            : elements(data),
+              count(count) {}
+
+        const T* begin() const { return elements; }
+
+        const T* end() const { return elements + count; }
+
+        const T* data() const { return elements; }
+
+        size_t size() const { return count; }
+
+        bool empty() const { return count == 0; }
+
+        const T& operator[](size_t index) const { return elements[index]; }
+    private:
+        const T* elements = nullptr;
+        size_t count = 0;
+};
+
+/**
+ * @brief The start of a compressed asset
+ *
+ * The header is followed by compressedSize bytes of LZ4 block data, which decompress to rawSize bytes of any asset,
+ * typed or text. Make compressed assets with host/build/asset --compress.
+ *
+ * @param magic "LZ4B"
+ * @param rawSize size of the asset once decompressed, in bytes
+ * @param compressedSize size of the compressed data, in bytes
+ */
+struct CompressedAssetHeader {
+        char magic[4];
+        uint32_t rawSize;
+        uint32_t compressedSize;
+};
+
+/**
+ * @brief Decompress a block of LZ4 data
+ *
+ * @param data the compressed data
+ * @param size size of the compressed data, in bytes
+ * @param out where to write the decompressed data
+ * @param capacity room in out, in bytes
+ * @return size_t number of bytes written, or 0 if the data is corrupt or doesn't fit
+ */
+size_t lz4Decompress(const uint8_t* data, size_t size, uint8_t* out, size_t capacity);
+
+/**
+ * @brief How long an asset took to decompress
+ *
+ * @param name the name passed to ASSET()
+ * @param compressedSize size of the asset in the program, in bytes
+ * @param rawSize size of the asset once decompressed, in bytes
+ * @param time time taken to decompress, in microseconds
+ * @param ok whether the asset decompressed. If not, it is left compressed
+ */
+struct AssetLoad {
+        const char* name;
+        size_t compressedSize;
+        size_t rawSize;
+        uint32_t time;
+        bool ok;
+};
+
+/**
+ * @brief Registers an asset declared with ASSET(), so it can be decompressed by decompressAssets()
+ *
+ */
+class AssetRegistration {
+    public:
+        /**
+         * @brief Register the asset if it is compressed
+         *
+         * @param file the asset
+         * @param name the name of the asset
+         */
+        AssetRegistration(asset& file, const char* name);
+};
+
+/**
+ * @brief Decompress every compressed asset into one arena, so they can be used like any other asset
+ *
+ * The arena is allocated once, with room for every asset, and each asset is aligned to 16 bytes so typed assets can
+ * still be used in place. Each asset then points at its decompressed bytes. Call this once, at the start of
+ * initialize(), before the assets are used. The load time of each asset is logged.
+ *
+ * @return std::vector<AssetLoad> the load time of each compressed asset
+ */
+std::vector<AssetLoad> decompressAssets();
+
+/**
+ * @brief Get the header of a typed asset
+ *
+ * @param file the asset
+ * @return const AssetHeader* nullptr if the asset isn't a typed asset this build can read, like a text asset
+ */
+const AssetHeader* assetHeader(const asset& file);
+
+/**
+ * @brief Check that a typed asset holds the given type of element, and find its elements
+ *
+ * Logs an error if the asset is typed but doesn't match, or can't be read by this build. Untyped assets, like text
+ * paths, just return nullptr without logging.
+ *
+ * @param file the asset
+ * @param type the type of element expected
+ * @param elementSize size of each element expected, in bytes
+ * @param alignment alignment the elements need, in bytes
+ * @return const void* the first element, or nullptr if the asset doesn't match
+ */
+const void* assetElements(const asset& file, AssetType type, size_t elementSize, size_t alignment);
+
+/**
+ * @brief Get a view of the elements of a typed asset, without copying them
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * ASSET(curve_bin);
+ *
+ * lemlib::AssetSpan<float> curve = lemlib::assetView<float>(curve_bin);
+ * for (float value : curve) printf("%f\n", value);
+ * @endcode
+ *
+ * @param file the asset
+ * @return AssetSpan<T> empty if the asset isn't a typed asset holding elements of type T
+ */
+template <typename T> AssetSpan<T> assetView(const asset& file) {
+    const void* elements = assetElements(file, AssetTypeOf<T>::value, sizeof(T), alignof(T));
+    if (elements == nullptr) return {};
+    return {static_cast<const T*>(elements), assetHeader(file)->count};
+}
+} // namespace lemlib
+
+/**
+ * @brief Use a file in static/ as an asset named x, with '.' in the file name replaced by '_'
+ *
+ * Compressed assets are decompressed by lemlib::decompressAssets().
+ */
 #define ASSET(x)                                                                                                       \
     extern "C" {                                                                                                       \
     extern uint8_t _binary_static_##x##_start[], _binary_static_##x##_size[];                                          \
     static asset x = {_binary_static_##x##_start, (size_t)_binary_static_##x##_size};                                  \
-    }
+    }                                                                                                                  \
+    static lemlib::AssetRegistration x##_registration(x, #x);
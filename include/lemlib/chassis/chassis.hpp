@@ -20,6 +20,7 @@
 #include "lemlib/pose.hpp"
 #include "lemlib/pid.hpp"
 #include "lemlib/exitcondition.hpp"
+#include "lemlib/relayTuner.hpp"
 
 namespace lemlib {
 /**
@@ -145,6 +146,50 @@ struct MoveToPoseParams {
         float earlyExitRange = 0;
 };
 
+/**
+ * @brief The kinds of motion the chassis can run
+ *
+ */
+enum class MotionType { TURN_TO, MOVE_TO_POSE, MOVE_TO_POINT, FOLLOW };
+
+/**
+ * @brief How a motion ended
+ *
+ * EXITED is a motion that stopped before settling on purpose, like a moveToPose with a minSpeed passing its target,
+ * or a follow ended by the competition state changing.
+ */
+enum class MotionResult { SETTLED, TIMEOUT, CANCELLED, EXITED };
+
+/**
+ * @brief Record of a finished motion, passed to the motion observer
+ *
+ * @param type the kind of motion
+ * @param target the target of the motion. theta is the target heading in degrees for moveToPose, and 0 otherwise.
+ *  For follow, the last point of the path
+ * @param forwards whether the motion was driven forwards
+ * @param timeout the timeout of the motion, in milliseconds
+ * @param start when the motion started, in milliseconds
+ * @param end when the motion ended, in milliseconds
+ * @param result how the motion ended
+ * @param pose pose of the robot when the motion ended, with theta in degrees
+ */
+struct MotionRecord {
+        MotionType type;
+        Pose target;
+        bool forwards;
+        int timeout;
+        uint32_t start;
+        uint32_t end;
+        MotionResult result;
+        Pose pose;
+};
+
+/**
+ * @brief Function type for motion observers
+ *
+ */
+typedef std::function<void(const MotionRecord&)> MotionObserver_t;
+
 /**
  * @brief Function pointer type for drive curve functions.
  * @param input The control input in the range [-127, 127].
@@ -263,7 +308,8 @@ class Chassis {
         /**
          * @brief Move the chassis along a path
          *
-         * @param path the path asset to follow
+         * @param path the path asset to follow. Either a text path, or a typed asset of PATH_POINT made with
+         * host/build/asset, which is used without parsing
          * @param lookahead the lookahead distance. Units in inches. Larger values will make the robot move
          * faster but will follow the path less accurately
          * @param timeout the maximum time the robot can spend moving
@@ -303,6 +349,28 @@ class Chassis {
          * curve, refer to the `defaultDriveCurve` documentation.
          */
         void curvature(int throttle, int turn, float cureGain = 0.0);
+        /**
+         * @brief Tune the angular controller with a relay feedback experiment
+         *
+         * The robot oscillates back and forth around its current heading until enough oscillations have been
+         * measured. The ultimate gain and period are used to propose gains and exit conditions for the angular
+         * controller, which are logged to the info sink. This function is blocking.
+         *
+         * @param settings settings for the experiment. Error units are in degrees
+         * @return AutotuneResult the proposed settings
+         */
+        AutotuneResult autotuneAngular(AutotuneSettings settings = {});
+        /**
+         * @brief Tune the lateral controller with a relay feedback experiment
+         *
+         * The robot drives back and forth around its current position until enough oscillations have been measured.
+         * The ultimate gain and period are used to propose gains and exit conditions for the lateral controller,
+         * which are logged to the info sink. This function is blocking.
+         *
+         * @param settings settings for the experiment. Error units are in inches
+         * @return AutotuneResult the proposed settings
+         */
+        AutotuneResult autotuneLateral(AutotuneSettings settings = {});
         /**
          * @brief Cancels the currently running motion.
          * If there is a queued motion, then that queued motion will run.
@@ -317,6 +385,15 @@ class Chassis {
          * @return whether a motion is currently running
          */
         bool isInMotion() const;
+        /**
+         * @brief Set a function to be called whenever a motion ends
+         *
+         * The observer is called from the task that ran the motion, right before the drivetrain is stopped, so it
+         * should return quickly. Useful for timing routines and logging how each motion ended.
+         *
+         * @param observer the function to call. nullptr to stop observing
+         */
+        void setMotionObserver(MotionObserver_t observer);
     protected:
         /**
          * @brief Indicates that this motion is queued and blocks current task until this motion reaches front of queue
@@ -327,6 +404,27 @@ class Chassis {
          */
         void endMotion();
     private:
+        /**
+         * @brief Run a relay feedback experiment on one of the chassis controllers
+         *
+         * @param settings settings for the experiment
+         * @param angular true to tune the angular controller, false to tune the lateral controller
+         * @return AutotuneResult the proposed settings
+         */
+        AutotuneResult relayExperiment(AutotuneSettings settings, bool angular);
+        /**
+         * @brief Pass the record of a finished motion to the motion observer, if there is one
+         *
+         * @param type the kind of motion
+         * @param target the target of the motion
+         * @param forwards whether the motion was driven forwards
+         * @param timeout the timeout of the motion, in milliseconds
+         * @param start when the motion started, in milliseconds
+         * @param result how the motion ended
+         */
+        void reportMotion(MotionType type, Pose target, bool forwards, int timeout, uint32_t start,
+                          MotionResult result);
+
         bool motionRunning = false;
         bool motionQueued = false;
 
@@ -338,6 +436,7 @@ class Chassis {
         Drivetrain drivetrain;
         OdomSensors sensors;
         DriveCurveFunction_t driveCurve;
+        MotionObserver_t motionObserver;
 
         PID lateralPID;
         PID angularPID;
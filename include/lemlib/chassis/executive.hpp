@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+
+namespace lemlib {
+/**
+ * @brief The stages of a control executive tick, in the order they run
+ *
+ */
+enum class Stage { SENSORS, ODOMETRY, CONTROLLER, MOTOR_OUTPUT };
+
+/**
+ * @brief Timing of a single executive stage, in microseconds
+ *
+ */
+struct StageTiming {
+        /** duration of the stage on the last tick */
+        uint32_t last = 0;
+        /** longest duration of the stage */
+        uint32_t max = 0;
+        /** sum of the durations of the stage, for calculating the mean */
+        uint64_t total = 0;
+};
+
+/**
+ * @brief Timing statistics of the control executive
+ *
+ */
+struct ExecutiveStats {
+        /** timing of each stage, indexed by Stage */
+        StageTiming stages[4];
+        /** number of ticks run */
+        uint32_t ticks = 0;
+        /** number of ticks that took longer than the period, or started late */
+        uint32_t deadlineMisses = 0;
+        /** number of ticks where the active controller didn't finish in time */
+        uint32_t controllerMisses = 0;
+};
+
+/**
+ * @brief Start the control executive
+ *
+ * The control executive replaces the odometry task and the free-running motion loops with a single task that runs
+ * sensor sampling, odometry, the active motion controller, and motor output in that order, every period. This means
+ * the pose a controller uses is never stale, and motor output is sent at a fixed phase.
+ *
+ * Should be called after Chassis::calibrate. Calling it more than once does nothing, and so does calling it with a
+ * clock that doesn't support background tasks.
+ *
+ * @param period how often the executive runs, in milliseconds. 10 by default
+ */
+void startExecutive(uint32_t period = 10);
+
+/**
+ * @brief Whether the control executive is running
+ *
+ * @return true the executive is running
+ * @return false the executive is not running
+ */
+bool executiveRunning();
+
+/**
+ * @brief Get the timing statistics of the control executive
+ *
+ * @return ExecutiveStats
+ */
+ExecutiveStats getExecutiveStats();
+
+/**
+ * @brief Reset the timing statistics of the control executive
+ *
+ */
+void resetExecutiveStats();
+
+/**
+ * @brief Finish an iteration of a motion controller
+ *
+ * Motions call this at the end of every iteration of their loop. If the executive is running, this hands the
+ * queued output to the executive and blocks until odometry has been updated on the next tick. Otherwise, it just
+ * waits 10ms.
+ */
+void syncController();
+
+/**
+ * @brief Stop the calling task from being synchronized with the executive
+ *
+ * Motions call this when they finish, so the executive doesn't wait for a controller that isn't running.
+ */
+void releaseController();
+} // namespace lemlib
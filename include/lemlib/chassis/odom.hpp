@@ -59,9 +59,21 @@ Pose getLocalSpeed(bool radians = false);
  * @return lemlib::Pose
  */
 Pose estimatePose(float time, bool radians = false);
+/**
+ * @brief Sample the odometry sensors
+ *
+ * The readings are stored until the next call to integrate()
+ */
+void sampleSensors();
+/**
+ * @brief Update the pose of the robot using the last sensor sample
+ *
+ */
+void integrate();
 /**
  * @brief Update the pose of the robot
  *
+ * Equivalent to calling sampleSensors() then integrate()
  */
 void update();
 /**
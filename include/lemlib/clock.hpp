@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+namespace lemlib {
+/**
+ * @brief A source of time
+ *
+ * LemLib gets the time and waits through a clock instead of calling the RTOS directly. By default, the clock is
+ * backed by the RTOS, but it can be replaced with a simulated clock so motions can run faster than real time.
+ */
+class Clock {
+    public:
+        virtual ~Clock() = default;
+
+        /**
+         * @brief Get the current time
+         *
+         * @return uint32_t time in milliseconds
+         */
+        virtual uint32_t millis() = 0;
+
+        /**
+         * @brief Get the current time
+         *
+         * @return uint64_t time in microseconds
+         */
+        virtual uint64_t micros() = 0;
+
+        /**
+         * @brief Wait for an amount of time
+         *
+         * @param ms time to wait in milliseconds
+         */
+        virtual void delay(uint32_t ms) = 0;
+
+        /**
+         * @brief Wait until a fixed amount of time after the last wake up
+         *
+         * @param prevTime the time the caller last woke up, in milliseconds. Updated to the new wake up time
+         * @param delta the period, in milliseconds
+         */
+        virtual void delayUntil(uint32_t* prevTime, uint32_t delta) = 0;
+
+        /**
+         * @brief Whether background tasks can use this clock
+         *
+         * If not, LemLib won't start the odometry task or the control executive, and async motions run
+         * synchronously.
+         *
+         * @return true background tasks can use this clock
+         * @return false only one task can use this clock
+         */
+        virtual bool supportsTasks() { return true; }
+};
+
+/**
+ * @brief Clock backed by the RTOS
+ *
+ */
+class RtosClock : public Clock {
+    public:
+        uint32_t millis() override;
+        uint64_t micros() override;
+        void delay(uint32_t ms) override;
+        void delayUntil(uint32_t* prevTime, uint32_t delta) override;
+};
+
+/**
+ * @brief Deterministic simulated clock
+ *
+ * Time only moves when the clock is told to wait, and it moves instantly. Every time it moves by one step, the step
+ * callback is called, which is where a simulation updates the robot and odometry.
+ *
+ * The simulated clock can only be used from a single task, so odometry has to be updated in the step callback, and
+ * async motions run synchronously.
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * lemlib::SimulatedClock simClock;
+ * simClock.onStep([](uint32_t time) {
+ *     robot.step(0.001); // update the simulated robot
+ *     if (time % 10 == 0) lemlib::update(); // update odometry every 10ms
+ * });
+ * lemlib::setClock(simClock);
+ * // runs in a few milliseconds
+ * chassis.moveToPoint(0, 24, 2000);
+ * @endcode
+ */
+class SimulatedClock : public Clock {
+    public:
+        /**
+         * @brief Construct a new Simulated Clock
+         *
+         * @param step how far time moves on every step, in microseconds. 1000 by default
+         */
+        SimulatedClock(uint32_t step = 1000);
+
+        uint32_t millis() override;
+        uint64_t micros() override;
+        void delay(uint32_t ms) override;
+        void delayUntil(uint32_t* prevTime, uint32_t delta) override;
+        bool supportsTasks() override;
+
+        /**
+         * @brief Move time forwards
+         *
+         * @param us how far to move time, in microseconds
+         */
+        void advance(uint64_t us);
+
+        /**
+         * @brief Set the function called every time the clock moves one step
+         *
+         * @param callback function that takes the new time in milliseconds
+         */
+        void onStep(std::function<void(uint32_t)> callback);
+    private:
+        const uint32_t step;
+        uint64_t time = 0;
+        std::function<void(uint32_t)> stepCallback;
+};
+
+/**
+ * @brief Get the clock LemLib uses
+ *
+ * @return Clock&
+ */
+Clock& getClock();
+
+/**
+ * @brief Set the clock LemLib uses
+ *
+ * The clock must outlive every use of LemLib
+ *
+ * @param clock the new clock
+ */
+void setClock(Clock& clock);
+} // namespace lemlib
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <atomic>
+#include "pros/motors.hpp"
+#include "pros/rotation.hpp"
+#include "pros/rtos.hpp"
+#include "lemlib/pid.hpp"
+#include "lemlib/exitcondition.hpp"
+
+namespace lemlib {
+/**
+ * @brief Settings of a lift
+ *
+ * Angles are degrees of the arm, and gains are in the same units as ControllerSettings: power from -127 to 127, updated
+ * every 10ms.
+ *
+ * The arm can rise with either sign of power, as long as positive power makes the measured angle increase. When
+ * positive power lowers the arm, kG is negative, so the gravity feedforward still pushes the arm up.
+ *
+ * @param kP proportional gain, in power per degree of error from the profile
+ * @param kI integral gain
+ * @param kD derivative gain
+ * @param windupRange error below which the integral is kept. 0 by default
+ * @param kG power that holds the arm still when it is horizontal. Scaled by the cosine of the arm's angle from
+ *  horizontalAngle, so it is 0 when the arm is vertical. Measure it by holding the arm horizontal and raising the power
+ *  until the arm just stays up when let go. 0 by default, which turns the feedforward off
+ * @param kV power per degree per second of the profile's velocity. 0 by default
+ * @param maxVelocity fastest the profile moves the arm, in degrees per second. 180 by default
+ * @param maxAcceleration fastest the profile speeds up or slows down, in degrees per second squared. 720 by default
+ * @param settleRange how close to the target the arm has to be to settle, in degrees. 2 by default
+ * @param settleTime how long the arm has to stay in range to settle, in milliseconds. 100 by default
+ * @param horizontalAngle measured angle of the arm when it is horizontal. 0 by default
+ * @param gearRatio degrees the rotation sensor turns per degree of the arm, or degrees the motor turns without a
+ *  rotation sensor. 1 by default, when the sensor is on the arm's axle
+ */
+struct LiftSettings {
+        float kP = 0;
+        float kI = 0;
+        float kD = 0;
+        float windupRange = 0;
+        float kG = 0;
+        float kV = 0;
+        float maxVelocity = 180;
+        float maxAcceleration = 720;
+        float settleRange = 2;
+        int settleTime = 100;
+        float horizontalAngle = 0;
+        float gearRatio = 1;
+};
+
+/**
+ * @brief An arm driven by a motor, and measured with a rotation sensor or the motor's encoder, that holds itself at
+ * a target
+ *
+ * A background task moves a setpoint to the target along a trapezoidal motion profile, then holds it there, running
+ * a PID on the error from the setpoint plus feedforward for gravity and the profile's velocity. Setting a target
+ * returns straight away, so the arm moves while the robot drives. Output goes through the output stage, like the
+ * chassis.
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * pros::Motor liftMotor(2);
+ * pros::Rotation liftSensor(6);
+ * lemlib::Lift lift(&liftMotor, &liftSensor, {.kP = 4, .kD = 10, .kG = 8});
+ *
+ * lift.setTarget(90);
+ * chassis.moveToPoint(0, 24, 1000);
+ * lift.waitUntilSettled();
+ * @endcode
+ */
+class Lift {
+    public:
+        /**
+         * @brief Construct a new Lift
+         *
+         * The background task starts the first time a target is set, so lifts can be global.
+         *
+         * @param motor the motor that drives the arm
+         * @param sensor the rotation sensor that measures the arm. Its position should increase when the motor is
+         *  given positive power, whichever way that moves the arm. nullptr to measure the arm with the motor's
+         *  encoder, in degrees, which always does. Only reset the encoder while the lift is stopped
+         * @param settings the gains and limits of the lift
+         */
+        Lift(pros::Motor* motor, pros::Rotation* sensor, LiftSettings settings);
+
+        /**
+         * @brief Move the arm to an angle, and hold it there. Returns straight away
+         *
+         * If the arm is already moving, the profile carries on from where it is, so targets can be changed at any time.
+         * With a clock that doesn't support tasks, the arm only moves during waitUntilSettled().
+         *
+         * @param angle the target, in degrees of the arm
+         */
+        void setTarget(float angle);
+
+        /**
+         * @brief Get the target
+         *
+         * @return float degrees of the arm
+         */
+        float getTarget();
+
+        /**
+         * @brief Get the angle of the arm
+         *
+         * @return float degrees of the arm
+         */
+        float getAngle();
+
+        /**
+         * @brief Whether the arm has reached its target and stayed there for the settle time
+         *
+         * @return true the arm has settled, or isn't being controlled
+         */
+        bool isSettled();
+
+        /**
+         * @brief Wait until the arm has settled
+         *
+         * @param timeout longest time to wait, in milliseconds. 2000 by default
+         * @return true the arm settled before the timeout
+         */
+        bool waitUntilSettled(int timeout = 2000);
+
+        /**
+         * @brief Stop controlling the arm, so the motor can be commanded directly
+         *
+         * The motor is sent 0 power, so it does whatever its brake mode does. Setting a target starts controlling the
+         * arm again.
+         */
+        void stop();
+
+        /**
+         * @brief Stop controlling the arm, and drive the motor at a voltage
+         *
+         * Goes through the output stage like the lift's own output, so it can't be overwritten by output the lift
+         * queued before it stopped. Use this instead of commanding the motor directly.
+         *
+         * @param voltage the voltage, from -12000 to 12000 millivolts
+         */
+        void setVoltage(int voltage);
+
+        /**
+         * @brief Stop controlling the arm, and drive the motor at a velocity
+         *
+         * Goes through the output stage like setVoltage().
+         *
+         * @param velocity the velocity, in rpm. Limited to the motor's gearset
+         */
+        void setVelocity(int velocity);
+    private:
+        /**
+         * @brief Run one iteration of the controller
+         *
+         */
+        void update();
+
+        /**
+         * @brief The function run by the lift's task
+         *
+         */
+        void taskLoop();
+
+        pros::Motor* const motor;
+        pros::Rotation* const sensor;
+        const LiftSettings settings;
+        PID pid;
+        ExitCondition exit;
+
+        float target = 0;
+        // the point of the motion profile the arm is following
+        float profileAngle = 0;
+        float profileVelocity = 0;
+        std::atomic<bool> running = false;
+        std::atomic<bool> settled = true;
+
+        // protects the target and the profile
+        pros::Mutex mutex;
+        pros::Task* task = nullptr;
+};
+} // namespace lemlib
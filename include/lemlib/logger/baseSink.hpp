@@ -1,6 +1,7 @@
 #pragma once
 
 #include <initializer_list>
+#include <vector>
 #include "pros/rtos.hpp"
 
 #define FMT_HEADER_ONLY
@@ -8,6 +9,10 @@
 #include "fmt/args.h"
 
 #include "lemlib/logger/message.hpp"
+#include "lemlib/logger/deferred.hpp"
+#include "lemlib/logger/stdout.hpp"
+#include "lemlib/clock.hpp"
+#include "lemlib/profiler.hpp"
 
 namespace lemlib {
 /**
@@ -40,16 +45,53 @@ class BaseSink {
          * apply for all the parent sinks.
          * @param level
          *
-         * If messages are logged that are below the lowest level, they will be ignored.
-         * The hierarchy of the levels is as follows:
-         * - INFO
+         * If messages are logged that are below the lowest level, they will be ignored. The lowest level is DEBUG by
+         * default, so every message is logged.
+         * The hierarchy of the levels, from the lowest, is as follows:
          * - DEBUG
+         * - INFO
          * - WARN
          * - ERROR
          * - FATAL
          */
         void setLowestLevel(Level level);
 
+        /**
+         * @brief Set whether messages are formatted by the logger's task instead of the caller
+         * If this is a combined sink, this operation will
+         * apply for all the parent sinks.
+         *
+         * @param deferred whether to defer formatting. false by default
+         *
+         * When deferred, logging a message only copies the format string and the arguments into the stdout buffer's
+         * queue, and the buffer's task formats the message and sends it to the sink. This makes logging from a control
+         * loop cost a small copy instead of several allocations and two formatting passes. Messages with arguments
+         * that can't be copied safely, like strings, or that are too big, are still formatted by the caller, so they can
+         * be printed before deferred messages that were logged earlier. Each message keeps the time it was logged.
+         *
+         * The format string has to outlive the message, which string literals always do, and the sink has to outlive
+         * the stdout buffer.
+         */
+        void setDeferred(bool deferred);
+
+        /**
+         * @brief Check whether a message at the given level would be logged
+         * If this is a combined sink, this is true if any of the parent sinks would log it.
+         *
+         * Use it to skip expensive work that only feeds a log message. The logging macros, like LEMLIB_DEBUG, check it
+         * before evaluating any of their arguments.
+         *
+         * @param level
+         */
+        bool shouldLog(Level level) const {
+            if (level < MIN_LOG_LEVEL) return false;
+            if (sinks.empty()) return level >= lowestLevel;
+            for (const std::shared_ptr<BaseSink>& sink : sinks) {
+                if (sink->shouldLog(level)) return true;
+            }
+            return false;
+        }
+
         /**
          * @brief Log a message at the given level
          * If this is a combined sink, this operation will
@@ -67,28 +109,29 @@ class BaseSink {
 
          */
         template <typename... T> void log(Level level, fmt::format_string<T...> format, T&&... args) {
+            if (!shouldLog(level)) return;
             if (!sinks.empty()) {
                 for (std::shared_ptr<BaseSink> sink : sinks) { sink->log(level, format, std::forward<T>(args)...); }
                 return;
             }
 
-            if (level < lowestLevel) { return; }
-
-            // substitute the user's arguments into the format.
-            std::string messageString = fmt::format(format, std::forward<T>(args)...);
-
-            Message message = Message {.level = level, .time = pros::millis()};
-
-            // get the arguments
-            fmt::dynamic_format_arg_store<fmt::format_context> formattingArgs = getExtraFormattingArgs(message);
-
-            formattingArgs.push_back(fmt::arg("time", message.time));
-            formattingArgs.push_back(fmt::arg("level", message.level));
-            formattingArgs.push_back(fmt::arg("message", messageString));
+            // copy the arguments and let the logger's task format them, if it is safe to
+            if constexpr ((isDeferrable<std::decay_t<T>> && ...) &&
+                          sizeof(DeferredRecord<std::decay_t<T>...>) <= MAX_MESSAGE_SIZE) {
+                if (deferred) {
+                    const DeferredRecord<std::decay_t<T>...> record {this, level, getClock().millis(), format.get(),
+                                                                     makeDeferredArgs(args...)};
+                    bufferedStdout().pushDeferred(&sendDeferred<std::decay_t<T>...>, &record, sizeof(record));
+                    return;
+                }
+            }
 
-            std::string formattedString = fmt::vformat(logFormat, std::move(formattingArgs));
-            message.message = std::move(formattedString);
-            sendMessage(std::move(message));
+            LEMLIB_PROFILE("logger.format");
+            // substitute the user's arguments into the format. The buffer is on the stack, so short messages don't
+            // allocate
+            fmt::memory_buffer messageString;
+            fmt::format_to(fmt::appender(messageString), format, std::forward<T>(args)...);
+            sendFormatted(level, getClock().millis(), fmt::string_view(messageString.data(), messageString.size()));
         }
 
         /**
@@ -100,7 +143,7 @@ class BaseSink {
          * @param args
          */
         template <typename... T> void debug(fmt::format_string<T...> format, T&&... args) {
-            log(Level::DEBUG, format, std::forward<T>(args)...);
+            if constexpr (Level::DEBUG >= MIN_LOG_LEVEL) log(Level::DEBUG, format, std::forward<T>(args)...);
         }
 
         /**
@@ -112,7 +155,7 @@ class BaseSink {
          * @param args
          */
         template <typename... T> void info(fmt::format_string<T...> format, T&&... args) {
-            log(Level::INFO, format, std::forward<T>(args)...);
+            if constexpr (Level::INFO >= MIN_LOG_LEVEL) log(Level::INFO, format, std::forward<T>(args)...);
         }
 
         /**
@@ -124,7 +167,7 @@ class BaseSink {
          * @param args
          */
         template <typename... T> void warn(fmt::format_string<T...> format, T&&... args) {
-            log(Level::WARN, format, std::forward<T>(args)...);
+            if constexpr (Level::WARN >= MIN_LOG_LEVEL) log(Level::WARN, format, std::forward<T>(args)...);
         }
 
         /**
@@ -136,7 +179,7 @@ class BaseSink {
          * @param args
          */
         template <typename... T> void error(fmt::format_string<T...> format, T&&... args) {
-            log(Level::ERROR, format, std::forward<T>(args)...);
+            if constexpr (Level::ERROR >= MIN_LOG_LEVEL) log(Level::ERROR, format, std::forward<T>(args)...);
         }
 
         /**
@@ -148,7 +191,7 @@ class BaseSink {
          * @param args
          */
         template <typename... T> void fatal(fmt::format_string<T...> format, T&&... args) {
-            log(Level::FATAL, format, std::forward<T>(args)...);
+            if constexpr (Level::FATAL >= MIN_LOG_LEVEL) log(Level::FATAL, format, std::forward<T>(args)...);
         }
     protected:
         /**
@@ -163,6 +206,9 @@ class BaseSink {
          *
          * @param format
          *
+         * The format is parsed once here. Formats that only use the fields below without format specs are then filled
+         * in directly for each message; other formats go through fmt with getExtraFormattingArgs, which is slower.
+         *
          * Changing the format of the sink changes the way each logged message looks. The following named formatting
          * specifiers can be used:
          * - {time} The time the message was sent in milliseconds since the program started.
@@ -201,8 +247,54 @@ class BaseSink {
          */
         virtual fmt::dynamic_format_arg_store<fmt::format_context> getExtraFormattingArgs(const Message& messageInfo);
     private:
+        /**
+         * @brief A message waiting to be formatted by the logger's task
+         *
+         */
+        template <typename... T> struct DeferredRecord {
+                BaseSink* sink;
+                Level level;
+                uint32_t time;
+                fmt::string_view format;
+                DeferredArgs<T...> args;
+        };
+
+        /**
+         * @brief Format a deferred message and send it. Runs on the logger's task
+         *
+         * @param data the DeferredRecord
+         */
+        template <typename... T> static void sendDeferred(const void* data) {
+            const DeferredRecord<T...>& record = *static_cast<const DeferredRecord<T...>*>(data);
+            fmt::memory_buffer messageString;
+            formatDeferred(messageString, record.format, record.args);
+            record.sink->sendFormatted(record.level, record.time,
+                                       fmt::string_view(messageString.data(), messageString.size()));
+        }
+
+        /**
+         * @brief Substitute a formatted message into the sink's format, and send it
+         *
+         * @param level the level of the message
+         * @param time when the message was logged, in milliseconds
+         * @param messageString the message
+         */
+        void sendFormatted(Level level, uint32_t time, fmt::string_view messageString);
+
+        /**
+         * @brief A piece of a parsed format: either literal text, or one of the standard fields
+         *
+         */
+        struct FormatSegment {
+                enum class Field { LITERAL, TIME, LEVEL, MESSAGE } field;
+                std::string literal;
+        };
+
         Level lowestLevel = Level::DEBUG;
+        bool deferred = false;
         std::string logFormat;
+        // logFormat parsed by setFormat. Empty if the format uses extra arguments or format specs, which need fmt
+        std::vector<FormatSegment> segments;
 
         std::vector<std::shared_ptr<BaseSink>> sinks {};
 };
@@ -1,29 +1,80 @@
 #pragma once
 
-#include <deque>
+#include <atomic>
+#include <cstddef>
 #include <functional>
+#include <memory>
 #include <string>
+#include <string_view>
 
 #include "pros/rtos.hpp"
 
 namespace lemlib {
+/**
+ * @brief What a full buffer does with a new string
+ *
+ */
+enum class OverflowPolicy {
+    DROP_NEWEST, /** discard the new string */
+    DROP_OLDEST /** discard the oldest queued string to make room for the new one */
+};
+
+/**
+ * @brief Longest string a buffer can queue, in bytes. Longer strings are truncated
+ *
+ */
+constexpr size_t MAX_MESSAGE_SIZE = 256;
+
+/**
+ * @brief A function the buffer's task runs with a copy of the data that was pushed with it
+ *
+ */
+using DeferredFunc = void (*)(const void* data);
+
+/**
+ * @brief Counters of what has gone through a buffer
+ *
+ * @param pushed strings pushed, including dropped ones
+ * @param dropped strings discarded because the buffer was full
+ * @param truncated strings cut short because they were longer than MAX_MESSAGE_SIZE
+ * @param writes number of times the buffer function was called
+ * @param peak most strings ever queued at once
+ */
+struct BufferStats {
+        uint32_t pushed;
+        uint32_t dropped;
+        uint32_t truncated;
+        uint32_t writes;
+        uint32_t peak;
+};
+
 /**
  * @brief A buffer implementation
  *
- * Asynchronously processes a backlog of strings at a given rate. The strings are processed in a first in last out
- * order.
+ * Asynchronously processes a backlog of strings. The buffer's task sleeps until a string is pushed, then passes
+ * everything queued to the buffer function as one string, and waits at least the rate before writing again, so
+ * messages that arrive in the meantime are written together. The strings are processed in a first in first out order.
+ * The queue holds a fixed number of strings; when it is full, the overflow policy decides which string is dropped.
+ *
+ * The queue is a lock-free ring of preallocated slots, so pushing never allocates, never takes a mutex and never waits
+ * for the output, no matter which task it is called from. Any number of tasks can push at once.
  */
 class Buffer {
     public:
         /**
          * @brief Construct a new Buffer object
          *
+         * @param bufferFunc function that writes a batch of strings
+         * @param capacity most strings that can be queued, rounded up to a power of 2. 256 by default
+         * @param policy what to do with a string pushed to a full buffer. Drop the new string by default
          */
-        Buffer(std::function<void(const std::string&)> bufferFunc);
+        Buffer(std::function<void(const std::string&)> bufferFunc, size_t capacity = 256,
+               OverflowPolicy policy = OverflowPolicy::DROP_NEWEST);
 
         /**
          * @brief Destroy the Buffer object
          *
+         * Stops the buffer's task, then writes everything still queued
          */
         ~Buffer();
 
@@ -33,22 +84,70 @@ class Buffer {
         /**
          * @brief Push to the buffer
          *
+         * Wakes the buffer's task if it is waiting for a string
+         *
          * @param bufferData
          */
-        void pushToBuffer(const std::string& bufferData);
+        void pushToBuffer(std::string_view bufferData);
+
+        /**
+         * @brief Push a message between a prefix and a suffix to the buffer, as one string
+         *
+         * If the string would be longer than MAX_MESSAGE_SIZE, the message is cut short rather than the suffix, so
+         * framing like terminal escape codes and the newline is never lost.
+         *
+         * @param prefix what goes before the message
+         * @param message the message
+         * @param suffix what goes after the message
+         */
+        void pushFramed(std::string_view prefix, std::string_view message, std::string_view suffix);
+
+        /**
+         * @brief Push a function to be run by the buffer's task, in order with the strings around it
+         *
+         * The data is copied into the queue, so it must be trivially copyable. Whatever the function pushes to this
+         * buffer goes straight into the batch being written, in place of the function, so it keeps its order and is
+         * never dropped by the overflow policy. Lets callers hand expensive work, like formatting, to the buffer's
+         * task.
+         *
+         * @param func the function to run
+         * @param data the data to pass to the function
+         * @param size size of the data in bytes. Must be at most MAX_MESSAGE_SIZE
+         */
+        void pushDeferred(DeferredFunc func, const void* data, size_t size);
 
         /**
          * @brief Set the rate of the sink
          *
-         * @param rate
+         * @param rate minimum time between writes, in milliseconds
          */
         void setRate(uint32_t rate);
 
+        /**
+         * @brief Set what to do with a string pushed to a full buffer
+         *
+         * @param policy
+         */
+        void setOverflowPolicy(OverflowPolicy policy);
+
         /**
          * @brief Check to see if the internal buffer is empty
          *
          */
         bool buffersEmpty();
+
+        /**
+         * @brief Get the buffer's counters
+         *
+         * @return BufferStats
+         */
+        BufferStats getStats();
+
+        /**
+         * @brief Write everything queued now, from the calling task
+         *
+         */
+        void flush();
     private:
         /**
          * @brief The function that will be run inside of the buffer's task.
@@ -57,16 +156,94 @@ class Buffer {
         void taskLoop();
 
         /**
-         * @brief The function that will be applied to each string in the buffer when it is removed.
+         * @brief The function that will be applied to each batch of strings when it is removed from the buffer.
          *
          */
-        std::function<void(std::string)> bufferFunc;
+        std::function<void(const std::string&)> bufferFunc;
 
-        std::deque<std::string> buffer = {};
+        /**
+         * @brief A queued string, or a deferred function and its data
+         *
+         * The sequence number says whose turn it is: a producer can fill the slot when it equals the producer's
+         * position, and the slot is ready to read when it is one past it.
+         */
+        struct Slot {
+                std::atomic<uint32_t> sequence;
+                uint32_t size;
+                DeferredFunc func;
+                char data[MAX_MESSAGE_SIZE];
+        };
 
-        pros::Mutex mutex;
-        pros::Task task;
+        /**
+         * @brief A deferred function popped from the queue, with its data copied somewhere suitably aligned
+         *
+         */
+        struct DeferredCall {
+                DeferredFunc func;
+                alignas(std::max_align_t) char data[MAX_MESSAGE_SIZE];
+        };
 
-        uint32_t rate;
+        /**
+         * @brief Allocate the ring of slots, each with its sequence number set to its position
+         *
+         * Called from the constructor's initializer list, so the slots are ready before the task starts.
+         *
+         * @param size number of slots, a power of 2
+         */
+        static std::unique_ptr<Slot[]> makeSlots(uint32_t size);
+
+        /**
+         * @brief Queue a string or deferred function, following the overflow policy if the queue is full
+         *
+         */
+        void push(DeferredFunc func, const void* data, size_t size);
+
+        /**
+         * @brief Append a string to the batch instead of queueing it, if it was pushed by a deferred function that
+         * the calling task is running for flush()
+         *
+         * @return false if the string has to be queued
+         */
+        bool appendToBatch(const void* data, size_t size);
+
+        /**
+         * @brief Try to queue a string or deferred function
+         *
+         * @return false if the queue is full
+         */
+        bool tryPush(DeferredFunc func, const void* data, size_t size);
+
+        /**
+         * @brief Try to remove the oldest entry from the queue
+         *
+         * @param out where to append the entry if it is a string, or nullptr to discard it
+         * @param call where to copy the entry if it is a deferred function, or nullptr to discard it
+         * @return false if the queue is empty
+         */
+        bool tryPop(std::string* out, DeferredCall* call);
+
+        std::unique_ptr<Slot[]> slots;
+        const uint32_t mask;
+        std::atomic<uint32_t> enqueuePos = 0;
+        std::atomic<uint32_t> dequeuePos = 0;
+        std::atomic<bool> waiting = false;
+        std::atomic<OverflowPolicy> policy;
+
+        std::atomic<uint32_t> pushed = 0;
+        std::atomic<uint32_t> dropped = 0;
+        std::atomic<uint32_t> truncated = 0;
+        std::atomic<uint32_t> writes = 0;
+        std::atomic<uint32_t> peak = 0;
+
+        // the concatenated strings being written. Only used by the writer, which holds writeMutex
+        std::string batch;
+        // the writer, while it runs a deferred function
+        std::atomic<bool> draining = false;
+        std::atomic<pros::task_t> drainingTask = nullptr;
+        uint32_t rate = 0;
+
+        pros::Mutex writeMutex;
+        // declared last, so everything the task uses is initialized before it starts
+        pros::Task task;
 };
 } // namespace lemlib
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#define FMT_HEADER_ONLY
+#include "fmt/format.h"
+
+namespace lemlib {
+/**
+ * @brief Whether a logged argument can be copied now and formatted later
+ *
+ * The argument has to be trivially copyable, and can't point to memory the caller owns, since that memory may be gone
+ * by the time it is formatted. That rules out pointers, which includes C strings, and string views.
+ */
+template <typename T> constexpr bool isDeferrable =
+    std::is_trivially_copyable_v<T> && !std::is_pointer_v<T> && !std::is_same_v<T, std::string_view> &&
+    !std::is_same_v<T, fmt::string_view>;
+
+/**
+ * @brief Copies of the arguments of a deferred log message
+ *
+ * A plain aggregate instead of a std::tuple, so it is trivially copyable whenever the arguments are.
+ */
+template <typename... T> struct DeferredArgs {};
+
+template <typename Head, typename... Rest> struct DeferredArgs<Head, Rest...> {
+        Head head;
+        DeferredArgs<Rest...> rest;
+};
+
+/**
+ * @brief Copy the arguments of a log message
+ *
+ * @return DeferredArgs<T...>
+ */
+inline DeferredArgs<> makeDeferredArgs() { return {}; }
+
+template <typename Head, typename... Rest>
+DeferredArgs<Head, Rest...> makeDeferredArgs(const Head& head, const Rest&... rest) {
+    return {head, makeDeferredArgs(rest...)};
+}
+
+/**
+ * @brief Format the arguments of a deferred log message
+ *
+ * @param out where to write the message
+ * @param format the format the message was logged with
+ * @param args the copied arguments
+ * @param done the arguments unpacked so far
+ */
+template <typename... Done> void formatDeferred(fmt::memory_buffer& out, fmt::string_view format,
+                                                const DeferredArgs<>&, const Done&... done) {
+    fmt::vformat_to(fmt::appender(out), format, fmt::make_format_args(done...));
+}
+
+template <typename Head, typename... Rest, typename... Done>
+void formatDeferred(fmt::memory_buffer& out, fmt::string_view format, const DeferredArgs<Head, Rest...>& args,
+                    const Done&... done) {
+    formatDeferred(out, format, args.rest, done..., args.head);
+}
+} // namespace lemlib
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "pros/rtos.hpp"
+#include "lemlib/logger/baseSink.hpp"
+#include "lemlib/telemetry.hpp"
+
+namespace lemlib {
+/**
+ * @brief The start of a flight record file
+ *
+ * The header is followed by configSize bytes of configuration text, then telemetry frames, the same frames
+ * startBinaryTelemetry sends, until the end of the file. Multi-byte values are little endian.
+ *
+ * @param magic "LREC"
+ * @param version version of the file format
+ * @param configSize size of the configuration text, in bytes
+ * @param startTime when the file was opened, in milliseconds since the program started
+ * @param period time between samples, in milliseconds, or 0 if nothing is sampled
+ * @param records bit mask of the sampled record types, with bit n set for RecordType n
+ * @param bufferSize size of each of the recorder's buffers, in bytes
+ * @param build when the program was compiled
+ */
+struct FlightRecordHeader {
+        char magic[4];
+        uint16_t version;
+        uint16_t configSize;
+        uint32_t startTime;
+        uint32_t period;
+        uint32_t records;
+        uint32_t bufferSize;
+        char build[24];
+};
+
+/**
+ * @brief Sink that records log messages and sampled telemetry to a binary file on the SD card
+ *
+ * Records are appended to one of two preallocated buffers in RAM. When a buffer fills, or every flush interval, the
+ * buffers are swapped and a low priority task writes the full one to the file in one sequential write, so the tasks
+ * that log never wait on the SD card. If the SD card falls so far behind that both buffers are full, new records are
+ * dropped and counted.
+ *
+ * Each call to open() starts a new numbered file, like /usd/match_004.lrec, so every match gets its own file. The
+ * writer task closes the old file and creates the new one, so open() doesn't wait on the SD card either. Decode files
+ * on a computer with host/build/telemetry.
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * lemlib::FlightRecorderSink recorder;
+ * recorder.startSampling(10, {lemlib::RecordType::POSE, lemlib::RecordType::MOTION});
+ * recorder.open("lateral kP 10");
+ * recorder.warn("this message is written to the SD card");
+ * @endcode
+ */
+class FlightRecorderSink : public BaseSink {
+    public:
+        /**
+         * @brief Construct a new Flight Recorder Sink object
+         *
+         * @param bufferSize size of each of the two buffers, in bytes. 32 KiB by default
+         * @param flushInterval longest time a record waits in a buffer before it is written, in milliseconds. 1000 by
+         * default
+         */
+        FlightRecorderSink(size_t bufferSize = 32768, uint32_t flushInterval = 1000);
+
+        /**
+         * @brief Start a new file, closing the current one. Returns straight away
+         *
+         * The writer task writes what is buffered to the current file, then looks for the first free match number and
+         * creates the file. Records taken until then go to the current file. getPath() is empty until the new file is
+         * created, and stays empty if it couldn't be. With a clock that doesn't support tasks, the file is created
+         * before this returns.
+         *
+         * @param config text describing the configuration, like the robot's gains, to store in the header
+         * @param directory where to create the file. "/usd" by default
+         * @return false if every match number is taken, or the file couldn't be created without tasks
+         */
+        bool open(const std::string& config = "", const std::string& directory = "/usd");
+
+        /**
+         * @brief Write everything buffered and close the file
+         *
+         * Waits for the SD card, unlike open().
+         */
+        void close();
+
+        /**
+         * @brief Get the path of the current file
+         *
+         * @return std::string empty if no file is open
+         */
+        std::string getPath();
+
+        /**
+         * @brief Add a record to the file. Safe to call from any task
+         *
+         * Does nothing if no file is open.
+         *
+         * @param type the type of the record
+         * @param time when the record was taken, in milliseconds
+         * @param payload the record
+         * @param size size of the record in bytes. At most MAX_RECORD_SIZE
+         */
+        void record(RecordType type, uint32_t time, const void* payload, size_t size);
+
+        /**
+         * @brief Start a task that records the current value of some records every period
+         *
+         * Does nothing if sampling has already started, or if the clock doesn't support tasks.
+         *
+         * @param period time between samples, in milliseconds. 10 by default
+         * @param records the types of record to sample. Pose, motion state and controller outputs by default
+         */
+        void startSampling(uint32_t period = 10, std::vector<RecordType> records = {RecordType::POSE,
+                                                                                     RecordType::MOTION,
+                                                                                     RecordType::CONTROLLER});
+
+        /**
+         * @brief Get the number of records dropped because both buffers were full
+         *
+         * @return uint32_t
+         */
+        uint32_t getDropped();
+    protected:
+        /**
+         * @brief Record the given message as a TEXT record
+         *
+         * @param message
+         */
+        void sendMessage(const Message& message) override;
+    private:
+        /**
+         * @brief Create the next numbered file and start recording to it. Called with openMutex held
+         *
+         * @return true if the file was created
+         */
+        bool createFile(const std::string& config, const std::string& directory);
+
+        /**
+         * @brief Write everything buffered and close the file, if one is open. Called with openMutex held
+         *
+         */
+        void closeFile();
+
+        /**
+         * @brief Copy an encoded frame into the active buffer, swapping buffers if it is full
+         *
+         */
+        void append(const uint8_t* frame, size_t frameSize);
+
+        /**
+         * @brief Write the buffer waiting to be written, if there is one
+         *
+         */
+        void writePending();
+
+        /**
+         * @brief The function run by the writer task
+         *
+         */
+        void writerLoop();
+
+        const size_t bufferSize;
+        const uint32_t flushInterval;
+        std::unique_ptr<uint8_t[]> buffers[2];
+        size_t fill[2] = {0, 0};
+        // buffer records are appended to. The other one is written when pending is set
+        int active = 0;
+        bool pending = false;
+        uint32_t dropped = 0;
+
+        uint32_t period = 0;
+        std::vector<RecordType> sampled;
+
+        FILE* file = nullptr;
+        std::string path;
+        std::atomic<bool> recording = false;
+        // match numbers are 000 to 999
+        static constexpr int MAX_FILES = 1000;
+        // the first match number that might be free in numberedDirectory, so each open() only checks the files
+        // created since the last one
+        int nextNumber = 0;
+        std::string numberedDirectory;
+        // the file open() asked the writer to create
+        bool openRequested = false;
+        std::string requestedConfig;
+        std::string requestedDirectory;
+
+        // protects the buffers, the open request and the match number, and is only held for a copy. fileMutex is held
+        // while writing to the SD card, and openMutex while closing or creating a file, so a close() can't close a file
+        // as it is created
+        pros::Mutex mutex;
+        pros::Mutex fileMutex;
+        pros::Mutex openMutex;
+        pros::Task* writer = nullptr;
+        pros::Task* sampler = nullptr;
+};
+} // namespace lemlib
@@ -14,7 +14,7 @@ namespace lemlib {
  * information to the user's terminal.
  * <h3> Example Usage </h3>
  * @code
- * lemlib::infoSink()->setLowestLevel(lemlib::Level::INFO);
+ * lemlib::infoSink()->setLowestLevel(lemlib::Level::DEBUG);
  * lemlib::infoSink()->info("info: {}!", "my cool info here");
  * // Specify the order or placeholders
  * lemlib::infoSink()->debug("{1} {0}!","world", "hello");
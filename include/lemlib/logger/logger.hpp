@@ -9,18 +9,43 @@
 #include "lemlib/logger/baseSink.hpp"
 #include "lemlib/logger/infoSink.hpp"
 #include "lemlib/logger/telemetrySink.hpp"
+#include "lemlib/logger/flightRecorderSink.hpp"
 
 namespace lemlib {
 
 /**
  * @brief Get the info sink.
- * @return std::shared_ptr<InfoSink>
+ * @return const std::shared_ptr<InfoSink>&
  */
-std::shared_ptr<InfoSink> infoSink();
+const std::shared_ptr<InfoSink>& infoSink();
 
 /**
  * @brief Get the telemetry sink.
- * @return std::shared_ptr<TelemetrySink>
+ * @return const std::shared_ptr<TelemetrySink>&
  */
-std::shared_ptr<TelemetrySink> telemetrySink();
+const std::shared_ptr<TelemetrySink>& telemetrySink();
 } // namespace lemlib
+
+/**
+ * @brief Log a message to a sink, without evaluating the arguments unless the message will be logged
+ *
+ * Messages below LEMLIB_LOG_LEVEL are removed at compile time, and the sink's lowest level is checked before anything
+ * else is evaluated, so debug logging in a control loop costs nothing when it is filtered.
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * LEMLIB_DEBUG(lemlib::infoSink(), "lateral error: {:.2f}", computeError());
+ * @endcode
+ */
+#define LEMLIB_LOG(sink, level, ...)                                                                                   \
+    do {                                                                                                               \
+        if constexpr ((level) >= lemlib::MIN_LOG_LEVEL) {                                                              \
+            if ((sink)->shouldLog(level)) (sink)->log(level, __VA_ARGS__);                                             \
+        }                                                                                                              \
+    } while (0)
+
+#define LEMLIB_INFO(sink, ...) LEMLIB_LOG(sink, lemlib::Level::INFO, __VA_ARGS__)
+#define LEMLIB_DEBUG(sink, ...) LEMLIB_LOG(sink, lemlib::Level::DEBUG, __VA_ARGS__)
+#define LEMLIB_WARN(sink, ...) LEMLIB_LOG(sink, lemlib::Level::WARN, __VA_ARGS__)
+#define LEMLIB_ERROR(sink, ...) LEMLIB_LOG(sink, lemlib::Level::ERROR, __VA_ARGS__)
+#define LEMLIB_FATAL(sink, ...) LEMLIB_LOG(sink, lemlib::Level::FATAL, __VA_ARGS__)
@@ -4,10 +4,29 @@
 
 namespace lemlib {
 /**
- * @brief Level of the message
+ * @brief Level of the message, from the least to the most severe
  *
+ * Levels are compared by their number: DEBUG is 0, INFO 1, WARN 2, ERROR 3 and FATAL 4.
  */
-enum class Level { INFO, DEBUG, WARN, ERROR, FATAL };
+enum class Level { DEBUG, INFO, WARN, ERROR, FATAL };
+
+/**
+ * @brief The lowest level that is compiled in, as the number of a Level
+ *
+ * Messages below this level are removed at compile time by the logging macros, along with their arguments. 0 keeps
+ * everything, 1 removes debug messages, 2 only keeps warnings and errors, 3 only errors and 4 only fatal errors. Set
+ * it for competition builds with EXTRA_CXXFLAGS=-DLEMLIB_LOG_LEVEL=2 in the project Makefile. Everything is compiled
+ * in by default.
+ */
+#ifndef LEMLIB_LOG_LEVEL
+#define LEMLIB_LOG_LEVEL 0
+#endif
+
+/**
+ * @brief The lowest level that is compiled in
+ *
+ */
+constexpr Level MIN_LOG_LEVEL = static_cast<Level>(LEMLIB_LOG_LEVEL);
 
 /**
  * @brief A loggable message
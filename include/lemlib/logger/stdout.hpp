@@ -2,6 +2,7 @@
 
 #define FMT_HEADER_ONLY
 #include "fmt/core.h"
+#include <algorithm>
 
 #include "lemlib/logger/buffer.hpp"
 
@@ -9,9 +10,9 @@ namespace lemlib {
 /**
  * @brief Buffered printing to Stout.
  *
- * LemLib uses a buffered wrapper around stdout in order to guarantee that messages are printed at a constant
- * rate, no matter how many different threads are trying to use the logger. This is a concern  because not every type of
- * connection to the brain has the same amount of bandwidth.
+ * LemLib uses a buffered wrapper around stdout so that messages are printed in batches, at most once per rate, no
+ * matter how many different threads are trying to use the logger. This is a concern because not every type of
+ * connection to the brain has the same amount of bandwidth, and each write has a fixed cost.
  */
 class BufferedStdout : public Buffer {
     public:
@@ -20,9 +21,14 @@ class BufferedStdout : public Buffer {
         /**
          * @brief Print a string (thread-safe).
          *
+         * The string is formatted on the stack, so printing doesn't allocate. It is truncated to MAX_MESSAGE_SIZE
+         * bytes.
          */
         template <typename... T> void print(fmt::format_string<T...> format, T&&... args) {
-            pushToBuffer(fmt::format(format, std::forward<T>(args)...));
+            char text[MAX_MESSAGE_SIZE + 1];
+            // format one byte more than fits, so the buffer can tell the string was truncated
+            const auto result = fmt::format_to_n(text, sizeof(text), format, std::forward<T>(args)...);
+            pushToBuffer(std::string_view(text, std::min(result.size, sizeof(text))));
         }
 };
 
@@ -4,13 +4,17 @@
 
 namespace lemlib {
 /**
- * @brief Sink for sending telemetry data.
+ * @brief Sink for sending telemetry data as text. Kept for existing tools that read it
+ *
+ * This sink is used for sending data that is not meant to be viewed by the user, but will still be used by something
+ * else, like a data visualization tool. Messages sent through this sink are hidden with terminal escape codes, so they
+ * are not visible to the user.
+ *
+ * LemLib itself sends its telemetry through binary telemetry channels instead, see startBinaryTelemetry() and
+ * TelemetryChannel, which are smaller and can't be mixed up with log messages. If binary telemetry is running, text
+ * from this sink is written to stdout between the binary frames: host/build/telemetry skips it, but a tool that reads
+ * this sink has to skip the frames. New telemetry should use a channel.
  *
- * This is the primary way of interacting with the telemetry portion of LemLib's logging implementation. This sink is
- * used for sending data that is not meant to be viewed by the user, but will still be used by something else, like a
- * data visualization tool. Messages sent through this sink will not be cleared from the terminal and not be visible to
- * the user.
-
  * <h3> Example Usage </h3>
  * @code
  * lemlib::telemetrySink()->setLowestLevel(lemlib::Level::INFO);
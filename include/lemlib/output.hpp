@@ -0,0 +1,157 @@
+#pragma once
+
+#include <cstdint>
+#include "pros/motors.hpp"
+
+namespace lemlib {
+/**
+ * @brief How a motor is being commanded
+ *
+ */
+enum class OutputMode { NONE, VOLTAGE, VELOCITY };
+
+/**
+ * @brief A command sent to a motor
+ *
+ */
+struct OutputCommand {
+        /** how the motor is being commanded */
+        OutputMode mode = OutputMode::NONE;
+        /** the commanded value. Millivolts for VOLTAGE, rpm for VELOCITY */
+        int32_t value = 0;
+        /** when the command was last sent to the motor, in milliseconds */
+        uint32_t time = 0;
+};
+
+/**
+ * @brief Statistics of the output stage
+ *
+ */
+struct OutputStats {
+        /** number of times the output stage has been flushed */
+        uint32_t flushes = 0;
+        /** number of commands sent to motors */
+        uint32_t sent = 0;
+        /** number of commands skipped because the motor was already doing that */
+        uint32_t skipped = 0;
+};
+
+/**
+ * @brief Convert power to a voltage
+ *
+ * @param power power from -127 to 127
+ * @return float voltage in millivolts, from -12000 to 12000
+ */
+constexpr float powerToVoltage(float power) { return power * 12000 / 127; }
+
+/**
+ * @brief Set the battery voltage that motor output is compensated to
+ *
+ * Motors get less torque as the battery drains, so the same command accelerates the robot less at 11.9V than it does
+ * at 12.8V. When compensation is enabled, output is scaled by the reference voltage divided by the measured battery
+ * voltage, so the same command produces the same voltage at the motor all day. Output is still limited to 12000mV,
+ * so commands near full power will be capped when the battery is below the reference voltage. The measured voltage is
+ * filtered, and setting the reference restarts the filter from the next reading.
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * // behave like the battery is always at 12V
+ * lemlib::setVoltageCompensation(12000);
+ * @endcode
+ *
+ * @param reference the reference voltage in millivolts. 0 disables compensation, which is the default
+ */
+void setVoltageCompensation(float reference);
+
+/**
+ * @brief Get the filtered battery voltage used for compensation
+ *
+ * @return float battery voltage in millivolts
+ */
+float getBatteryVoltage();
+
+/**
+ * @brief Queue power to be sent to a motor group
+ *
+ * Power is converted to millivolts and battery compensated, then queued as a voltage command. This is what the
+ * chassis uses for all of its output.
+ *
+ * @param motors the motor group
+ * @param power the power to send, from -127 to 127. Fractional power is not rounded
+ */
+void queueOutput(pros::Motor_Group* motors, float power);
+
+/**
+ * @brief Queue power to be sent to a motor
+ *
+ * @param motor the motor
+ * @param power the power to send, from -127 to 127. Fractional power is not rounded
+ */
+void queueOutput(pros::Motor* motor, float power);
+
+/**
+ * @brief Queue a voltage command for every motor in a motor group
+ *
+ * The output stage collects the commands for every motor, and sends them all at once when it is flushed. If the
+ * control executive is running, it flushes the output stage every tick, and the last command queued for a motor
+ * wins. Otherwise, the command is sent immediately. Either way, a command is only sent if it is different from the
+ * last one sent to that motor.
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * lemlib::queueVoltage(&intake, 12000);
+ * lemlib::queueVoltage(&leftMotors, -6000);
+ * @endcode
+ *
+ * @param motors the motor group
+ * @param voltage the voltage in millivolts, from -12000 to 12000
+ */
+void queueVoltage(pros::Motor_Group* motors, int32_t voltage);
+
+/**
+ * @brief Queue a voltage command for a motor
+ *
+ * @param motor the motor
+ * @param voltage the voltage in millivolts, from -12000 to 12000
+ */
+void queueVoltage(pros::Motor* motor, int32_t voltage);
+
+/**
+ * @brief Queue a velocity command for every motor in a motor group
+ *
+ * @param motors the motor group
+ * @param velocity the velocity in rpm, limited by the motor cartridge
+ */
+void queueVelocity(pros::Motor_Group* motors, int32_t velocity);
+
+/**
+ * @brief Queue a velocity command for a motor
+ *
+ * @param motor the motor
+ * @param velocity the velocity in rpm, limited by the motor cartridge
+ */
+void queueVelocity(pros::Motor* motor, int32_t velocity);
+
+/**
+ * @brief Send all queued commands to the motors
+ *
+ * Called by the control executive in its output stage. Commands identical to the last one sent to a motor are
+ * skipped, but are still refreshed every 100ms in case the motor was commanded without the output stage.
+ */
+void flushOutput();
+
+/**
+ * @brief Get the last command sent to a motor through the output stage
+ *
+ * @param port the smart port of the motor, from 1 to 21
+ * @return OutputCommand
+ */
+OutputCommand getCommandedOutput(uint8_t port);
+
+/**
+ * @brief Get the statistics of the output stage
+ *
+ * @return OutputStats
+ */
+OutputStats getOutputStats();
+} // namespace lemlib
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace lemlib {
+/**
+ * @brief Number of histogram buckets in each profiling zone
+ *
+ * Buckets are spaced 4 to an octave, so percentiles are accurate to within 19%.
+ */
+constexpr int PROFILE_BUCKETS = 124;
+
+/**
+ * @brief Most profiling zones that can exist at once. Zones past this are ignored
+ *
+ */
+constexpr int MAX_PROFILE_ZONES = 32;
+
+/**
+ * @brief Timing statistics of a piece of code
+ *
+ * Times are in nanoseconds. Zones live in a static table and are never freed.
+ */
+struct ProfileZone {
+        const char* name;
+        uint32_t count;
+        uint64_t total;
+        uint32_t min;
+        uint32_t max;
+        uint32_t histogram[PROFILE_BUCKETS];
+};
+
+/**
+ * @brief Summary of a profiling zone
+ *
+ * @param name the name of the zone
+ * @param count how many times the zone ran
+ * @param min the shortest run, in microseconds
+ * @param mean the mean run, in microseconds
+ * @param max the longest run, in microseconds
+ * @param p99 the 99th percentile run, in microseconds
+ */
+struct ProfileStats {
+        const char* name;
+        uint32_t count;
+        float min;
+        float mean;
+        float max;
+        float p99;
+};
+
+/**
+ * @brief Get a profiling zone, creating it if it doesn't exist yet
+ *
+ * @param name the name of the zone. Must outlive the program, like a string literal
+ * @return ProfileZone* the zone, or nullptr if the zone table is full
+ */
+ProfileZone* profileZone(const char* name);
+
+/**
+ * @brief Get a timestamp for profiling
+ *
+ * On the brain this reads the Cortex-A9 cycle counter, or pros::micros() if LEMLIB_PROFILER_USE_MICROS is defined.
+ * Elsewhere it reads the host's steady clock. Simulated clocks are never used, since zones measure CPU time.
+ *
+ * @return uint32_t the timestamp, in an unspecified unit
+ */
+uint32_t profileNow();
+
+/**
+ * @brief Get the time since a profileNow() timestamp
+ *
+ * @param start the timestamp
+ * @return uint32_t the time since the timestamp, in nanoseconds
+ */
+uint32_t profileElapsed(uint32_t start);
+
+/**
+ * @brief Record a run of a profiling zone
+ *
+ * Zones aren't locked, so a zone entered by two tasks at the same moment may lose a sample. This is rare enough that
+ * it doesn't change the statistics.
+ *
+ * @param zone the zone. Ignored if nullptr
+ * @param start the timestamp from profileNow() when the run started
+ */
+void profileRecord(ProfileZone* zone, uint32_t start);
+
+/**
+ * @brief Times a profiling zone from when it is created until it is stopped or destroyed
+ *
+ */
+class ProfileScope {
+    public:
+        /**
+         * @brief Start timing a zone
+         *
+         * @param zone the zone. Nothing is recorded if nullptr
+         */
+        ProfileScope(ProfileZone* zone)
+            : zone(zone),
+              start(zone == nullptr ? 0 : profileNow()) {}
+
+        ProfileScope(const ProfileScope&) = delete;
+        ProfileScope& operator=(const ProfileScope&) = delete;
+
+        /**
+         * @brief Stop timing early, for zones that shouldn't include the rest of their scope
+         *
+         */
+        void stop() {
+            if (zone != nullptr) profileRecord(zone, start);
+            zone = nullptr;
+        }
+
+        ~ProfileScope() { stop(); }
+    private:
+        ProfileZone* zone;
+        uint32_t start;
+};
+
+/**
+ * @brief Get the statistics of every profiling zone
+ *
+ * @return std::vector<ProfileStats> the zones, in the order they were created
+ */
+std::vector<ProfileStats> getProfile();
+
+/**
+ * @brief Clear the statistics of every profiling zone
+ *
+ */
+void resetProfile();
+
+/**
+ * @brief Log the statistics of every profiling zone through the info sink, at the debug level
+ *
+ */
+void logProfile();
+
+/**
+ * @brief Write the statistics of every profiling zone to a CSV file
+ *
+ * @param path the file to write. "/usd/profile.csv" by default, which is on the SD card
+ * @return true the file was written
+ * @return false the file couldn't be opened
+ */
+bool writeProfile(const char* path = "/usd/profile.csv");
+
+/**
+ * @brief Start a low priority task that periodically logs the profiling statistics
+ *
+ * Does nothing if the task is already running, or if the clock doesn't support tasks.
+ *
+ * @param period time between dumps, in milliseconds
+ * @param toSd whether to also write the statistics to the SD card. false by default
+ */
+void startProfileDump(uint32_t period, bool toSd = false);
+} // namespace lemlib
+
+/**
+ * Profiling is compiled out unless LEMLIB_PROFILING is defined, for example with
+ * EXTRA_CXXFLAGS=-DLEMLIB_PROFILING in the project Makefile.
+ */
+#ifdef LEMLIB_PROFILING
+#define LEMLIB_PROFILE_CONCAT_(a, b) a##b
+#define LEMLIB_PROFILE_CONCAT(a, b) LEMLIB_PROFILE_CONCAT_(a, b)
+/**
+ * @brief Get the profiling zone with a name. The zone is only looked up the first time
+ */
+#define LEMLIB_PROFILE_ZONE(name)                                                                                      \
+    ([]() {                                                                                                            \
+        static lemlib::ProfileZone* zone = lemlib::profileZone(name);                                                  \
+        return zone;                                                                                                   \
+    }())
+/**
+ * @brief Time the rest of the enclosing scope as a profiling zone
+ */
+#define LEMLIB_PROFILE(name) lemlib::ProfileScope LEMLIB_PROFILE_CONCAT(lemlibProfile, __LINE__)(LEMLIB_PROFILE_ZONE(name))
+#else
+#define LEMLIB_PROFILE_ZONE(name) (static_cast<lemlib::ProfileZone*>(nullptr))
+#define LEMLIB_PROFILE(name)
+#endif
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+
+namespace lemlib {
+/**
+ * @brief Settings for a relay autotune experiment
+ *
+ * @param relayAmplitude the output of the relay, from 0 to 127. 60 by default
+ * @param hysteresis the error band, in the units of the controller, where the relay won't switch. Keeps sensor noise
+ *  from chattering the relay. 0.5 by default
+ * @param cycles how many oscillations to average over. The first oscillation is always discarded. 4 by default
+ * @param timeout the longest time the experiment can run for, in milliseconds. 10000 by default
+ * @param integral whether to propose an integral gain. false by default, as most drivetrains only need PD
+ */
+struct AutotuneSettings {
+        float relayAmplitude = 60;
+        float hysteresis = 0.5;
+        int cycles = 4;
+        int timeout = 10000;
+        bool integral = false;
+};
+
+/**
+ * @brief Result of a relay autotune experiment
+ *
+ * The gains are in the same units as ControllerSettings, and assume the controller is updated every 10ms, like
+ * every motion in LemLib is.
+ */
+struct AutotuneResult {
+        /** whether enough oscillations were measured before the timeout */
+        bool success = false;
+        /** the ultimate gain, Ku */
+        float ultimateGain = 0;
+        /** the ultimate period, Tu, in milliseconds */
+        float ultimatePeriod = 0;
+        /** the amplitude of the measured oscillation */
+        float amplitude = 0;
+        float kP = 0;
+        float kI = 0;
+        float kD = 0;
+        float windupRange = 0;
+        float smallError = 0;
+        float smallErrorTimeout = 0;
+        float largeError = 0;
+        float largeErrorTimeout = 0;
+};
+
+/**
+ * @brief Relay feedback autotuner
+ *
+ * Runs the Åström–Hägglund relay experiment: the output is switched between +d and -d whenever the error crosses
+ * the hysteresis band, which drives the system into a stable limit cycle. The amplitude and period of that cycle are
+ * the ultimate gain and period, which are turned into PID gains with the Ziegler-Nichols rules.
+ *
+ * The tuner doesn't talk to any hardware, so it can be run against a real drivetrain or a simulated one.
+ */
+class RelayTuner {
+    public:
+        /**
+         * @brief Construct a new Relay Tuner
+         *
+         * @param settings settings for the experiment
+         */
+        RelayTuner(AutotuneSettings settings);
+
+        /**
+         * @brief Update the relay
+         *
+         * @param error target minus position
+         * @param time the current time, in milliseconds
+         * @return float the output of the relay
+         */
+        float update(float error, uint32_t time);
+
+        /**
+         * @brief Whether enough oscillations have been measured
+         *
+         * @return true the experiment is done
+         * @return false the experiment is not done
+         */
+        bool isDone() const;
+
+        /**
+         * @brief Calculate the result of the experiment
+         *
+         * @param period how often the tuned controller will be updated, in milliseconds. 10 by default
+         * @return AutotuneResult
+         */
+        AutotuneResult getResult(float period = 10) const;
+
+        /**
+         * @brief Reset the experiment
+         *
+         */
+        void reset();
+    private:
+        const AutotuneSettings settings;
+
+        float output = 0;
+        float peak = 0;
+        float trough = 0;
+        int64_t lastRiseTime = -1;
+        int switches = 0;
+        int measured = 0;
+        float periodSum = 0;
+        float amplitudeSum = 0;
+};
+} // namespace lemlib
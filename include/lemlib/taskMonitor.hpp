@@ -0,0 +1,140 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "pros/rtos.hpp"
+
+namespace lemlib {
+/**
+ * @brief Most tasks that can be monitored at once. Tasks past this are ignored
+ *
+ */
+constexpr int MAX_MONITORED_TASKS = 16;
+
+/**
+ * @brief Activity of a monitored task
+ *
+ * Monitored tasks live in a static table and are never freed. Work is added by the working task and taken by the
+ * monitor, so the counters are atomic. An entry with a stack size of 0 is shared by work that runs in whichever task
+ * calls it, like motions, which run in the caller's task or in a short-lived async task. Those tasks can be deleted
+ * before the monitor samples them, so their handles aren't kept and their stack isn't measured.
+ */
+struct MonitoredTask {
+        const char* name;
+        /** the task that most recently did work under this name. Always nullptr for a shared entry */
+        std::atomic<pros::task_t> task;
+        /** stack size the task was created with, in bytes. 0 for a shared entry */
+        uint32_t stackSize;
+        /** time spent working since the last sample, in nanoseconds */
+        std::atomic<uint64_t> busy;
+        /** longest single stretch of work since the last sample, in nanoseconds */
+        std::atomic<uint32_t> longest;
+};
+
+/**
+ * @brief A sample of a monitored task
+ *
+ * @param name the name of the task
+ * @param cpu share of the CPU the task used over the last sample period, from 0 to 1
+ * @param longest longest single stretch of work over the last sample period, in microseconds
+ * @param stackFree least free stack the task has ever had, in bytes. -1 if the kernel doesn't report it, or the entry is
+ *  shared
+ * @param stackSize stack size the task was created with, in bytes. 0 if the entry is shared
+ */
+struct TaskStats {
+        const char* name;
+        float cpu;
+        uint32_t longest;
+        int32_t stackFree;
+        uint32_t stackSize;
+};
+
+/**
+ * @brief Get a monitored task, creating it if it doesn't exist yet
+ *
+ * @param name the name of the task. Must outlive the program, like a string literal
+ * @param stackDepth the stack depth the task was created with, in words. TASK_STACK_DEPTH_DEFAULT by default. 0 for
+ *  work that runs in whichever task calls it, see MonitoredTask
+ * @return MonitoredTask* the task, or nullptr if the table is full
+ */
+MonitoredTask* monitoredTask(const char* name, uint32_t stackDepth = TASK_STACK_DEPTH_DEFAULT);
+
+/**
+ * @brief Get the monitored task that motion loops count their work under, whichever task they run in
+ *
+ * The entry is shared, so it reports CPU time but not stack.
+ *
+ * @return MonitoredTask* the task, or nullptr if the table is full
+ */
+MonitoredTask* motionWork();
+
+/**
+ * @brief Counts the time from when it is created until it is stopped or destroyed as work done by the calling task
+ *
+ * Put one at the top of the body of a task's loop, and stop it before the loop waits, so waiting isn't counted.
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * pros::Task colorSort([] {
+ *     while (true) {
+ *         lemlib::TaskWork work(lemlib::monitoredTask("color sort"));
+ *         sortRings();
+ *         work.stop();
+ *         pros::delay(10);
+ *     }
+ * });
+ * @endcode
+ */
+class TaskWork {
+    public:
+        /**
+         * @brief Start counting work
+         *
+         * @param task the monitored task. Nothing is counted if nullptr
+         */
+        TaskWork(MonitoredTask* task);
+
+        TaskWork(const TaskWork&) = delete;
+        TaskWork& operator=(const TaskWork&) = delete;
+
+        /**
+         * @brief Stop counting work
+         *
+         */
+        void stop();
+
+        ~TaskWork() { stop(); }
+    private:
+        MonitoredTask* task;
+        uint32_t start;
+};
+
+/**
+ * @brief Sample every monitored task, and start a new sample period
+ *
+ * CPU time is measured with the profiler's timestamps, so on the host it is real time, compared against however long
+ * the sample period was on the RTOS clock.
+ *
+ * @return std::vector<TaskStats> the tasks, in the order they were first monitored
+ */
+std::vector<TaskStats> sampleTasks();
+
+/**
+ * @brief Start a low priority task that samples the monitored tasks and publishes them through telemetry
+ *
+ * Every period, a TaskRecord for each task is published to a telemetry channel named "task " followed by the name of
+ * the task. They are sent while binary telemetry is running, see startBinaryTelemetry(). A warning is logged through
+ * the info sink when a task uses more of the CPU than cpuWarning, or has less free stack than stackWarning. Does
+ * nothing if the monitor is already running, or if the clock doesn't support tasks.
+ *
+ * Free stack comes from FreeRTOS' uxTaskGetStackHighWaterMark, which PROS doesn't declare. If the kernel doesn't export
+ * it, free stack is reported as -1 and stack warnings are never logged, and the monitor logs a warning once when it
+ * starts.
+ *
+ * @param period time between samples, in milliseconds. 1000 by default
+ * @param cpuWarning CPU share, from 0 to 1, above which a task is reported as overloaded. 0.5 by default
+ * @param stackWarning free stack, in bytes, below which a task is reported as close to overflowing. 1024 by default
+ */
+void startTaskMonitor(uint32_t period = 1000, float cpuWarning = 0.5, int32_t stackWarning = 1024);
+} // namespace lemlib
@@ -0,0 +1,450 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "pros/rtos.hpp"
+
+namespace lemlib {
+/**
+ * @brief The kinds of record sent over binary telemetry
+ *
+ * TEXT records hold a log message, and are only written by the flight recorder. POSE_STREAM records hold the pose
+ * compressed by PoseStreamEncoder. TASK records are published by the task monitor
+ */
+enum class RecordType : uint8_t {
+    POSE = 1,
+    SPEED = 2,
+    MOTION = 3,
+    CONTROLLER = 4,
+    TEXT = 5,
+    POSE_STREAM = 6,
+    TASK = 7
+};
+
+/**
+ * @brief Pose of the robot, in inches and degrees
+ *
+ */
+struct PoseRecord {
+        float x;
+        float y;
+        float theta;
+};
+
+/**
+ * @brief Speed of the robot on the field, in inches per second and degrees per second
+ *
+ */
+struct SpeedRecord {
+        float x;
+        float y;
+        float theta;
+};
+
+/**
+ * @brief State of the running motion
+ *
+ * @param type the lemlib::MotionType of the motion
+ * @param running whether a motion is running. The rest of the record is left over from the last motion if not
+ * @param targetX target x, in inches
+ * @param targetY target y, in inches
+ * @param targetTheta target heading in degrees, or NaN for motions without one
+ * @param distance distance travelled since the motion started, in inches, or degrees for turns
+ */
+struct MotionStateRecord {
+        uint32_t type;
+        uint32_t running;
+        float targetX;
+        float targetY;
+        float targetTheta;
+        float distance;
+};
+
+/**
+ * @brief Outputs of the running motion's controllers, from -127 to 127
+ *
+ */
+struct ControllerRecord {
+        float lateral;
+        float angular;
+        float left;
+        float right;
+};
+
+/**
+ * @brief A sample of a monitored task, like lemlib::TaskStats
+ *
+ * @param name the name of the task, cut short to fit and padded with zeros
+ * @param cpu share of the CPU the task used over the last sample period, from 0 to 1
+ * @param longest longest single stretch of work over the last sample period, in microseconds
+ * @param stackFree least free stack the task has ever had, in bytes. -1 if the kernel doesn't report it, or the task
+ *  is a shared entry like "motion"
+ * @param stackSize stack size the task was created with, in bytes. 0 for a shared entry
+ */
+struct TaskRecord {
+        char name[24];
+        float cpu;
+        uint32_t longest;
+        int32_t stackFree;
+        uint32_t stackSize;
+};
+
+/**
+ * @brief Largest frame encodeRecord produces for the fixed size records, including both delimiters
+ *
+ */
+constexpr size_t MAX_FRAME_SIZE = 64;
+
+/**
+ * @brief Largest record encodeRecord can encode, in bytes. Frames are at most this plus 9 bytes
+ *
+ */
+constexpr size_t MAX_RECORD_SIZE = 240;
+
+/**
+ * @brief COBS encode data, so it contains no zero bytes
+ *
+ * @param data the data to encode
+ * @param size number of bytes of data. Must be under 254
+ * @param out where to write the encoded data. Must have room for size + 1 bytes
+ * @return size_t the number of bytes written
+ */
+size_t cobsEncode(const uint8_t* data, size_t size, uint8_t* out);
+
+/**
+ * @brief Decode COBS encoded data
+ *
+ * @param data the encoded data, without delimiters
+ * @param size number of bytes of encoded data
+ * @param out where to write the decoded data. Must have room for size bytes
+ * @return size_t the number of bytes written, or 0 if the data isn't valid COBS
+ */
+size_t cobsDecode(const uint8_t* data, size_t size, uint8_t* out);
+
+/**
+ * @brief Encode a record into a frame
+ *
+ * A frame is a zero byte, then the COBS encoded type, time, payload and CRC-8 of all three, then another zero byte.
+ * Starting with a delimiter means text printed between frames can never corrupt the next frame. Multi-byte values are
+ * little endian, like the brain and every host.
+ *
+ * @param type the type of the record
+ * @param time when the record was taken, in milliseconds
+ * @param payload the record
+ * @param size size of the record in bytes. At most MAX_RECORD_SIZE
+ * @param frame where to write the frame. Must have room for size + 9 bytes, which MAX_FRAME_SIZE is for every record
+ * except TEXT
+ * @return size_t size of the frame in bytes
+ */
+size_t encodeRecord(RecordType type, uint32_t time, const void* payload, size_t size, uint8_t* frame);
+
+/**
+ * @brief Encode the current value of a record into a frame
+ *
+ * @param type the type of the record. Not TEXT, which has no current value
+ * @param time the time to stamp the record with, in milliseconds
+ * @param frame where to write the frame. Must have room for MAX_FRAME_SIZE bytes
+ * @return size_t size of the frame in bytes
+ */
+size_t encodeSample(RecordType type, uint32_t time, uint8_t* frame);
+
+/**
+ * @brief Decode the contents of a frame
+ *
+ * @param data the bytes between two delimiters
+ * @param size number of bytes
+ * @param type the type of the record
+ * @param time when the record was taken, in milliseconds
+ * @param payload where to write the record. Must have room for size bytes
+ * @return int the size of the record in bytes, or -1 if the frame is corrupt
+ */
+int decodeRecord(const uint8_t* data, size_t size, RecordType& type, uint32_t& time, uint8_t* payload);
+
+/**
+ * @brief Update the state and controller outputs of the running motion
+ *
+ * Motions call this on every iteration. Only the latest values are kept, and sent on the next telemetry tick.
+ *
+ * @param state the state of the motion
+ * @param controller the outputs of the motion's controllers
+ */
+void publishMotion(const MotionStateRecord& state, const ControllerRecord& controller);
+
+/**
+ * @brief Mark the motion as finished
+ *
+ */
+void publishMotionEnd();
+
+/**
+ * @brief Largest record a telemetry channel can hold, in bytes, so its frame fits in MAX_FRAME_SIZE
+ *
+ */
+constexpr size_t MAX_CHANNEL_RECORD_SIZE = MAX_FRAME_SIZE - 9;
+
+/**
+ * @brief How often a telemetry channel sends its records
+ *
+ * @param decimation only keep every nth record published to the channel. 1 by default, which keeps every record
+ * @param maxRate most records to send per second, or 0 to send on every telemetry tick. 0 by default
+ * @param enabled whether the channel is sent at all. True by default
+ */
+struct ChannelConfig {
+        uint32_t decimation = 1;
+        float maxRate = 0;
+        bool enabled = true;
+};
+
+/**
+ * @brief How many records a telemetry channel has handled
+ *
+ * @param published records published to the channel
+ * @param sent records sent over telemetry
+ * @param coalesced records replaced by a newer record before they were sent
+ */
+struct ChannelStats {
+        uint32_t published;
+        uint32_t sent;
+        uint32_t coalesced;
+};
+
+/**
+ * @brief A named stream of records sent over binary telemetry
+ *
+ * Only the latest record published to a channel is kept. The telemetry task sends it on its next tick, unless the
+ * channel's max rate says it is too soon, in which case it waits and any newer record replaces it. So a control loop can
+ * publish on every iteration, and the link only carries what the channel is configured to send.
+ *
+ * Get channels with telemetryChannel(). startBinaryTelemetry() creates "pose", "speed", "motion", "controller" and
+ * "pose stream" channels for the records it samples.
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * struct LiftRecord {
+ *         float angle;
+ *         float target;
+ * };
+ *
+ * // record types from 32 up are free for your own records
+ * lemlib::TelemetryChannel& lift = lemlib::telemetryChannel("lift", lemlib::RecordType(32));
+ * lemlib::configureTelemetryChannel("lift", {.maxRate = 20});
+ * while (true) {
+ *     lift.publish(LiftRecord {angle, target});
+ *     pros::delay(10);
+ * }
+ * @endcode
+ */
+class TelemetryChannel {
+    public:
+        /**
+         * @brief Construct a new Telemetry Channel object. Use telemetryChannel() instead
+         *
+         * @param name the name of the channel
+         * @param type the type of the channel's records
+         */
+        TelemetryChannel(const std::string& name, RecordType type);
+
+        /**
+         * @brief Publish a record, replacing the last one if it hasn't been sent yet. Safe to call from any task
+         *
+         * @param payload the record
+         * @param size size of the record in bytes. Records over MAX_CHANNEL_RECORD_SIZE are cut short
+         */
+        void publish(const void* payload, size_t size);
+
+        /**
+         * @brief Publish a record, replacing the last one if it hasn't been sent yet. Safe to call from any task
+         *
+         * @param record the record
+         */
+        template <typename T> void publish(const T& record) {
+            static_assert(sizeof(T) <= MAX_CHANNEL_RECORD_SIZE, "record is too big for a telemetry channel");
+            publish(&record, sizeof(T));
+        }
+
+        /**
+         * @brief Change how often the channel sends its records
+         *
+         * @param config the new configuration
+         */
+        void configure(const ChannelConfig& config);
+
+        /**
+         * @brief Get the channel's configuration
+         *
+         * @return ChannelConfig
+         */
+        ChannelConfig getConfig();
+
+        /**
+         * @brief Get how many records the channel has handled
+         *
+         * @return ChannelStats
+         */
+        ChannelStats getStats();
+
+        /**
+         * @brief Get the name of the channel
+         *
+         * @return const std::string&
+         */
+        const std::string& getName() const;
+
+        /**
+         * @brief Get the type of the channel's records
+         *
+         * @return RecordType
+         */
+        RecordType getType() const;
+
+        /**
+         * @brief Encode the latest record into a frame, if it is due to be sent. Used by the telemetry task
+         *
+         * @param now the current time, in milliseconds
+         * @param frame where to write the frame. Must have room for MAX_FRAME_SIZE bytes
+         * @return size_t size of the frame in bytes, or 0 if nothing was due
+         */
+        size_t encodePending(uint32_t now, uint8_t* frame);
+    private:
+        const std::string name;
+        const RecordType type;
+        ChannelConfig config;
+        ChannelStats stats {};
+
+        // the latest record, and whether it has been sent
+        uint8_t record[MAX_CHANNEL_RECORD_SIZE];
+        size_t size = 0;
+        uint32_t time = 0;
+        bool pending = false;
+        // when the last record was sent, and whether one has been sent
+        uint32_t lastSent = 0;
+        bool sentBefore = false;
+        pros::Mutex mutex;
+};
+
+/**
+ * @brief Size of one step of the pose stream, in inches for x and y and degrees for theta
+ *
+ */
+constexpr float POSE_STREAM_RESOLUTION = 0.01;
+
+/**
+ * @brief Most poses in one POSE_STREAM record
+ *
+ */
+constexpr uint8_t MAX_POSE_STREAM_DELTAS = 8;
+
+/**
+ * @brief Compresses a pose sampled at a fixed rate into POSE_STREAM records
+ *
+ * The pose is rounded to POSE_STREAM_RESOLUTION. A keyframe record holds the whole rounded pose in 16 bytes, and a
+ * delta record holds the change since the previous pose, 6 bytes per pose, for several poses. So at 100 Hz, with 5
+ * poses per record, the pose stream takes about 0.8 kB/s instead of the 2.1 kB/s of POSE records. Deltas are taken
+ * from the rounded poses, so rounding errors never add up.
+ *
+ * Every record has a sequence number. If a record is lost, PoseStreamDecoder ignores deltas until the next keyframe,
+ * which is sent every keyframeInterval records and after a jump too big for a delta, like a call to setPose().
+ */
+class PoseStreamEncoder {
+    public:
+        /**
+         * @brief Construct a new Pose Stream Encoder object
+         *
+         * @param period time between poses, in milliseconds
+         * @param deltasPerRecord poses in each delta record, up to MAX_POSE_STREAM_DELTAS. 5 by default
+         * @param keyframeInterval delta records between keyframes. 20 by default
+         */
+        PoseStreamEncoder(uint32_t period, uint8_t deltasPerRecord = 5, uint32_t keyframeInterval = 20);
+
+        /**
+         * @brief Add the next pose to the stream
+         *
+         * @param pose the pose, sampled one period after the previous one
+         * @param payload where to write the record. Must have room for MAX_CHANNEL_RECORD_SIZE bytes
+         * @return size_t size of the record in bytes, or 0 if the pose was added to a record that isn't full yet
+         */
+        size_t encode(const PoseRecord& pose, uint8_t* payload);
+
+        /**
+         * @brief Start again with a keyframe
+         *
+         */
+        void reset();
+    private:
+        const uint32_t period;
+        const uint8_t deltasPerRecord;
+        const uint32_t keyframeInterval;
+
+        // the last pose added, rounded
+        int32_t last[3] = {0, 0, 0};
+        bool keyframeDue = true;
+        uint32_t sinceKeyframe = 0;
+        uint8_t sequence = 0;
+        // the delta record being filled
+        uint8_t count = 0;
+        int16_t deltas[MAX_POSE_STREAM_DELTAS][3];
+};
+
+/**
+ * @brief Turns POSE_STREAM records back into poses
+ *
+ */
+class PoseStreamDecoder {
+    public:
+        /**
+         * @brief Decode a POSE_STREAM record
+         *
+         * @param time the time of the record's frame, in milliseconds
+         * @param payload the record
+         * @param size size of the record in bytes
+         * @param times where to write when each pose was sampled. Must have room for MAX_POSE_STREAM_DELTAS values
+         * @param poses where to write the poses. Must have room for MAX_POSE_STREAM_DELTAS poses
+         * @return int number of poses decoded. 0 while waiting for a keyframe, after a record was lost
+         */
+        int decode(uint32_t time, const uint8_t* payload, size_t size, uint32_t* times, PoseRecord* poses);
+    private:
+        int32_t last[3] = {0, 0, 0};
+        uint32_t period = 0;
+        uint8_t sequence = 0;
+        bool synced = false;
+};
+
+/**
+ * @brief Get the telemetry channel with the given name, creating it if there isn't one
+ *
+ * Channels are never destroyed, so the reference stays valid. Look the channel up once rather than every time a record
+ * is published.
+ *
+ * @param name the name of the channel
+ * @param type the type of the channel's records. Ignored if the channel already exists
+ * @return TelemetryChannel&
+ */
+TelemetryChannel& telemetryChannel(const std::string& name, RecordType type);
+
+/**
+ * @brief Change how often a telemetry channel sends its records. Can be called at any time
+ *
+ * @param name the name of the channel
+ * @param config the new configuration
+ * @return true if there is a channel with that name
+ */
+bool configureTelemetryChannel(const std::string& name, const ChannelConfig& config);
+
+/**
+ * @brief Start a task that streams binary telemetry over stdout
+ *
+ * Every period, the current value of each requested type of record is published to its channel, then every channel
+ * with a record due is sent, all in a single write. A pose frame is 21 bytes, so 100 Hz of pose takes about 2 kB/s,
+ * the same as the pose used to take as text at 20 Hz. Decode the stream on a computer with host/build/telemetry. Does
+ * nothing if the task is already running, or if the clock doesn't support tasks.
+ *
+ * Sampling POSE_STREAM sends the pose compressed by a PoseStreamEncoder to the "pose stream" channel. Don't rate
+ * limit that channel, since a lost record loses the poses until the next keyframe.
+ *
+ * @param period time between telemetry ticks, in milliseconds. 10 by default
+ * @param records the types of record to sample. Only the pose by default
+ */
+void startBinaryTelemetry(uint32_t period = 10, std::vector<RecordType> records = {RecordType::POSE});
+} // namespace lemlib
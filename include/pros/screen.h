@@ -17,9 +17,14 @@
 
 #include <stdarg.h>   
 #include <stdbool.h>  
+// g++ always defines _GNU_SOURCE, so only define it, and undefine it again, when the compiler hasn't
+#ifdef _GNU_SOURCE
+#include <stdio.h>
+#else
 #define _GNU_SOURCE
 #include <stdio.h>  
 #undef _GNU_SOURCE
+#endif
 #include <stdint.h>
 
 #include "pros/colors.h"     // c color macros
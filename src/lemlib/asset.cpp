@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include "lemlib/asset.hpp"
+#include "lemlib/logger/logger.hpp"
+#include "lemlib/clock.hpp"
+
+namespace lemlib {
+namespace {
+/**
+ * @brief A compressed asset waiting to be decompressed
+ *
+ */
+struct RegisteredAsset {
+        asset* file;
+        const char* name;
+};
+
+std::vector<RegisteredAsset>& registeredAssets() {
+    static std::vector<RegisteredAsset> list;
+    return list;
+}
+
+/**
+ * @brief Check whether an asset is compressed, and read its header
+ *
+ */
+bool readCompressedHeader(const asset& file, CompressedAssetHeader& header) {
+    if (file.size < sizeof(header)) return false;
+    std::memcpy(&header, file.buf, sizeof(header));
+    return std::memcmp(header.magic, "LZ4B", 4) == 0;
+}
+
+/**
+ * @brief Round up to a multiple of 16 bytes, the alignment assets are linked with
+ *
+ */
+size_t alignAsset(size_t size) { return (size + 15) / 16 * 16; }
+} // namespace
+
+size_t lz4Decompress(const uint8_t* data, size_t size, uint8_t* out, size_t capacity) {
+    const uint8_t* in = data;
+    const uint8_t* const end = data + size;
+    uint8_t* op = out;
+    uint8_t* const outEnd = out + capacity;
+    while (in < end) {
+        // each sequence is a token, literals, then a match, except the last one, which is only literals
+        const uint8_t token = *in++;
+        size_t literals = token >> 4;
+        if (literals == 15) {
+            uint8_t extra;
+            do {
+                if (in >= end) return 0;
+                extra = *in++;
+                literals += extra;
+            } while (extra == 255);
+        }
+        if (literals > size_t(end - in) || literals > size_t(outEnd - op)) return 0;
+        std::memcpy(op, in, literals);
+        in += literals;
+        op += literals;
+        if (in == end) break;
+
+        if (end - in < 2) return 0;
+        const size_t offset = in[0] | in[1] << 8;
+        in += 2;
+        if (offset == 0 || offset > size_t(op - out)) return 0;
+        size_t length = token & 15;
+        if (length == 15) {
+            uint8_t extra;
+            do {
+                if (in >= end) return 0;
+                extra = *in++;
+                length += extra;
+            } while (extra == 255);
+        }
+        length += 4;
+        if (length > size_t(outEnd - op)) return 0;
+        const uint8_t* match = op - offset;
+        // matches can overlap the bytes they write, which repeats them
+        if (offset >= length) {
+            std::memcpy(op, match, length);
+            op += length;
+        } else {
+            for (size_t i = 0; i < length; i++) *op++ = *match++;
+        }
+    }
+    return op - out;
+}
+
+AssetRegistration::AssetRegistration(asset& file, const char* name) {
+    CompressedAssetHeader header;
+    if (readCompressedHeader(file, header)) registeredAssets().push_back({&file, name});
+}
+
+std::vector<AssetLoad> decompressAssets() {
+    // the arenas live for the whole program, since the assets point into them
+    static std::vector<std::unique_ptr<uint8_t[]>> arenas;
+    std::vector<AssetLoad> loads;
+    size_t total = 0;
+    for (const RegisteredAsset& registered : registeredAssets()) {
+        CompressedAssetHeader header;
+        if (readCompressedHeader(*registered.file, header)) total += alignAsset(header.rawSize);
+    }
+    if (total == 0) return loads;
+    arenas.emplace_back(new uint8_t[total + 15]);
+    uint8_t* next = reinterpret_cast<uint8_t*>(alignAsset(reinterpret_cast<uintptr_t>(arenas.back().get())));
+
+    for (const RegisteredAsset& registered : registeredAssets()) {
+        asset& file = *registered.file;
+        CompressedAssetHeader header;
+        // already decompressed by an earlier call
+        if (!readCompressedHeader(file, header)) continue;
+        const uint64_t start = getClock().micros();
+        const size_t compressedSize = std::min<size_t>(header.compressedSize, file.size - sizeof(header));
+        const size_t rawSize = lz4Decompress(file.buf + sizeof(header), compressedSize, next, header.rawSize);
+        const AssetLoad load = {registered.name, file.size, header.rawSize, uint32_t(getClock().micros() - start),
+                                rawSize == header.rawSize};
+        loads.push_back(load);
+        if (!load.ok) {
+            LEMLIB_ERROR(infoSink(), "asset {} is corrupt, and was left compressed", load.name);
+            continue;
+        }
+        file.buf = next;
+        file.size = rawSize;
+        next += alignAsset(rawSize);
+        LEMLIB_DEBUG(infoSink(), "asset {}: {} bytes decompressed to {} in {} us", load.name, load.compressedSize,
+                     load.rawSize, load.time);
+    }
+    return loads;
+}
+
+const AssetHeader* assetHeader(const asset& file) {
+    if (file.size < sizeof(AssetHeader) || reinterpret_cast<uintptr_t>(file.buf) % alignof(AssetHeader) != 0) {
+        return nullptr;
+    }
+    const AssetHeader* header = reinterpret_cast<const AssetHeader*>(file.buf);
+    if (std::memcmp(header->magic, "LAST", 4) != 0 || header->version != ASSET_VERSION) return nullptr;
+    return header;
+}
+
+const void* assetElements(const asset& file, AssetType type, size_t elementSize, size_t alignment) {
+    const AssetHeader* header = assetHeader(file);
+    if (header == nullptr) {
+        // untyped assets, like text paths, are expected here, but a typed asset this build can't read is a mistake
+        if (file.size >= 4 && std::memcmp(file.buf, "LAST", 4) == 0) {
+            LEMLIB_ERROR(infoSink(), "asset was made for a different version of LemLib, or is misaligned");
+        }
+        return nullptr;
+    }
+    if (header->type != type || header->elementSize != elementSize) {
+        LEMLIB_ERROR(infoSink(), "asset holds elements of type {} and size {}, not type {} and size {}",
+                     static_cast<int>(header->type), header->elementSize, static_cast<int>(type), elementSize);
+        return nullptr;
+    }
+    if (uint64_t(header->dataOffset) + uint64_t(header->count) * elementSize > file.size) {
+        LEMLIB_ERROR(infoSink(), "asset is cut short: {} elements don't fit in {} bytes", header->count, file.size);
+        return nullptr;
+    }
+    const uint8_t* elements = file.buf + header->dataOffset;
+    // elements that aren't aligned would fault, or be slow, when used in place
+    if (reinterpret_cast<uintptr_t>(elements) % alignment != 0) {
+        LEMLIB_ERROR(infoSink(), "asset elements are not aligned to {} bytes", alignment);
+        return nullptr;
+    }
+    return elements;
+}
+} // namespace lemlib
@@ -0,0 +1,97 @@
+// The implementation below is based off of
+// "Automatic tuning of simple regulators with specifications on phase and amplitude margins"
+// by K. J. Åström and T. Hägglund (1984)
+
+#include <math.h>
+#include "pros/rtos.hpp"
+#include "lemlib/util.hpp"
+#include "lemlib/timer.hpp"
+#include "lemlib/relayTuner.hpp"
+#include "lemlib/chassis/chassis.hpp"
+#include "lemlib/chassis/executive.hpp"
+#include "lemlib/output.hpp"
+#include "lemlib/logger/logger.hpp"
+#include "lemlib/clock.hpp"
+
+/**
+ * @brief Tune the angular controller with a relay feedback experiment
+ *
+ * @param settings settings for the experiment. Error units are in degrees
+ * @return AutotuneResult the proposed settings
+ */
+lemlib::AutotuneResult lemlib::Chassis::autotuneAngular(AutotuneSettings settings) {
+    return relayExperiment(settings, true);
+}
+
+/**
+ * @brief Tune the lateral controller with a relay feedback experiment
+ *
+ * @param settings settings for the experiment. Error units are in inches
+ * @return AutotuneResult the proposed settings
+ */
+lemlib::AutotuneResult lemlib::Chassis::autotuneLateral(AutotuneSettings settings) {
+    return relayExperiment(settings, false);
+}
+
+/**
+ * @brief Run a relay feedback experiment on one of the chassis controllers
+ *
+ * The setpoint is the pose of the robot when the experiment starts, so the robot oscillates in place.
+ *
+ * @param settings settings for the experiment
+ * @param angular true to tune the angular controller, false to tune the lateral controller
+ * @return AutotuneResult the proposed settings
+ */
+lemlib::AutotuneResult lemlib::Chassis::relayExperiment(AutotuneSettings settings, bool angular) {
+    this->requestMotionStart();
+    // were all motions cancelled?
+    if (!this->motionRunning) return {};
+
+    RelayTuner tuner(settings);
+    const Pose start = getPose(true);
+    distTravelled = 0;
+    Timer timer(settings.timeout);
+
+    // main loop
+    while (!timer.isDone() && !tuner.isDone() && this->motionRunning) {
+        const Pose pose = getPose(true);
+        float output;
+        if (angular) {
+            // error in degrees, like turnTo
+            const float error = radToDeg(angleError(start.theta, pose.theta));
+            output = tuner.update(error, getClock().millis());
+            queueOutput(drivetrain.leftMotors, output);
+            queueOutput(drivetrain.rightMotors, -output);
+        } else {
+            // error in inches, along the starting heading
+            const float error = (start.x - pose.x) * sin(start.theta) + (start.y - pose.y) * cos(start.theta);
+            output = tuner.update(error, getClock().millis());
+            queueOutput(drivetrain.leftMotors, output);
+            queueOutput(drivetrain.rightMotors, output);
+        }
+        syncController();
+    }
+
+    // stop the drivetrain
+    queueOutput(drivetrain.leftMotors, 0);
+    queueOutput(drivetrain.rightMotors, 0);
+
+    const AutotuneResult result = tuner.getResult(10);
+    const char* name = angular ? "angular" : "lateral";
+    if (result.success) {
+        LEMLIB_INFO(infoSink(), "{} autotune: Ku {:.3f}, Tu {:.0f} ms, amplitude {:.3f}", name, result.ultimateGain,
+                    result.ultimatePeriod, result.amplitude);
+        LEMLIB_INFO(infoSink(),
+                    "{} autotune: ControllerSettings({:.3f}, {:.4f}, {:.3f}, {:.2f}, {:.2f}, {:.0f}, {:.2f}, "
+                    "{:.0f}, <slew>)",
+                    name, result.kP, result.kI, result.kD, result.windupRange, result.smallError,
+                    result.smallErrorTimeout, result.largeError, result.largeErrorTimeout);
+    } else {
+        LEMLIB_WARN(infoSink(), "{} autotune failed: no stable oscillation before the timeout", name);
+    }
+
+    // set distTraveled to -1 to indicate that the function has finished
+    distTravelled = -1;
+    this->endMotion();
+    return result;
+}
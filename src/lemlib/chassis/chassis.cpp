@@ -15,10 +15,16 @@
 #include "pros/rtos.h"
 #include "lemlib/util.hpp"
 #include "lemlib/chassis/chassis.hpp"
+#include "lemlib/chassis/executive.hpp"
+#include "lemlib/output.hpp"
 #include "lemlib/chassis/odom.hpp"
 #include "lemlib/chassis/trackingWheel.hpp"
 #include "lemlib/timer.hpp"
 #include "pros/rtos.hpp"
+#include "lemlib/clock.hpp"
+#include "lemlib/profiler.hpp"
+#include "lemlib/taskMonitor.hpp"
+#include "lemlib/telemetry.hpp"
 
 /**
  * @brief The variables are pointers so that they can be set to nullptr if they are not used
@@ -94,7 +100,7 @@ void lemlib::Chassis::calibrate(bool calibrateIMU) {
         while (sensors.imu->reset(true) != 1 && (errno == PROS_ERR || errno == ENODEV || errno == ENXIO) &&
                attempt < 5) {
             pros::c::controller_rumble(pros::E_CONTROLLER_MASTER, "---");
-            pros::delay(10);
+            getClock().delay(10);
             attempt++;
         }
         if (attempt == 5) sensors.imu = nullptr;
@@ -158,7 +164,7 @@ lemlib::Pose lemlib::Chassis::getPose(bool radians, bool standardPos) {
  */
 void lemlib::Chassis::waitUntil(float dist) {
     // do while to give the thread time to start
-    do pros::delay(10);
+    do getClock().delay(10);
     while (distTravelled <= dist && distTravelled != -1);
 }
 
@@ -167,7 +173,7 @@ void lemlib::Chassis::waitUntil(float dist) {
  *
  */
 void lemlib::Chassis::waitUntilDone() {
-    do pros::delay(10);
+    do getClock().delay(10);
     while (distTravelled != -1);
 }
 
@@ -188,23 +194,50 @@ void lemlib::Chassis::endMotion() {
     this->motionRunning = this->motionQueued;
     this->motionQueued = false;
 
+    // stop synchronizing this motion with the executive
+    lemlib::releaseController();
+
     // permit queued motion to run
     this->mutex.give();
 }
 
 void lemlib::Chassis::cancelMotion() {
     this->motionRunning = false;
-    pros::delay(10); // give time for motion to stop
+    getClock().delay(10); // give time for motion to stop
 }
 
 void lemlib::Chassis::cancelAllMotions() {
     this->motionRunning = false;
     this->motionQueued = false;
-    pros::delay(10); // give time for motion to stop
+    getClock().delay(10); // give time for motion to stop
 }
 
 bool lemlib::Chassis::isInMotion() const { return this->motionRunning; }
 
+void lemlib::Chassis::setMotionObserver(MotionObserver_t observer) { this->motionObserver = observer; }
+
+void lemlib::Chassis::reportMotion(MotionType type, Pose target, bool forwards, int timeout, uint32_t start,
+                                   MotionResult result) {
+    publishMotionEnd();
+    if (!this->motionObserver) return;
+    this->motionObserver({type, target, forwards, timeout, start, getClock().millis(), result, getPose()});
+}
+
+/**
+ * @brief Work out how a motion that runs until it settles, exits early, times out or is cancelled ended
+ *
+ * @param timer the timer of the motion
+ * @param running whether the motion was still running when its loop ended
+ * @param exited whether the motion broke out of its loop before settling. false by default
+ * @return lemlib::MotionResult
+ */
+static lemlib::MotionResult motionResult(lemlib::Timer& timer, bool running, bool exited = false) {
+    if (!running) return lemlib::MotionResult::CANCELLED;
+    if (exited) return lemlib::MotionResult::EXITED;
+    if (timer.isDone()) return lemlib::MotionResult::TIMEOUT;
+    return lemlib::MotionResult::SETTLED;
+}
+
 /**
  * @brief Turn the chassis so it is facing the target point
  *
@@ -222,10 +255,10 @@ void lemlib::Chassis::turnTo(float x, float y, int timeout, bool forwards, float
     // were all motions cancelled?
     if (!this->motionRunning) return;
     // if the function is async, run it in a new task
-    if (async) {
+    if (async && getClock().supportsTasks()) {
         pros::Task task([&]() { turnTo(x, y, timeout, forwards, maxSpeed, false); });
         this->endMotion();
-        pros::delay(10); // delay to give the task time to start
+        getClock().delay(10); // delay to give the task time to start
         return;
     }
     float targetTheta;
@@ -234,6 +267,7 @@ void lemlib::Chassis::turnTo(float x, float y, int timeout, bool forwards, float
     float startTheta = getPose().theta;
     std::uint8_t compState = pros::competition::get_status();
     distTravelled = 0;
+    const uint32_t start = getClock().millis();
     Timer timer(timeout);
     angularLargeExit.reset();
     angularSmallExit.reset();
@@ -241,6 +275,8 @@ void lemlib::Chassis::turnTo(float x, float y, int timeout, bool forwards, float
 
     // main loop
     while (!timer.isDone() && !angularLargeExit.getExit() && !angularSmallExit.getExit() && this->motionRunning) {
+        TaskWork work(motionWork());
+        ProfileScope profile(LEMLIB_PROFILE_ZONE("motion.turnTo"));
         // update variables
         Pose pose = getPose();
         pose.theta = (forwards) ? fmod(pose.theta, 360) : fmod(pose.theta - 180, 360);
@@ -265,15 +301,21 @@ void lemlib::Chassis::turnTo(float x, float y, int timeout, bool forwards, float
         else if (motorPower < -maxSpeed) motorPower = -maxSpeed;
 
         // move the drivetrain
-        drivetrain.leftMotors->move(motorPower);
-        drivetrain.rightMotors->move(-motorPower);
-
-        pros::delay(10);
+        publishMotion({uint32_t(MotionType::TURN_TO), 0, x, y, targetTheta, distTravelled},
+                      {0, motorPower, motorPower, -motorPower});
+        queueOutput(drivetrain.leftMotors, motorPower);
+        queueOutput(drivetrain.rightMotors, -motorPower);
+
+        // don't count the wait for the next tick
+        profile.stop();
+        work.stop();
+        syncController();
     }
 
+    reportMotion(MotionType::TURN_TO, Pose(x, y), forwards, timeout, start, motionResult(timer, this->motionRunning));
     // stop the drivetrain
-    drivetrain.leftMotors->move(0);
-    drivetrain.rightMotors->move(0);
+    queueOutput(drivetrain.leftMotors, 0);
+    queueOutput(drivetrain.rightMotors, 0);
     // set distTraveled to -1 to indicate that the function has finished
     distTravelled = -1;
     this->endMotion();
@@ -298,10 +340,10 @@ void lemlib::Chassis::moveToPose(float x, float y, float theta, int timeout, Mov
     // were all motions cancelled?
     if (!this->motionRunning) return;
     // if the function is async, run it in a new task
-    if (async) {
+    if (async && getClock().supportsTasks()) {
         pros::Task task([&]() { moveToPose(x, y, theta, timeout, params, false); });
         this->endMotion();
-        pros::delay(10); // delay to give the task time to start
+        getClock().delay(10); // delay to give the task time to start
         return;
     }
 
@@ -323,10 +365,12 @@ void lemlib::Chassis::moveToPose(float x, float y, float theta, int timeout, Mov
     // initialize vars used between iterations
     Pose lastPose = getPose();
     distTravelled = 0;
+    const uint32_t start = getClock().millis();
     Timer timer(timeout);
     bool close = false;
     bool lateralSettled = false;
     bool prevSameSide = false;
+    bool exited = false;
     float prevLateralOut = 0; // previous lateral power
     float prevAngularOut = 0; // previous angular power
     const int compState = pros::competition::get_status();
@@ -335,6 +379,8 @@ void lemlib::Chassis::moveToPose(float x, float y, float theta, int timeout, Mov
     while (!timer.isDone() &&
            ((!lateralSettled || (!angularLargeExit.getExit() && !angularSmallExit.getExit())) || !close) &&
            this->motionRunning) {
+        TaskWork work(motionWork());
+        ProfileScope profile(LEMLIB_PROFILE_ZONE("motion.moveToPose"));
         // update position
         const Pose pose = getPose(true, true);
 
@@ -365,7 +411,10 @@ void lemlib::Chassis::moveToPose(float x, float y, float theta, int timeout, Mov
                                 (carrot.x - target.x) * cos(target.theta) + params.earlyExitRange;
         const bool sameSide = robotSide == carrotSide;
         // exit if close
-        if (!sameSide && prevSameSide && close && params.minSpeed != 0) break;
+        if (!sameSide && prevSameSide && close && params.minSpeed != 0) {
+            exited = true;
+            break;
+        }
         prevSameSide = sameSide;
 
         // calculate error
@@ -434,16 +483,22 @@ void lemlib::Chassis::moveToPose(float x, float y, float theta, int timeout, Mov
         }
 
         // move the drivetrain
-        drivetrain.leftMotors->move(leftPower);
-        drivetrain.rightMotors->move(rightPower);
-
-        // delay to save resources
-        pros::delay(10);
+        publishMotion({uint32_t(MotionType::MOVE_TO_POSE), 0, x, y, theta, distTravelled},
+                      {lateralOut, angularOut, leftPower, rightPower});
+        queueOutput(drivetrain.leftMotors, leftPower);
+        queueOutput(drivetrain.rightMotors, rightPower);
+
+        // delay to save resources, without counting the wait for the next tick
+        profile.stop();
+        work.stop();
+        syncController();
     }
 
+    reportMotion(MotionType::MOVE_TO_POSE, Pose(x, y, theta), params.forwards, timeout, start,
+                 motionResult(timer, this->motionRunning, exited));
     // stop the drivetrain
-    drivetrain.leftMotors->move(0);
-    drivetrain.rightMotors->move(0);
+    queueOutput(drivetrain.leftMotors, 0);
+    queueOutput(drivetrain.rightMotors, 0);
     // set distTraveled to -1 to indicate that the function has finished
     distTravelled = -1;
     this->endMotion();
@@ -463,10 +518,10 @@ void lemlib::Chassis::moveToPoint(float x, float y, int timeout, bool forwards,
     // were all motions cancelled?
     if (!this->motionRunning) return;
     // if the function is async, run it in a new task
-    if (async) {
+    if (async && getClock().supportsTasks()) {
         pros::Task task([&]() { moveToPoint(x, y, timeout, forwards, maxSpeed, false); });
         this->endMotion();
-        pros::delay(10); // delay to give the task time to start
+        getClock().delay(10); // delay to give the task time to start
         return;
     }
 
@@ -482,6 +537,7 @@ void lemlib::Chassis::moveToPoint(float x, float y, int timeout, bool forwards,
     // initialize vars used between iterations
     Pose lastPose = getPose();
     distTravelled = 0;
+    const uint32_t start = getClock().millis();
     Timer timer(timeout);
     bool close = false;
     float prevLateralOut = 0; // previous lateral power
@@ -491,6 +547,8 @@ void lemlib::Chassis::moveToPoint(float x, float y, int timeout, bool forwards,
     // main loop
     while (!timer.isDone() && ((!lateralSmallExit.getExit() && !lateralLargeExit.getExit()) || !close) &&
            this->motionRunning) {
+        TaskWork work(motionWork());
+        ProfileScope profile(LEMLIB_PROFILE_ZONE("motion.moveToPoint"));
         // update position
         const Pose pose = getPose(true, true);
 
@@ -552,16 +610,21 @@ void lemlib::Chassis::moveToPoint(float x, float y, int timeout, bool forwards,
         }
 
         // move the drivetrain
-        drivetrain.leftMotors->move(leftPower);
-        drivetrain.rightMotors->move(rightPower);
-
-        // delay to save resources
-        pros::delay(10);
+        publishMotion({uint32_t(MotionType::MOVE_TO_POINT), 0, x, y, NAN, distTravelled},
+                      {lateralOut, angularOut, leftPower, rightPower});
+        queueOutput(drivetrain.leftMotors, leftPower);
+        queueOutput(drivetrain.rightMotors, rightPower);
+
+        // delay to save resources, without counting the wait for the next tick
+        profile.stop();
+        work.stop();
+        syncController();
     }
 
+    reportMotion(MotionType::MOVE_TO_POINT, target, forwards, timeout, start, motionResult(timer, this->motionRunning));
     // stop the drivetrain
-    drivetrain.leftMotors->move(0);
-    drivetrain.rightMotors->move(0);
+    queueOutput(drivetrain.leftMotors, 0);
+    queueOutput(drivetrain.rightMotors, 0);
     // set distTraveled to -1 to indicate that the function has finished
     distTravelled = -1;
     this->endMotion();
@@ -0,0 +1,174 @@
+#include <atomic>
+#include <algorithm>
+#include "pros/rtos.hpp"
+#include "lemlib/chassis/executive.hpp"
+#include "lemlib/chassis/odom.hpp"
+#include "lemlib/output.hpp"
+#include "lemlib/clock.hpp"
+#include "lemlib/taskMonitor.hpp"
+
+// the odometry task, which the executive replaces
+extern pros::Task* trackingTask;
+
+namespace lemlib {
+// executive task
+static pros::Task* executiveTask = nullptr;
+static uint32_t executivePeriod = 10;
+
+// the task of the motion that is currently being synchronized with the executive
+static std::atomic<pros::task_t> controllerTask = nullptr;
+
+// timing statistics
+static pros::Mutex statsMutex;
+static ExecutiveStats stats;
+
+/**
+ * @brief Record the duration of a stage
+ *
+ * @param durations durations of each stage on this tick, in microseconds
+ * @param stage the stage
+ * @param start when the stage started, in microseconds
+ * @return uint64_t when the stage ended, in microseconds
+ */
+static uint64_t recordStage(uint32_t* durations, Stage stage, uint64_t start) {
+    const uint64_t end = getClock().micros();
+    durations[static_cast<int>(stage)] = end - start;
+    return end;
+}
+
+/**
+ * @brief The loop run by the executive task
+ *
+ */
+static void executiveLoop() {
+    uint32_t prevTime = getClock().millis();
+    MonitoredTask* const monitor = monitoredTask("executive");
+    while (true) {
+        TaskWork work(monitor);
+        const uint64_t tickStart = getClock().micros();
+        uint64_t stageStart = tickStart;
+        uint32_t durations[4] = {};
+        bool controllerMissed = false;
+
+        // sample sensors as close together as possible
+        sampleSensors();
+        stageStart = recordStage(durations, Stage::SENSORS, stageStart);
+
+        // update odometry
+        integrate();
+        stageStart = recordStage(durations, Stage::ODOMETRY, stageStart);
+
+        // run the active controller, and wait for it to finish within the rest of the period
+        const pros::task_t controller = controllerTask;
+        if (controller != nullptr) {
+            const uint32_t elapsed = (stageStart - tickStart) / 1000;
+            const uint32_t budget = std::max<int32_t>(int32_t(executivePeriod) - int32_t(elapsed) - 1, 1);
+            // drop notifications left over from a controller that missed an earlier tick. task_notify_clear only
+            // clears the pending state, not the count
+            pros::c::task_notify_take(true, 0);
+            pros::c::task_notify(controller);
+            controllerMissed = pros::c::task_notify_take(true, budget) == 0;
+        }
+        stageStart = recordStage(durations, Stage::CONTROLLER, stageStart);
+
+        // send motor output
+        flushOutput();
+        stageStart = recordStage(durations, Stage::MOTOR_OUTPUT, stageStart);
+
+        // check whether this tick overran, or started late
+        const bool missed =
+            stageStart - tickStart > executivePeriod * 1000 || getClock().millis() > prevTime + executivePeriod;
+
+        // update statistics
+        statsMutex.take();
+        for (int i = 0; i < 4; i++) {
+            StageTiming& timing = stats.stages[i];
+            timing.last = durations[i];
+            timing.max = std::max(timing.max, durations[i]);
+            timing.total += durations[i];
+        }
+        stats.ticks++;
+        if (missed) stats.deadlineMisses++;
+        if (controllerMissed) stats.controllerMisses++;
+        statsMutex.give();
+
+        work.stop();
+        getClock().delayUntil(&prevTime, executivePeriod);
+    }
+}
+
+/**
+ * @brief Start the control executive
+ *
+ * @param period how often the executive runs, in milliseconds. 10 by default
+ */
+void startExecutive(uint32_t period) {
+    if (executiveTask != nullptr || !getClock().supportsTasks()) return;
+    // the executive updates odometry itself
+    if (trackingTask != nullptr) {
+        trackingTask->remove();
+        delete trackingTask;
+        trackingTask = nullptr;
+    }
+    executivePeriod = period;
+    // run above the motion tasks so the stages can't be preempted by them
+    executiveTask = new pros::Task(executiveLoop, TASK_PRIORITY_DEFAULT + 1, TASK_STACK_DEPTH_DEFAULT, "executive");
+}
+
+/**
+ * @brief Whether the control executive is running
+ *
+ * @return true the executive is running
+ * @return false the executive is not running
+ */
+bool executiveRunning() { return executiveTask != nullptr; }
+
+/**
+ * @brief Get the timing statistics of the control executive
+ *
+ * @return ExecutiveStats
+ */
+ExecutiveStats getExecutiveStats() {
+    statsMutex.take();
+    const ExecutiveStats copy = stats;
+    statsMutex.give();
+    return copy;
+}
+
+/**
+ * @brief Reset the timing statistics of the control executive
+ *
+ */
+void resetExecutiveStats() {
+    statsMutex.take();
+    stats = {};
+    statsMutex.give();
+}
+
+/**
+ * @brief Finish an iteration of a motion controller
+ *
+ */
+void syncController() {
+    if (executiveTask == nullptr) {
+        getClock().delay(10);
+        return;
+    }
+    const pros::task_t current = pros::c::task_get_current();
+    // drop a notification the executive sent before this task became the controller, like one that raced with an
+    // earlier releaseController, so the first wait doesn't return before the next tick
+    if (controllerTask.exchange(current) != current) pros::c::task_notify_take(true, 0);
+    // tell the executive this iteration is done, then wait for fresh odometry
+    executiveTask->notify();
+    pros::c::task_notify_take(true, executivePeriod * 10);
+}
+
+/**
+ * @brief Stop the calling task from being synchronized with the executive
+ *
+ */
+void releaseController() {
+    pros::task_t current = pros::c::task_get_current();
+    controllerTask.compare_exchange_strong(current, nullptr);
+}
+} // namespace lemlib
@@ -20,6 +20,10 @@
 #include "lemlib/chassis/odom.hpp"
 #include "lemlib/chassis/chassis.hpp"
 #include "lemlib/chassis/trackingWheel.hpp"
+#include "lemlib/chassis/executive.hpp"
+#include "lemlib/clock.hpp"
+#include "lemlib/profiler.hpp"
+#include "lemlib/taskMonitor.hpp"
 
 // tracking thread
 pros::Task* trackingTask = nullptr;
@@ -39,6 +43,13 @@ float prevHorizontal1 = 0;
 float prevHorizontal2 = 0;
 float prevImu = 0;
 
+// the last sensor sample
+float sampledVertical1 = 0;
+float sampledVertical2 = 0;
+float sampledHorizontal1 = 0;
+float sampledHorizontal2 = 0;
+float sampledImu = 0;
+
 /**
  * @brief Set the sensors to be used for odometry
  *
@@ -121,22 +132,36 @@ lemlib::Pose lemlib::estimatePose(float time, bool radians) {
 }
 
 /**
- * @brief Update the pose of the robot
+ * @brief Sample the odometry sensors
  *
  */
-void lemlib::update() {
+void lemlib::sampleSensors() {
+    LEMLIB_PROFILE("odom.sample");
+    sampledVertical1 = 0;
+    sampledVertical2 = 0;
+    sampledHorizontal1 = 0;
+    sampledHorizontal2 = 0;
+    sampledImu = 0;
+    if (odomSensors.vertical1 != nullptr) sampledVertical1 = odomSensors.vertical1->getDistanceTraveled();
+    if (odomSensors.vertical2 != nullptr) sampledVertical2 = odomSensors.vertical2->getDistanceTraveled();
+    if (odomSensors.horizontal1 != nullptr) sampledHorizontal1 = odomSensors.horizontal1->getDistanceTraveled();
+    if (odomSensors.horizontal2 != nullptr) sampledHorizontal2 = odomSensors.horizontal2->getDistanceTraveled();
+    if (odomSensors.imu != nullptr) sampledImu = degToRad(odomSensors.imu->get_rotation());
+}
+
+/**
+ * @brief Update the pose of the robot using the last sensor sample
+ *
+ */
+void lemlib::integrate() {
+    LEMLIB_PROFILE("odom.integrate");
     // TODO: add particle filter
-    // get the current sensor values
-    float vertical1Raw = 0;
-    float vertical2Raw = 0;
-    float horizontal1Raw = 0;
-    float horizontal2Raw = 0;
-    float imuRaw = 0;
-    if (odomSensors.vertical1 != nullptr) vertical1Raw = odomSensors.vertical1->getDistanceTraveled();
-    if (odomSensors.vertical2 != nullptr) vertical2Raw = odomSensors.vertical2->getDistanceTraveled();
-    if (odomSensors.horizontal1 != nullptr) horizontal1Raw = odomSensors.horizontal1->getDistanceTraveled();
-    if (odomSensors.horizontal2 != nullptr) horizontal2Raw = odomSensors.horizontal2->getDistanceTraveled();
-    if (odomSensors.imu != nullptr) imuRaw = degToRad(odomSensors.imu->get_rotation());
+    // get the sampled sensor values
+    const float vertical1Raw = sampledVertical1;
+    const float vertical2Raw = sampledVertical2;
+    const float horizontal1Raw = sampledHorizontal1;
+    const float horizontal2Raw = sampledHorizontal2;
+    const float imuRaw = sampledImu;
 
     // calculate the change in sensor values
     float deltaVertical1 = vertical1Raw - prevVertical1;
@@ -187,8 +212,9 @@ void lemlib::update() {
     else if (odomSensors.horizontal2 != nullptr) horizontalWheel = odomSensors.horizontal2;
     float rawVertical = 0;
     float rawHorizontal = 0;
-    if (verticalWheel != nullptr) rawVertical = verticalWheel->getDistanceTraveled();
-    if (horizontalWheel != nullptr) rawHorizontal = horizontalWheel->getDistanceTraveled();
+    if (verticalWheel != nullptr) rawVertical = verticalWheel == odomSensors.vertical1 ? vertical1Raw : vertical2Raw;
+    if (horizontalWheel != nullptr)
+        rawHorizontal = horizontalWheel == odomSensors.horizontal1 ? horizontal1Raw : horizontal2Raw;
     float horizontalOffset = 0;
     float verticalOffset = 0;
     if (verticalWheel != nullptr) verticalOffset = verticalWheel->getOffset();
@@ -234,16 +260,31 @@ void lemlib::update() {
     odomLocalSpeed.theta = ema(deltaHeading / 0.01, odomLocalSpeed.theta, 0.95);
 }
 
+/**
+ * @brief Update the pose of the robot
+ *
+ */
+void lemlib::update() {
+    LEMLIB_PROFILE("odom.update");
+    sampleSensors();
+    integrate();
+}
+
 /**
  * @brief Initialize the odometry system
  *
+ * Does nothing if the control executive is running, as it updates odometry itself, or if the clock doesn't support
+ * background tasks
  */
 void lemlib::init() {
-    if (trackingTask == nullptr) {
+    if (trackingTask == nullptr && !executiveRunning() && getClock().supportsTasks()) {
         trackingTask = new pros::Task {[=] {
+            MonitoredTask* const monitor = monitoredTask("odometry");
             while (true) {
+                TaskWork work(monitor);
                 update();
-                pros::delay(10);
+                work.stop();
+                getClock().delay(10);
             }
         }};
     }
@@ -1,4 +1,5 @@
 #include "lemlib/chassis/chassis.hpp"
+#include "lemlib/output.hpp"
 #include <algorithm>
 #include <math.h>
 
@@ -31,8 +32,8 @@ float defaultDriveCurve(float input, float scale) {
  * curve, refer to the `defaultDriveCurve` documentation.
  */
 void Chassis::tank(int left, int right, float curveGain) {
-    drivetrain.leftMotors->move(driveCurve(left, curveGain));
-    drivetrain.rightMotors->move(driveCurve(right, curveGain));
+    queueOutput(drivetrain.leftMotors, driveCurve(left, curveGain));
+    queueOutput(drivetrain.rightMotors, driveCurve(right, curveGain));
 }
 
 /**
@@ -45,10 +46,10 @@ void Chassis::tank(int left, int right, float curveGain) {
  * curve, refer to the `defaultDriveCurve` documentation.
  */
 void Chassis::arcade(int throttle, int turn, float curveGain) {
-    int leftPower = driveCurve(throttle + turn, curveGain);
-    int rightPower = driveCurve(throttle - turn, curveGain);
-    drivetrain.leftMotors->move(leftPower);
-    drivetrain.rightMotors->move(rightPower);
+    float leftPower = driveCurve(throttle + turn, curveGain);
+    float rightPower = driveCurve(throttle - turn, curveGain);
+    queueOutput(drivetrain.leftMotors, leftPower);
+    queueOutput(drivetrain.rightMotors, rightPower);
 }
 
 /**
@@ -74,7 +75,7 @@ void Chassis::curvature(int throttle, int turn, float curveGain) {
     leftPower = driveCurve(leftPower, curveGain);
     rightPower = driveCurve(rightPower, curveGain);
 
-    drivetrain.leftMotors->move(leftPower);
-    drivetrain.rightMotors->move(rightPower);
+    queueOutput(drivetrain.leftMotors, leftPower);
+    queueOutput(drivetrain.rightMotors, rightPower);
 }
 } // namespace lemlib
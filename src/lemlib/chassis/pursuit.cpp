@@ -14,11 +14,20 @@
 // https://www.chiefdelphi.com/uploads/default/original/3X/b/e/be0e06de00e07db66f97686505c3f4dde2e332dc.pdf
 
 #include <cmath>
+#include <map>
+#include <utility>
 #include <vector>
 #include <string>
 #include "pros/misc.hpp"
+#include "pros/rtos.hpp"
 #include "lemlib/chassis/chassis.hpp"
+#include "lemlib/chassis/executive.hpp"
+#include "lemlib/output.hpp"
 #include "lemlib/util.hpp"
+#include "lemlib/clock.hpp"
+#include "lemlib/profiler.hpp"
+#include "lemlib/taskMonitor.hpp"
+#include "lemlib/telemetry.hpp"
 
 /**
  * @brief function that returns elements in a file line, separated by a delimeter
@@ -52,11 +61,21 @@ std::vector<std::string> readElement(const std::string& input, std::string delim
  * @return std::vector<lemlib::Pose> vector of points on the path
  */
 std::vector<lemlib::Pose> getData(const asset& path) {
+    LEMLIB_PROFILE("path.load");
     std::vector<lemlib::Pose> robotPath;
     std::string line;
     std::vector<std::string> pointInput;
     lemlib::Pose pathPoint(0, 0, 0);
 
+    // typed paths hold the points already, so there is nothing to parse
+    const lemlib::AssetHeader* header = lemlib::assetHeader(path);
+    if (header != nullptr && header->type == lemlib::AssetType::PATH_POINT) {
+        for (const lemlib::AssetPoint& point : lemlib::assetView<lemlib::AssetPoint>(path)) {
+            robotPath.emplace_back(point.x, point.y, point.speed);
+        }
+        return robotPath;
+    }
+
     // format data from the asset
     std::string data(reinterpret_cast<char*>(path.buf), path.size);
     std::vector<std::string> dataLines = readElement(data, "\n");
@@ -74,6 +93,26 @@ std::vector<lemlib::Pose> getData(const asset& path) {
     return robotPath;
 }
 
+/**
+ * @brief Get a path, parsing it only the first time it is followed
+ *
+ * Assets are baked into the program, so a path is identified by where it is and how long it is. The cached points are
+ * never freed, so the returned reference stays valid while other paths are loaded.
+ *
+ * @param path the path asset
+ * @return const std::vector<lemlib::Pose>& points on the path
+ */
+const std::vector<lemlib::Pose>& loadPath(const asset& path) {
+    static pros::Mutex cacheMutex;
+    static std::map<std::pair<const uint8_t*, size_t>, std::vector<lemlib::Pose>> cache;
+    const std::pair<const uint8_t*, size_t> key(path.buf, path.size);
+    cacheMutex.take();
+    auto it = cache.find(key);
+    if (it == cache.end()) it = cache.emplace(key, getData(path)).first;
+    cacheMutex.give();
+    return it->second;
+}
+
 /**
  * @brief find the closest point on the path to the robot
  *
@@ -81,8 +120,8 @@ std::vector<lemlib::Pose> getData(const asset& path) {
  * @param path the path to follow
  * @return int index to the closest point
  */
-int findClosest(lemlib::Pose pose, std::vector<lemlib::Pose> path) {
-    int closestPoint;
+int findClosest(lemlib::Pose pose, const std::vector<lemlib::Pose>& path) {
+    int closestPoint = 0;
     float closestDist = 1000000;
     float dist;
 
@@ -140,7 +179,7 @@ float circleIntersect(lemlib::Pose p1, lemlib::Pose p2, lemlib::Pose pose, float
  * @param path - the path to follow
  * @param lookaheadDist - the lookahead distance of the algorithm
  */
-lemlib::Pose lookaheadPoint(lemlib::Pose lastLookahead, lemlib::Pose pose, std::vector<lemlib::Pose> path,
+lemlib::Pose lookaheadPoint(lemlib::Pose lastLookahead, lemlib::Pose pose, const std::vector<lemlib::Pose>& path,
                             float lookaheadDist) {
     // find the furthest lookahead point on the path
 
@@ -204,14 +243,14 @@ void lemlib::Chassis::follow(const asset& path, float lookahead, int timeout, bo
     // take the mutex
     mutex.take(TIMEOUT_MAX);
     // if the function is async, run it in a new task
-    if (async) {
+    if (async && getClock().supportsTasks()) {
         pros::Task task([&]() { follow(path, lookahead, timeout, forwards, false); });
         mutex.give();
-        pros::delay(10); // delay to give the task time to start
+        getClock().delay(10); // delay to give the task time to start
         return;
     }
 
-    std::vector<lemlib::Pose> pathPoints = getData(path); // get list of path points
+    const std::vector<lemlib::Pose>& pathPoints = loadPath(path); // get list of path points
     Pose pose = this->getPose(true);
     Pose lastPose = pose;
     Pose lookaheadPose(0, 0, 0);
@@ -226,10 +265,14 @@ void lemlib::Chassis::follow(const asset& path, float lookahead, int timeout, bo
     float rightInput = 0;
     int compState = pros::competition::get_status();
     distTravelled = 0;
+    const uint32_t start = getClock().millis();
+    MotionResult result = MotionResult::TIMEOUT;
 
     // loop until the robot is within the end tolerance
     for (int i = 0; i < timeout / 10 && pros::competition::get_status() == compState; i++) {
         // get the current position of the robot
+        lemlib::TaskWork work(motionWork());
+        lemlib::ProfileScope profile(LEMLIB_PROFILE_ZONE("motion.follow"));
         pose = this->getPose(true);
         if (!forwards) pose.theta -= M_PI;
 
@@ -240,7 +283,10 @@ void lemlib::Chassis::follow(const asset& path, float lookahead, int timeout, bo
         // find the closest point on the path to the robot
         closestPoint = findClosest(pose, pathPoints);
         // if the robot is at the end of the path, then stop
-        if (pathPoints.at(closestPoint).theta == 0) break;
+        if (pathPoints.at(closestPoint).theta == 0) {
+            result = MotionResult::SETTLED;
+            break;
+        }
 
         // find the lookahead point
         lookaheadPose = lookaheadPoint(lastLookahead, pose, pathPoints, lookahead);
@@ -269,22 +315,30 @@ void lemlib::Chassis::follow(const asset& path, float lookahead, int timeout, bo
         prevRightVel = targetRightVel;
 
         // move the drivetrain
+        publishMotion({uint32_t(MotionType::FOLLOW), 0, pathPoints.back().x, pathPoints.back().y, NAN, distTravelled},
+                      {targetVel, (targetLeftVel - targetRightVel) / 2, targetLeftVel, targetRightVel});
         if (forwards) {
-            drivetrain.leftMotors->move(targetLeftVel);
-            drivetrain.rightMotors->move(targetRightVel);
+            queueOutput(drivetrain.leftMotors, targetLeftVel);
+            queueOutput(drivetrain.rightMotors, targetRightVel);
         } else {
-            drivetrain.leftMotors->move(-targetRightVel);
-            drivetrain.rightMotors->move(-targetLeftVel);
+            queueOutput(drivetrain.leftMotors, -targetRightVel);
+            queueOutput(drivetrain.rightMotors, -targetLeftVel);
         }
 
-        pros::delay(10);
+        // don't count the wait for the next tick
+        profile.stop();
+        work.stop();
+        syncController();
     }
 
+    if (pros::competition::get_status() != compState) result = MotionResult::EXITED;
+    reportMotion(MotionType::FOLLOW, Pose(pathPoints.back().x, pathPoints.back().y), forwards, timeout, start, result);
     // stop the robot
-    drivetrain.leftMotors->move(0);
-    drivetrain.rightMotors->move(0);
+    queueOutput(drivetrain.leftMotors, 0);
+    queueOutput(drivetrain.rightMotors, 0);
     // set distTravelled to -1 to indicate that the function has finished
     distTravelled = -1;
+    releaseController();
     // give the mutex back
     mutex.give();
 }
@@ -0,0 +1,73 @@
+#include <algorithm>
+#include "pros/rtos.hpp"
+#include "lemlib/clock.hpp"
+
+namespace lemlib {
+uint32_t RtosClock::millis() { return pros::millis(); }
+
+uint64_t RtosClock::micros() { return pros::micros(); }
+
+void RtosClock::delay(uint32_t ms) { pros::delay(ms); }
+
+void RtosClock::delayUntil(uint32_t* prevTime, uint32_t delta) { pros::Task::delay_until(prevTime, delta); }
+
+/**
+ * @brief Construct a new Simulated Clock
+ *
+ * @param step how far time moves on every step, in microseconds. 1000 by default
+ */
+SimulatedClock::SimulatedClock(uint32_t step)
+    : step(step == 0 ? 1 : step) {}
+
+uint32_t SimulatedClock::millis() { return time / 1000; }
+
+uint64_t SimulatedClock::micros() { return time; }
+
+void SimulatedClock::delay(uint32_t ms) { advance(uint64_t(ms) * 1000); }
+
+void SimulatedClock::delayUntil(uint32_t* prevTime, uint32_t delta) {
+    const uint32_t wake = *prevTime + delta;
+    const uint32_t now = millis();
+    if (wake > now) delay(wake - now);
+    *prevTime = wake;
+}
+
+bool SimulatedClock::supportsTasks() { return false; }
+
+/**
+ * @brief Move time forwards
+ *
+ * @param us how far to move time, in microseconds
+ */
+void SimulatedClock::advance(uint64_t us) {
+    const uint64_t end = time + us;
+    while (time < end) {
+        time += std::min<uint64_t>(step, end - time);
+        if (stepCallback) stepCallback(millis());
+    }
+}
+
+/**
+ * @brief Set the function called every time the clock moves one step
+ *
+ * @param callback function that takes the new time in milliseconds
+ */
+void SimulatedClock::onStep(std::function<void(uint32_t)> callback) { stepCallback = callback; }
+
+static RtosClock rtosClock;
+static Clock* currentClock = &rtosClock;
+
+/**
+ * @brief Get the clock LemLib uses
+ *
+ * @return Clock&
+ */
+Clock& getClock() { return *currentClock; }
+
+/**
+ * @brief Set the clock LemLib uses
+ *
+ * @param clock the new clock
+ */
+void setClock(Clock& clock) { currentClock = &clock; }
+} // namespace lemlib
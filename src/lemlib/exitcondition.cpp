@@ -1,6 +1,7 @@
 #include <cmath>
 #include "pros/rtos.hpp"
 #include "lemlib/exitcondition.hpp"
+#include "lemlib/clock.hpp"
 
 namespace lemlib {
 
@@ -30,7 +31,7 @@ bool ExitCondition::getExit() { return done; }
  * @return false exit condition not met
  */
 bool ExitCondition::update(const float input) {
-    const int curTime = pros::millis();
+    const int curTime = getClock().millis();
     if (std::fabs(input) > range) startTime = -1;
     else if (startTime == -1) startTime = curTime;
     else if (curTime >= startTime + time) done = true;
@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <cmath>
+#include "lemlib/lift.hpp"
+#include "lemlib/output.hpp"
+#include "lemlib/taskMonitor.hpp"
+#include "lemlib/clock.hpp"
+#include "lemlib/util.hpp"
+
+namespace lemlib {
+// the controller runs every 10ms, like every motion in LemLib
+static constexpr int LIFT_PERIOD = 10;
+
+/**
+ * @brief Construct a new Lift
+ *
+ * @param motor the motor that drives the arm
+ * @param sensor the rotation sensor that measures the arm, or nullptr to use the motor's encoder
+ * @param settings the gains and limits of the lift
+ */
+Lift::Lift(pros::Motor* motor, pros::Rotation* sensor, LiftSettings settings)
+    : motor(motor),
+      sensor(sensor),
+      settings(settings),
+      pid(settings.kP, settings.kI, settings.kD, settings.windupRange),
+      exit(settings.settleRange, settings.settleTime) {}
+
+/**
+ * @brief Move the arm to an angle, and hold it there
+ *
+ * @param angle the target, in degrees of the arm
+ */
+void Lift::setTarget(float angle) {
+    mutex.take();
+    if (!running) {
+        // start the profile from where the arm is
+        profileAngle = getAngle();
+        profileVelocity = 0;
+        pid.reset();
+    }
+    target = angle;
+    exit.reset();
+    settled = false;
+    running = true;
+    mutex.give();
+    if (task == nullptr && getClock().supportsTasks()) {
+        task = new pros::Task([this] { taskLoop(); }, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "lemlib lift");
+    } else if (task != nullptr) {
+        task->notify();
+    }
+}
+
+/**
+ * @brief Get the target
+ *
+ * @return float degrees of the arm
+ */
+float Lift::getTarget() {
+    mutex.take();
+    const float copy = target;
+    mutex.give();
+    return copy;
+}
+
+/**
+ * @brief Get the angle of the arm
+ *
+ * @return float degrees of the arm
+ */
+float Lift::getAngle() {
+    // the rotation sensor reports centidegrees, and the motor degrees
+    const float degrees = sensor != nullptr ? sensor->get_position() / 100.0f : motor->get_position();
+    return degrees / settings.gearRatio;
+}
+
+/**
+ * @brief Whether the arm has reached its target and stayed there for the settle time
+ *
+ * @return true the arm has settled, or isn't being controlled
+ */
+bool Lift::isSettled() { return settled; }
+
+/**
+ * @brief Wait until the arm has settled
+ *
+ * @param timeout longest time to wait, in milliseconds
+ * @return true the arm settled before the timeout
+ */
+bool Lift::waitUntilSettled(int timeout) {
+    const uint32_t start = getClock().millis();
+    const uint32_t duration = std::max(timeout, 0);
+    while (!settled && getClock().millis() - start < duration) {
+        // without a task, the caller runs the controller
+        if (task == nullptr) update();
+        getClock().delay(LIFT_PERIOD);
+    }
+    return settled;
+}
+
+/**
+ * @brief Stop controlling the arm, and send the motor 0 power
+ *
+ */
+void Lift::stop() { setVoltage(0); }
+
+/**
+ * @brief Stop controlling the arm, and drive the motor at a voltage
+ *
+ * @param voltage the voltage, in millivolts
+ */
+void Lift::setVoltage(int voltage) {
+    // queued under the mutex, so an update that already took it can't queue its output after this
+    mutex.take();
+    running = false;
+    settled = true;
+    queueVoltage(motor, voltage);
+    mutex.give();
+}
+
+/**
+ * @brief Stop controlling the arm, and drive the motor at a velocity
+ *
+ * @param velocity the velocity, in rpm
+ */
+void Lift::setVelocity(int velocity) {
+    mutex.take();
+    running = false;
+    settled = true;
+    queueVelocity(motor, velocity);
+    mutex.give();
+}
+
+/**
+ * @brief Run one iteration of the controller
+ *
+ * Moves the profile one period towards the target, then drives the arm towards the profile.
+ */
+void Lift::update() {
+    mutex.take();
+    if (!running) {
+        mutex.give();
+        return;
+    }
+    const float dt = LIFT_PERIOD / 1000.0f;
+    const float accel = settings.maxAcceleration;
+
+    // trapezoidal profile: slow down once the stopping distance reaches the target, otherwise head for top speed
+    const float remaining = target - profileAngle;
+    const float stopping = profileVelocity * profileVelocity / (2 * accel);
+    const bool braking = std::fabs(remaining) <= stopping && sgn(profileVelocity) == sgn(remaining);
+    const float desired = braking ? 0 : sgn(remaining) * settings.maxVelocity;
+    profileVelocity += std::clamp(desired - profileVelocity, -accel * dt, accel * dt);
+    profileAngle += profileVelocity * dt;
+    // snap to the target instead of overshooting it
+    if (remaining * (target - profileAngle) <= 0) {
+        profileAngle = target;
+        profileVelocity = 0;
+    }
+
+    const float angle = getAngle();
+    const float gravity = settings.kG * std::cos(degToRad(angle - settings.horizontalAngle));
+    const float power = pid.update(profileAngle - angle) + settings.kV * profileVelocity + gravity;
+    queueOutput(motor, std::clamp(power, -127.0f, 127.0f));
+
+    // only settle once the profile has finished, so a slow profile isn't mistaken for a stalled arm
+    if (profileAngle == target && exit.update(target - angle)) settled = true;
+    mutex.give();
+}
+
+/**
+ * @brief The function run by the lift's task
+ *
+ * Runs the controller every period while there is a target, and sleeps until there is one otherwise.
+ */
+void Lift::taskLoop() {
+    MonitoredTask* const monitor = monitoredTask("lemlib lift");
+    uint32_t prevTime = getClock().millis();
+    while (true) {
+        if (!running) {
+            // wait for a target instead of polling
+            pros::Task::notify_take(true, TIMEOUT_MAX);
+            prevTime = getClock().millis();
+            continue;
+        }
+        TaskWork work(monitor);
+        update();
+        work.stop();
+        getClock().delayUntil(&prevTime, LIFT_PERIOD);
+    }
+}
+} // namespace lemlib
@@ -1,6 +1,21 @@
 #include "lemlib/logger/baseSink.hpp"
 
 namespace lemlib {
+/**
+ * @brief Get the name of a level, without allocating
+ *
+ */
+static fmt::string_view levelName(Level level) {
+    switch (level) {
+        case Level::DEBUG: return "DEBUG";
+        case Level::INFO: return "INFO";
+        case Level::WARN: return "WARN";
+        case Level::ERROR: return "ERROR";
+        case Level::FATAL: return "FATAL";
+    }
+    __builtin_unreachable();
+}
+
 BaseSink::BaseSink(std::initializer_list<std::shared_ptr<BaseSink>> sinks) { this->sinks = sinks; }
 
 void BaseSink::setLowestLevel(Level lowestLevel) {
@@ -12,7 +27,80 @@ void BaseSink::setLowestLevel(Level lowestLevel) {
     this->lowestLevel = lowestLevel;
 }
 
-void BaseSink::setFormat(const std::string& logFormat) { this->logFormat = logFormat; }
+void BaseSink::setDeferred(bool deferred) {
+    if (!sinks.empty()) {
+        for (std::shared_ptr<BaseSink> sink : sinks) { sink->setDeferred(deferred); }
+        return;
+    }
+
+    this->deferred = deferred;
+}
+
+void BaseSink::sendFormatted(Level level, uint32_t time, fmt::string_view messageString) {
+    Message message = Message {.message = {}, .level = level, .time = time};
+
+    if (!segments.empty()) {
+        // fill in the parsed format on the stack, so the only allocation is the message itself
+        fmt::memory_buffer out;
+        for (const FormatSegment& segment : segments) {
+            switch (segment.field) {
+                case FormatSegment::Field::LITERAL: out.append(segment.literal); break;
+                case FormatSegment::Field::TIME: fmt::format_to(fmt::appender(out), "{}", time); break;
+                case FormatSegment::Field::LEVEL: out.append(levelName(level)); break;
+                case FormatSegment::Field::MESSAGE: out.append(messageString); break;
+            }
+        }
+        message.message.assign(out.data(), out.size());
+        sendMessage(message);
+        return;
+    }
+
+    // get the arguments
+    fmt::dynamic_format_arg_store<fmt::format_context> formattingArgs = getExtraFormattingArgs(message);
+
+    formattingArgs.push_back(fmt::arg("time", message.time));
+    formattingArgs.push_back(fmt::arg("level", message.level));
+    formattingArgs.push_back(fmt::arg("message", messageString));
+
+    std::string formattedString = fmt::vformat(logFormat, std::move(formattingArgs));
+    message.message = std::move(formattedString);
+    sendMessage(std::move(message));
+}
+
+void BaseSink::setFormat(const std::string& logFormat) {
+    this->logFormat = logFormat;
+    segments.clear();
+    std::string literal;
+    for (size_t i = 0; i < logFormat.size(); i++) {
+        const char c = logFormat[i];
+        // escaped braces
+        if ((c == '{' || c == '}') && i + 1 < logFormat.size() && logFormat[i + 1] == c) {
+            literal += c;
+            i++;
+            continue;
+        }
+        if (c != '{') {
+            literal += c;
+            continue;
+        }
+        const size_t end = logFormat.find('}', i);
+        const std::string name = logFormat.substr(i + 1, end == std::string::npos ? end : end - i - 1);
+        FormatSegment::Field field;
+        if (name == "time") field = FormatSegment::Field::TIME;
+        else if (name == "level") field = FormatSegment::Field::LEVEL;
+        else if (name == "message") field = FormatSegment::Field::MESSAGE;
+        else {
+            // an extra argument or a format spec, so leave the whole format to fmt
+            segments.clear();
+            return;
+        }
+        if (!literal.empty()) segments.push_back({FormatSegment::Field::LITERAL, std::move(literal)});
+        literal.clear();
+        segments.push_back({field, ""});
+        i = end;
+    }
+    if (!literal.empty()) segments.push_back({FormatSegment::Field::LITERAL, std::move(literal)});
+}
 
 fmt::dynamic_format_arg_store<fmt::format_context> BaseSink::getExtraFormattingArgs(const Message& messageInfo) {
     return {};
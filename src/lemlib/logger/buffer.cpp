@@ -1,43 +1,192 @@
 #define FMT_HEADER_ONLY
+#include <algorithm>
+#include <cstring>
 #include "fmt/core.h"
 #include "lemlib/logger/buffer.hpp"
 #include "lemlib/logger/message.hpp"
+#include "lemlib/taskMonitor.hpp"
 
 namespace lemlib {
-Buffer::Buffer(std::function<void(const std::string&)> bufferFunc)
+/**
+ * @brief Round up to a power of 2, so positions can wrap around the ring with a mask
+ *
+ */
+static uint32_t ringSize(size_t capacity) {
+    uint32_t size = 1;
+    while (size < capacity) size <<= 1;
+    return size;
+}
+
+std::unique_ptr<Buffer::Slot[]> Buffer::makeSlots(uint32_t size) {
+    std::unique_ptr<Slot[]> created(new Slot[size]);
+    // each slot starts free for the producer at its own position
+    for (uint32_t i = 0; i < size; i++) created[i].sequence.store(i, std::memory_order_relaxed);
+    return created;
+}
+
+Buffer::Buffer(std::function<void(const std::string&)> bufferFunc, size_t capacity, OverflowPolicy policy)
     : bufferFunc(bufferFunc),
+      slots(makeSlots(ringSize(capacity))),
+      mask(ringSize(capacity) - 1),
+      policy(policy),
       task([=]() { taskLoop(); }) {}
 
 bool Buffer::buffersEmpty() {
-    mutex.take();
-    bool status = buffer.size() == 0;
-    mutex.give();
-    return status;
+    return enqueuePos.load(std::memory_order_acquire) == dequeuePos.load(std::memory_order_acquire);
 }
 
 Buffer::~Buffer() {
-    // make sure when the destructor is called so all
-    // the messages are logged
-    while (!buffersEmpty()) { pros::delay(10); }
+    // stop the task before the members it uses are destroyed, then make sure all the messages are logged. The task is
+    // removed while this holds the write mutex, so it can't be removed halfway through a write and keep the mutex
+    writeMutex.take();
+    task.remove();
+    writeMutex.give();
+    flush();
+}
+
+bool Buffer::tryPush(DeferredFunc func, const void* data, size_t size) {
+    uint32_t pos = enqueuePos.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+        slot = &slots[pos & mask];
+        const int32_t diff = slot->sequence.load(std::memory_order_acquire) - pos;
+        if (diff == 0) {
+            // the slot is free. Claim it, unless another producer got there first
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            // the slot still holds a string from a lap ago
+            return false;
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+    slot->size = std::min(size, MAX_MESSAGE_SIZE);
+    slot->func = func;
+    std::memcpy(slot->data, data, slot->size);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+
+    const uint32_t queued = pos + 1 - dequeuePos.load(std::memory_order_relaxed);
+    uint32_t prevPeak = peak.load(std::memory_order_relaxed);
+    while (queued > prevPeak && !peak.compare_exchange_weak(prevPeak, queued, std::memory_order_relaxed));
+    return true;
 }
 
-void Buffer::pushToBuffer(const std::string& bufferData) {
-    mutex.take();
-    buffer.push_back(bufferData);
-    mutex.give();
+bool Buffer::tryPop(std::string* out, DeferredCall* call) {
+    uint32_t pos = dequeuePos.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+        slot = &slots[pos & mask];
+        const int32_t diff = slot->sequence.load(std::memory_order_acquire) - (pos + 1);
+        if (diff == 0) {
+            // producers that overwrite the oldest string pop too, so the consumer has to claim the slot as well
+            if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            // empty, or the next string is still being written
+            return false;
+        } else {
+            pos = dequeuePos.load(std::memory_order_relaxed);
+        }
+    }
+    if (slot->func == nullptr && out != nullptr) out->append(slot->data, slot->size);
+    if (slot->func != nullptr && call != nullptr) {
+        call->func = slot->func;
+        std::memcpy(call->data, slot->data, slot->size);
+    }
+    slot->sequence.store(pos + mask + 1, std::memory_order_release);
+    return true;
+}
+
+void Buffer::pushToBuffer(std::string_view bufferData) {
+    if (bufferData.size() > MAX_MESSAGE_SIZE) truncated.fetch_add(1, std::memory_order_relaxed);
+    push(nullptr, bufferData.data(), bufferData.size());
+}
+
+void Buffer::pushFramed(std::string_view prefix, std::string_view message, std::string_view suffix) {
+    char text[MAX_MESSAGE_SIZE];
+    // the framing is kept whole, unless it doesn't fit by itself
+    const size_t suffixSize = std::min(suffix.size(), MAX_MESSAGE_SIZE);
+    const size_t prefixSize = std::min(prefix.size(), MAX_MESSAGE_SIZE - suffixSize);
+    const size_t messageSize = std::min(message.size(), MAX_MESSAGE_SIZE - suffixSize - prefixSize);
+    if (prefixSize + message.size() + suffix.size() > MAX_MESSAGE_SIZE) {
+        truncated.fetch_add(1, std::memory_order_relaxed);
+    }
+    std::memcpy(text, prefix.data(), prefixSize);
+    std::memcpy(text + prefixSize, message.data(), messageSize);
+    std::memcpy(text + prefixSize + messageSize, suffix.data(), suffixSize);
+    push(nullptr, text, prefixSize + messageSize + suffixSize);
+}
+
+void Buffer::pushDeferred(DeferredFunc func, const void* data, size_t size) { push(func, data, size); }
+
+bool Buffer::appendToBatch(const void* data, size_t size) {
+    // any other task sees a different task, so it only ever reads, and only the writer touches the batch
+    if (!draining.load(std::memory_order_acquire) || drainingTask.load() != pros::c::task_get_current()) return false;
+    batch.append(static_cast<const char*>(data), std::min(size, MAX_MESSAGE_SIZE));
+    return true;
+}
+
+void Buffer::push(DeferredFunc func, const void* data, size_t size) {
+    pushed.fetch_add(1, std::memory_order_relaxed);
+    if (func == nullptr && appendToBatch(data, size)) return;
+    bool queued = tryPush(func, data, size);
+    // make room by discarding the oldest entry. Give up after a few tries, so a push always finishes quickly
+    for (int i = 0; i < 4 && !queued && policy.load(std::memory_order_relaxed) == OverflowPolicy::DROP_OLDEST; i++) {
+        if (tryPop(nullptr, nullptr)) dropped.fetch_add(1, std::memory_order_relaxed);
+        queued = tryPush(func, data, size);
+    }
+    if (!queued) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    // only notify the task when it is waiting for a string
+    if (waiting.exchange(false)) task.notify();
 }
 
 void Buffer::setRate(uint32_t rate) { this->rate = rate; }
 
+void Buffer::setOverflowPolicy(OverflowPolicy policy) { this->policy = policy; }
+
+BufferStats Buffer::getStats() {
+    return {pushed.load(std::memory_order_relaxed), dropped.load(std::memory_order_relaxed),
+            truncated.load(std::memory_order_relaxed), writes.load(std::memory_order_relaxed),
+            peak.load(std::memory_order_relaxed)};
+}
+
+void Buffer::flush() {
+    writeMutex.take();
+    batch.clear();
+    // what deferred functions push is appended to the batch right away, where the function was queued. Stop after two
+    // laps of the ring, so producers can't keep the writer busy forever
+    DeferredCall call;
+    drainingTask = pros::c::task_get_current();
+    for (uint32_t i = 0; i <= 2 * mask + 1; i++) {
+        call.func = nullptr;
+        if (!tryPop(&batch, &call)) break;
+        if (call.func != nullptr) {
+            draining.store(true, std::memory_order_release);
+            call.func(call.data);
+            draining.store(false, std::memory_order_release);
+        }
+    }
+    if (!batch.empty()) {
+        writes.fetch_add(1, std::memory_order_relaxed);
+        bufferFunc(batch);
+    }
+    writeMutex.give();
+}
+
 void Buffer::taskLoop() {
+    MonitoredTask* const monitor = monitoredTask("logger");
     while (true) {
-        mutex.take();
-        if (buffer.size() > 0) {
-            bufferFunc(buffer.at(0));
-            buffer.pop_front();
-        }
-        mutex.give();
-        pros::delay(rate);
+        // announce the wait before checking the queue, so a string pushed in between still wakes the task
+        waiting = true;
+        if (buffersEmpty()) pros::Task::notify_take(true, TIMEOUT_MAX);
+        waiting = false;
+        TaskWork work(monitor);
+        flush();
+        work.stop();
+        // wait at least a tick, so a lower priority producer that was interrupted halfway through a push can finish
+        pros::delay(std::max<uint32_t>(rate, 1));
     }
 }
 } // namespace lemlib
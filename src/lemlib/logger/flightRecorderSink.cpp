@@ -0,0 +1,248 @@
+#include <algorithm>
+#include <cstring>
+#include "lemlib/logger/flightRecorderSink.hpp"
+#include "lemlib/taskMonitor.hpp"
+#include "lemlib/clock.hpp"
+
+namespace lemlib {
+FlightRecorderSink::FlightRecorderSink(size_t bufferSize, uint32_t flushInterval)
+    : bufferSize(bufferSize),
+      flushInterval(flushInterval) {
+    setFormat("{level}: {message}");
+    buffers[0].reset(new uint8_t[bufferSize]);
+    buffers[1].reset(new uint8_t[bufferSize]);
+}
+
+bool FlightRecorderSink::open(const std::string& config, const std::string& directory) {
+    mutex.take();
+    const bool full = nextNumber >= MAX_FILES && directory == numberedDirectory;
+    mutex.give();
+    if (full) return false;
+    if (!getClock().supportsTasks()) {
+        // without tasks, the caller does the writer's work
+        openMutex.take();
+        closeFile();
+        const bool created = createFile(config, directory);
+        openMutex.give();
+        return created;
+    }
+    // closing, finding a free name and creating the file all wait on the SD card, so the writer task does them
+    mutex.take();
+    requestedConfig = config;
+    requestedDirectory = directory;
+    openRequested = true;
+    mutex.give();
+    if (writer == nullptr) {
+        writer = new pros::Task([this] { writerLoop(); }, TASK_PRIORITY_MIN, TASK_STACK_DEPTH_DEFAULT,
+                                "lemlib recorder");
+    }
+    writer->notify();
+    return true;
+}
+
+void FlightRecorderSink::close() {
+    openMutex.take();
+    closeFile();
+    openMutex.give();
+}
+
+bool FlightRecorderSink::createFile(const std::string& config, const std::string& directory) {
+    // find the first unused match number. Numbers below nextNumber were taken last time, so they aren't checked again
+    mutex.take();
+    if (directory != numberedDirectory) {
+        numberedDirectory = directory;
+        nextNumber = 0;
+    }
+    int number = nextNumber;
+    mutex.give();
+    std::string candidate;
+    for (; number < MAX_FILES; number++) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "/match_%03d.lrec", number);
+        candidate = directory + name;
+        FILE* existing = std::fopen(candidate.c_str(), "rb");
+        if (existing == nullptr) break;
+        std::fclose(existing);
+    }
+    mutex.take();
+    nextNumber = number;
+    mutex.give();
+    // every name is taken, and opening the last one would overwrite it
+    if (number == MAX_FILES) return false;
+    FILE* created = std::fopen(candidate.c_str(), "wb");
+    if (created == nullptr) return false;
+
+    FlightRecordHeader header {};
+    std::memcpy(header.magic, "LREC", 4);
+    header.version = 1;
+    header.configSize = std::min<size_t>(config.size(), UINT16_MAX);
+    header.startTime = getClock().millis();
+    header.period = period;
+    for (RecordType type : sampled) header.records |= 1 << static_cast<int>(type);
+    header.bufferSize = bufferSize;
+    std::strncpy(header.build, __DATE__ " " __TIME__, sizeof(header.build) - 1);
+    std::fwrite(&header, sizeof(header), 1, created);
+    std::fwrite(config.data(), 1, header.configSize, created);
+    std::fflush(created);
+
+    fileMutex.take();
+    file = created;
+    path = candidate;
+    fileMutex.give();
+    // start the new file with empty buffers
+    mutex.take();
+    nextNumber = number + 1;
+    fill[0] = fill[1] = 0;
+    pending = false;
+    recording = true;
+    mutex.give();
+    return true;
+}
+
+void FlightRecorderSink::closeFile() {
+    // append checks recording under the mutex, so nothing is appended once this is cleared
+    mutex.take();
+    if (!recording) {
+        mutex.give();
+        return;
+    }
+    recording = false;
+    mutex.give();
+    // write the buffer waiting for the writer, then the one that was being filled
+    writePending();
+    mutex.take();
+    if (fill[active] > 0) {
+        pending = true;
+        active ^= 1;
+    }
+    mutex.give();
+    writePending();
+    fileMutex.take();
+    std::fclose(file);
+    file = nullptr;
+    path.clear();
+    fileMutex.give();
+}
+
+std::string FlightRecorderSink::getPath() {
+    fileMutex.take();
+    const std::string copy = path;
+    fileMutex.give();
+    return copy;
+}
+
+void FlightRecorderSink::record(RecordType type, uint32_t time, const void* payload, size_t size) {
+    if (!recording) return;
+    uint8_t frame[MAX_RECORD_SIZE + 9];
+    append(frame, encodeRecord(type, time, payload, std::min(size, MAX_RECORD_SIZE), frame));
+}
+
+void FlightRecorderSink::append(const uint8_t* frame, size_t frameSize) {
+    mutex.take();
+    // checked again, in case the file was closed after the caller checked
+    if (!recording) {
+        mutex.give();
+        return;
+    }
+    if (fill[active] + frameSize > bufferSize) {
+        if (pending) {
+            // the SD card hasn't kept up
+            dropped++;
+            mutex.give();
+            return;
+        }
+        pending = true;
+        active ^= 1;
+        if (writer != nullptr) writer->notify();
+    }
+    std::memcpy(buffers[active].get() + fill[active], frame, frameSize);
+    fill[active] += frameSize;
+    const bool writeNow = pending && writer == nullptr;
+    mutex.give();
+    // without tasks, the caller writes the full buffer
+    if (writeNow) writePending();
+}
+
+void FlightRecorderSink::startSampling(uint32_t period, std::vector<RecordType> records) {
+    if (sampler != nullptr || !getClock().supportsTasks()) return;
+    this->period = period;
+    sampled = records;
+    sampler = new pros::Task(
+        [this] {
+            MonitoredTask* const monitor = monitoredTask("lemlib sampler");
+            uint8_t frame[MAX_FRAME_SIZE];
+            uint32_t prevTime = getClock().millis();
+            while (true) {
+                TaskWork work(monitor);
+                const uint32_t time = getClock().millis();
+                for (RecordType type : sampled) {
+                    if (recording) append(frame, encodeSample(type, time, frame));
+                }
+                work.stop();
+                getClock().delayUntil(&prevTime, this->period);
+            }
+        },
+        TASK_PRIORITY_MIN + 1, TASK_STACK_DEPTH_DEFAULT, "lemlib sampler");
+}
+
+uint32_t FlightRecorderSink::getDropped() {
+    mutex.take();
+    const uint32_t count = dropped;
+    mutex.give();
+    return count;
+}
+
+void FlightRecorderSink::sendMessage(const Message& message) {
+    record(RecordType::TEXT, message.time, message.message.data(), message.message.size());
+}
+
+void FlightRecorderSink::writePending() {
+    // holding fileMutex throughout means the writer task and close() never write the same buffer twice
+    fileMutex.take();
+    mutex.take();
+    const bool waiting = pending;
+    const int full = active ^ 1;
+    mutex.give();
+    if (waiting) {
+        // the buffer isn't touched by producers while it is pending, so it can be written without holding mutex
+        if (file != nullptr) {
+            std::fwrite(buffers[full].get(), 1, fill[full], file);
+            std::fflush(file);
+        }
+        mutex.take();
+        fill[full] = 0;
+        pending = false;
+        mutex.give();
+    }
+    fileMutex.give();
+}
+
+void FlightRecorderSink::writerLoop() {
+    MonitoredTask* const monitor = monitoredTask("lemlib recorder");
+    while (true) {
+        pros::Task::notify_take(true, flushInterval);
+        TaskWork work(monitor);
+        mutex.take();
+        const bool opening = openRequested;
+        const std::string config = requestedConfig;
+        const std::string directory = requestedDirectory;
+        openRequested = false;
+        mutex.give();
+        if (opening) {
+            openMutex.take();
+            closeFile();
+            createFile(config, directory);
+            openMutex.give();
+        }
+        // write a partly filled buffer too, so at most a flush interval of records is lost if power is cut
+        mutex.take();
+        if (!pending && fill[active] > 0 && recording) {
+            pending = true;
+            active ^= 1;
+        }
+        mutex.give();
+        writePending();
+        work.stop();
+    }
+}
+} // namespace lemlib
@@ -17,6 +17,6 @@ static std::string getColor(Level level) {
 }
 
 void InfoSink::sendMessage(const Message& message) {
-    bufferedStdout().print("{}{}\033[0m\n", getColor(message.level), message.message);
+    bufferedStdout().pushFramed(getColor(message.level), message.message, "\033[0m\n");
 }
 } // namespace lemlib
\ No newline at end of file
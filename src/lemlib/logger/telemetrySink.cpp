@@ -7,6 +7,6 @@ namespace lemlib {
 TelemetrySink::TelemetrySink() { setFormat("TELE_{level}:{message}TELE_END"); }
 
 void TelemetrySink::sendMessage(const Message& message) {
-    bufferedStdout().print("\033[s{}\033[u\033[0J", message.message);
+    bufferedStdout().pushFramed("\033[s", message.message, "\033[u\033[0J");
 }
 } // namespace lemlib
@@ -0,0 +1,245 @@
+#include <algorithm>
+#include <cmath>
+#include "pros/rtos.hpp"
+#include "pros/misc.hpp"
+#include "pros/error.h"
+#include "lemlib/util.hpp"
+#include "lemlib/output.hpp"
+#include "lemlib/chassis/executive.hpp"
+#include "lemlib/clock.hpp"
+
+namespace lemlib {
+// battery compensation
+static float referenceVoltage = 0;
+static float batteryVoltage = 0;
+static uint32_t lastBatteryTime = 0;
+
+/**
+ * @brief The output state of a single smart port
+ *
+ */
+struct OutputSlot {
+        pros::Motor* motor = nullptr;
+        OutputCommand queued;
+        bool pending = false;
+        OutputCommand sent;
+};
+
+// how often an unchanged command is sent again, in milliseconds
+constexpr uint32_t REFRESH_INTERVAL = 100;
+
+static pros::Mutex outputMutex;
+static OutputSlot slots[21];
+static OutputStats stats;
+
+/**
+ * @brief Update the filtered battery voltage. The output mutex must be held
+ *
+ */
+static void updateBatteryVoltage() {
+    const uint32_t now = getClock().millis();
+    // the battery only reports a new value every 10ms
+    if (batteryVoltage != 0 && now - lastBatteryTime < 10) return;
+    lastBatteryTime = now;
+    const int32_t raw = pros::battery::get_voltage();
+    if (raw <= 0 || raw == PROS_ERR) return;
+    // filter out the sag from current spikes
+    batteryVoltage = batteryVoltage == 0 ? raw : ema(raw, batteryVoltage, 0.1);
+}
+
+/**
+ * @brief Queue a command for a motor. The output mutex must be held
+ *
+ * @param motor the motor
+ * @param mode how the motor is being commanded
+ * @param value the commanded value
+ */
+static void queueCommand(pros::Motor* motor, OutputMode mode, int32_t value) {
+    const uint8_t port = motor->get_port();
+    if (port < 1 || port > 21) return;
+    OutputSlot& slot = slots[port - 1];
+    slot.motor = motor;
+    slot.queued.mode = mode;
+    slot.queued.value = value;
+    slot.pending = true;
+}
+
+/**
+ * @brief Send all pending commands that changed. The output mutex must be held
+ *
+ */
+static void sendPending() {
+    const uint32_t now = getClock().millis();
+    stats.flushes++;
+    for (OutputSlot& slot : slots) {
+        if (!slot.pending) continue;
+        slot.pending = false;
+        // skip the command if the motor is already doing it
+        if (slot.queued.mode == slot.sent.mode && slot.queued.value == slot.sent.value &&
+            now - slot.sent.time < REFRESH_INTERVAL) {
+            stats.skipped++;
+            continue;
+        }
+        if (slot.queued.mode == OutputMode::VOLTAGE) slot.motor->move_voltage(slot.queued.value);
+        else slot.motor->move_velocity(slot.queued.value);
+        slot.sent = slot.queued;
+        slot.sent.time = now;
+        stats.sent++;
+    }
+}
+
+/**
+ * @brief Queue a command for every motor in a motor group, and send it if the executive isn't running
+ *
+ * @param motors the motor group
+ * @param mode how the motors are being commanded
+ * @param value the commanded value
+ */
+static void queueGroup(pros::Motor_Group* motors, OutputMode mode, int32_t value) {
+    outputMutex.take();
+    for (int i = 0; i < motors->size(); i++) queueCommand(&(*motors)[i], mode, value);
+    if (!executiveRunning()) sendPending();
+    outputMutex.give();
+}
+
+/**
+ * @brief Queue a command for a motor, and send it if the executive isn't running
+ *
+ * @param motor the motor
+ * @param mode how the motor is being commanded
+ * @param value the commanded value
+ */
+static void queueMotor(pros::Motor* motor, OutputMode mode, int32_t value) {
+    outputMutex.take();
+    queueCommand(motor, mode, value);
+    if (!executiveRunning()) sendPending();
+    outputMutex.give();
+}
+
+/**
+ * @brief Set the battery voltage that motor output is compensated to
+ *
+ * @param reference the reference voltage in millivolts. 0 disables compensation, which is the default
+ */
+void setVoltageCompensation(float reference) {
+    outputMutex.take();
+    referenceVoltage = reference;
+    // start filtering again from the next reading
+    batteryVoltage = 0;
+    outputMutex.give();
+}
+
+/**
+ * @brief Get the filtered battery voltage used for compensation
+ *
+ * @return float battery voltage in millivolts
+ */
+float getBatteryVoltage() {
+    outputMutex.take();
+    updateBatteryVoltage();
+    const float voltage = batteryVoltage;
+    outputMutex.give();
+    return voltage;
+}
+
+/**
+ * @brief Convert power to a battery compensated voltage
+ *
+ * @param power the power, from -127 to 127
+ * @return int32_t the voltage in millivolts, from -12000 to 12000
+ */
+static int32_t compensatedVoltage(float power) {
+    float voltage = powerToVoltage(power);
+    outputMutex.take();
+    if (referenceVoltage > 0) {
+        updateBatteryVoltage();
+        if (batteryVoltage > 0) voltage *= referenceVoltage / batteryVoltage;
+    }
+    outputMutex.give();
+    return std::lround(std::clamp(voltage, -12000.0f, 12000.0f));
+}
+
+/**
+ * @brief Queue power to be sent to a motor group
+ *
+ * @param motors the motor group
+ * @param power the power to send, from -127 to 127. Fractional power is not rounded
+ */
+void queueOutput(pros::Motor_Group* motors, float power) { queueVoltage(motors, compensatedVoltage(power)); }
+
+/**
+ * @brief Queue power to be sent to a motor
+ *
+ * @param motor the motor
+ * @param power the power to send, from -127 to 127. Fractional power is not rounded
+ */
+void queueOutput(pros::Motor* motor, float power) { queueVoltage(motor, compensatedVoltage(power)); }
+
+/**
+ * @brief Queue a voltage command for every motor in a motor group
+ *
+ * @param motors the motor group
+ * @param voltage the voltage in millivolts, from -12000 to 12000
+ */
+void queueVoltage(pros::Motor_Group* motors, int32_t voltage) { queueGroup(motors, OutputMode::VOLTAGE, voltage); }
+
+/**
+ * @brief Queue a voltage command for a motor
+ *
+ * @param motor the motor
+ * @param voltage the voltage in millivolts, from -12000 to 12000
+ */
+void queueVoltage(pros::Motor* motor, int32_t voltage) { queueMotor(motor, OutputMode::VOLTAGE, voltage); }
+
+/**
+ * @brief Queue a velocity command for every motor in a motor group
+ *
+ * @param motors the motor group
+ * @param velocity the velocity in rpm, limited by the motor cartridge
+ */
+void queueVelocity(pros::Motor_Group* motors, int32_t velocity) { queueGroup(motors, OutputMode::VELOCITY, velocity); }
+
+/**
+ * @brief Queue a velocity command for a motor
+ *
+ * @param motor the motor
+ * @param velocity the velocity in rpm, limited by the motor cartridge
+ */
+void queueVelocity(pros::Motor* motor, int32_t velocity) { queueMotor(motor, OutputMode::VELOCITY, velocity); }
+
+/**
+ * @brief Send all queued commands to the motors
+ *
+ */
+void flushOutput() {
+    outputMutex.take();
+    sendPending();
+    outputMutex.give();
+}
+
+/**
+ * @brief Get the last command sent to a motor through the output stage
+ *
+ * @param port the smart port of the motor, from 1 to 21
+ * @return OutputCommand
+ */
+OutputCommand getCommandedOutput(uint8_t port) {
+    if (port < 1 || port > 21) return {};
+    outputMutex.take();
+    const OutputCommand command = slots[port - 1].sent;
+    outputMutex.give();
+    return command;
+}
+
+/**
+ * @brief Get the statistics of the output stage
+ *
+ * @return OutputStats
+ */
+OutputStats getOutputStats() {
+    outputMutex.take();
+    const OutputStats copy = stats;
+    outputMutex.give();
+    return copy;
+}
+} // namespace lemlib
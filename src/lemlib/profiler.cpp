@@ -0,0 +1,238 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include "pros/rtos.hpp"
+#include "lemlib/profiler.hpp"
+#include "lemlib/logger/logger.hpp"
+#include "lemlib/clock.hpp"
+#include "lemlib/taskMonitor.hpp"
+#if !defined(__arm__)
+#include <chrono>
+#endif
+
+namespace lemlib {
+namespace {
+ProfileZone zones[MAX_PROFILE_ZONES];
+int zoneCount = 0;
+pros::Task* dumpTask = nullptr;
+
+/**
+ * @brief Get the mutex that protects zone creation
+ *
+ * @return pros::Mutex&
+ */
+pros::Mutex& zoneMutex() {
+    static pros::Mutex mutex;
+    return mutex;
+}
+
+#if defined(__arm__) && !defined(LEMLIB_PROFILER_USE_MICROS)
+/**
+ * @brief Start the Cortex-A9 cycle counter
+ *
+ */
+void enableCycleCounter() {
+    uint32_t control;
+    asm volatile("mrc p15, 0, %0, c9, c12, 0" : "=r"(control));
+    // enable all counters, without resetting them or the cycle divider
+    asm volatile("mcr p15, 0, %0, c9, c12, 0" : : "r"(control | 1));
+    // enable the cycle counter
+    asm volatile("mcr p15, 0, %0, c9, c12, 1" : : "r"(1u << 31));
+}
+
+// start counting before anything takes a timestamp
+[[maybe_unused]] const bool cycleCounterEnabled = (enableCycleCounter(), true);
+#endif
+
+/**
+ * @brief Convert a difference of profileNow() timestamps to nanoseconds
+ *
+ */
+uint32_t toNanoseconds(uint32_t ticks) {
+#if defined(__arm__) && !defined(LEMLIB_PROFILER_USE_MICROS)
+    // the cortex-A9 in the brain runs at 666.7 MHz, so a cycle is 1.5 ns
+    return ticks + ticks / 2;
+#elif defined(__arm__)
+    return ticks * 1000;
+#else
+    return ticks;
+#endif
+}
+
+/**
+ * @brief Get the histogram bucket of a duration
+ *
+ * Durations under 4 ns get a bucket each, and each octave above that is split into 4 buckets.
+ */
+int bucketOf(uint32_t ns) {
+    if (ns < 4) return ns;
+    const int octave = 31 - __builtin_clz(ns);
+    return (octave - 1) * 4 + ((ns >> (octave - 2)) & 3);
+}
+
+/**
+ * @brief Get the longest duration that falls in a histogram bucket
+ *
+ */
+uint64_t bucketLimit(int bucket) {
+    const int next = bucket + 1;
+    if (next < 4) return bucket;
+    const int octave = next / 4 + 1;
+    return (uint64_t(4 + next % 4) << (octave - 2)) - 1;
+}
+} // namespace
+
+/**
+ * @brief Get a profiling zone, creating it if it doesn't exist yet
+ *
+ * @param name the name of the zone. Must outlive the program, like a string literal
+ * @return ProfileZone* the zone, or nullptr if the zone table is full
+ */
+ProfileZone* profileZone(const char* name) {
+    zoneMutex().take();
+    ProfileZone* zone = nullptr;
+    for (int i = 0; i < zoneCount; i++) {
+        if (std::strcmp(zones[i].name, name) == 0) zone = &zones[i];
+    }
+    if (zone == nullptr && zoneCount < MAX_PROFILE_ZONES) {
+        zone = &zones[zoneCount++];
+        zone->name = name;
+        zone->min = UINT32_MAX;
+    }
+    zoneMutex().give();
+    return zone;
+}
+
+/**
+ * @brief Get a timestamp for profiling
+ *
+ * @return uint32_t the timestamp, in an unspecified unit
+ */
+uint32_t profileNow() {
+#if defined(__arm__) && !defined(LEMLIB_PROFILER_USE_MICROS)
+    uint32_t cycles;
+    asm volatile("mrc p15, 0, %0, c9, c13, 0" : "=r"(cycles));
+    return cycles;
+#elif defined(__arm__)
+    return pros::micros();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+#endif
+}
+
+/**
+ * @brief Get the time since a profileNow() timestamp
+ *
+ * @param start the timestamp
+ * @return uint32_t the time since the timestamp, in nanoseconds
+ */
+uint32_t profileElapsed(uint32_t start) { return toNanoseconds(profileNow() - start); }
+
+/**
+ * @brief Record a run of a profiling zone
+ *
+ * @param zone the zone. Ignored if nullptr
+ * @param start the timestamp from profileNow() when the run started
+ */
+void profileRecord(ProfileZone* zone, uint32_t start) {
+    if (zone == nullptr) return;
+    const uint32_t ns = profileElapsed(start);
+    zone->count++;
+    zone->total += ns;
+    zone->min = std::min(zone->min, ns);
+    zone->max = std::max(zone->max, ns);
+    zone->histogram[bucketOf(ns)]++;
+}
+
+/**
+ * @brief Get the statistics of every profiling zone
+ *
+ * @return std::vector<ProfileStats> the zones, in the order they were created
+ */
+std::vector<ProfileStats> getProfile() {
+    std::vector<ProfileStats> stats;
+    for (int i = 0; i < zoneCount; i++) {
+        const ProfileZone& zone = zones[i];
+        if (zone.count == 0) {
+            stats.push_back({zone.name, 0, 0, 0, 0, 0});
+            continue;
+        }
+        // the 99th percentile is the top of the bucket that holds it
+        const uint32_t rank = zone.count - zone.count / 100;
+        uint32_t seen = 0;
+        int bucket = 0;
+        while (bucket < PROFILE_BUCKETS - 1 && (seen += zone.histogram[bucket]) < rank) bucket++;
+        const float p99 = std::min<uint64_t>(bucketLimit(bucket), zone.max);
+        stats.push_back({zone.name, zone.count, zone.min / 1000.0f, float(zone.total) / zone.count / 1000,
+                         zone.max / 1000.0f, p99 / 1000});
+    }
+    return stats;
+}
+
+/**
+ * @brief Clear the statistics of every profiling zone
+ *
+ */
+void resetProfile() {
+    for (int i = 0; i < zoneCount; i++) {
+        const char* name = zones[i].name;
+        zones[i] = {};
+        zones[i].name = name;
+        zones[i].min = UINT32_MAX;
+    }
+}
+
+/**
+ * @brief Log the statistics of every profiling zone through the info sink, at the debug level
+ *
+ */
+void logProfile() {
+    // working out the percentiles is the expensive part, so skip it if nothing would be logged
+    if (!infoSink()->shouldLog(Level::DEBUG)) return;
+    for (const ProfileStats& zone : getProfile()) {
+        LEMLIB_DEBUG(infoSink(), "profile {}: n {}, min {:.1f} us, mean {:.1f} us, max {:.1f} us, p99 {:.1f} us",
+                     zone.name, zone.count, zone.min, zone.mean, zone.max, zone.p99);
+    }
+}
+
+/**
+ * @brief Write the statistics of every profiling zone to a CSV file
+ *
+ * @param path the file to write
+ * @return true the file was written
+ * @return false the file couldn't be opened
+ */
+bool writeProfile(const char* path) {
+    FILE* file = std::fopen(path, "w");
+    if (file == nullptr) return false;
+    std::fputs("zone,count,min_us,mean_us,max_us,p99_us\n", file);
+    for (const ProfileStats& zone : getProfile()) {
+        std::fprintf(file, "%s,%u,%.2f,%.2f,%.2f,%.2f\n", zone.name, (unsigned)zone.count, zone.min, zone.mean,
+                     zone.max, zone.p99);
+    }
+    std::fclose(file);
+    return true;
+}
+
+/**
+ * @brief Start a low priority task that periodically logs the profiling statistics
+ *
+ * @param period time between dumps, in milliseconds
+ * @param toSd whether to also write the statistics to the SD card
+ */
+void startProfileDump(uint32_t period, bool toSd) {
+    if (dumpTask != nullptr || !getClock().supportsTasks()) return;
+    dumpTask = new pros::Task(
+        [=] {
+            while (true) {
+                getClock().delay(period);
+                TaskWork work(monitoredTask("lemlib profiler"));
+                logProfile();
+                if (toSd) writeProfile();
+            }
+        },
+        TASK_PRIORITY_MIN + 1, TASK_STACK_DEPTH_DEFAULT, "lemlib profiler");
+}
+} // namespace lemlib
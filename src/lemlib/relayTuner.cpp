@@ -0,0 +1,128 @@
+#include <cmath>
+#include <algorithm>
+#include "lemlib/relayTuner.hpp"
+
+namespace lemlib {
+/**
+ * @brief Construct a new Relay Tuner
+ *
+ * @param settings settings for the experiment
+ */
+RelayTuner::RelayTuner(AutotuneSettings settings)
+    : settings(settings) {}
+
+/**
+ * @brief Update the relay
+ *
+ * The relay switches to +d when the error rises above the hysteresis band, and to -d when it falls below it. A full
+ * oscillation is measured from one rising switch to the next.
+ *
+ * @param error target minus position
+ * @param time the current time, in milliseconds
+ * @return float the output of the relay
+ */
+float RelayTuner::update(float error, uint32_t time) {
+    const float d = std::fabs(settings.relayAmplitude);
+    const float h = std::fabs(settings.hysteresis);
+
+    // pick a direction on the first update
+    if (output == 0) {
+        output = error >= 0 ? d : -d;
+        peak = error;
+        trough = error;
+    }
+
+    // track the extremes of the current oscillation
+    peak = std::max(peak, error);
+    trough = std::min(trough, error);
+
+    if (output > 0 && error < -h) {
+        output = -d;
+    } else if (output < 0 && error > h) {
+        output = d;
+        // a rising switch completes an oscillation
+        if (lastRiseTime >= 0) {
+            switches++;
+            // the first oscillation is still settling into the limit cycle, so discard it
+            if (switches > 1 && !isDone()) {
+                periodSum += float(time - lastRiseTime);
+                amplitudeSum += (peak - trough) / 2;
+                measured++;
+            }
+        }
+        lastRiseTime = time;
+        peak = error;
+        trough = error;
+    }
+
+    return output;
+}
+
+/**
+ * @brief Whether enough oscillations have been measured
+ *
+ * @return true the experiment is done
+ * @return false the experiment is not done
+ */
+bool RelayTuner::isDone() const { return measured >= std::max(settings.cycles, 1); }
+
+/**
+ * @brief Calculate the result of the experiment
+ *
+ * Gains are calculated with the Ziegler-Nichols rules, then converted to the discrete form used by lemlib::PID,
+ * which doesn't scale by the time step. Exit conditions are derived from the hysteresis band and the ultimate period.
+ *
+ * @param period how often the tuned controller will be updated, in milliseconds. 10 by default
+ * @return AutotuneResult
+ */
+AutotuneResult RelayTuner::getResult(float period) const {
+    AutotuneResult result;
+    if (measured == 0) return result;
+
+    const float d = std::fabs(settings.relayAmplitude);
+    const float h = std::fabs(settings.hysteresis);
+    const float a = amplitudeSum / measured;
+    const float tu = periodSum / measured;
+
+    result.success = isDone();
+    result.amplitude = a;
+    result.ultimatePeriod = tu;
+    // describing function of a relay with hysteresis
+    result.ultimateGain = a > h ? 4 * d / (M_PI * std::sqrt(a * a - h * h)) : 4 * d / (M_PI * a);
+
+    if (settings.integral) {
+        // classic Ziegler-Nichols PID. Ti = Tu / 2, Td = Tu / 8
+        result.kP = 0.6 * result.ultimateGain;
+        result.kI = result.kP * period / (tu / 2);
+        result.kD = result.kP * (tu / 8) / period;
+    } else {
+        // Ziegler-Nichols PD. Td = Tu / 8
+        result.kP = 0.8 * result.ultimateGain;
+        result.kD = result.kP * (tu / 8) / period;
+    }
+
+    // the relay can't hold the system any closer than the hysteresis band, so neither can the tuned controller
+    result.smallError = std::max(2 * h, 0.1f * a);
+    result.largeError = 3 * result.smallError;
+    result.windupRange = result.largeError;
+    // round timeouts up to the controller period
+    result.smallErrorTimeout = std::ceil(tu / 4 / period) * period;
+    result.largeErrorTimeout = std::ceil(tu / period) * period;
+    return result;
+}
+
+/**
+ * @brief Reset the experiment
+ *
+ */
+void RelayTuner::reset() {
+    output = 0;
+    peak = 0;
+    trough = 0;
+    lastRiseTime = -1;
+    switches = 0;
+    measured = 0;
+    periodSum = 0;
+    amplitudeSum = 0;
+}
+} // namespace lemlib
@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include "lemlib/taskMonitor.hpp"
+#include "lemlib/telemetry.hpp"
+#include "lemlib/profiler.hpp"
+#include "lemlib/logger/logger.hpp"
+#include "lemlib/clock.hpp"
+
+/**
+ * @brief The FreeRTOS stack high water mark, in words
+ *
+ * PROS doesn't declare this, but its kernel is built with it. It is weak so a kernel without it leaves it null
+ * instead of failing to link, and then stack usage just isn't reported.
+ */
+extern "C" uint32_t uxTaskGetStackHighWaterMark(pros::task_t task) __attribute__((weak));
+
+namespace lemlib {
+namespace {
+MonitoredTask tasks[MAX_MONITORED_TASKS];
+int taskCount = 0;
+uint32_t lastSample = 0;
+pros::Task* monitorTask = nullptr;
+
+/**
+ * @brief Get the mutex that protects the task table
+ *
+ * @return pros::Mutex&
+ */
+pros::Mutex& taskMutex() {
+    static pros::Mutex mutex;
+    return mutex;
+}
+} // namespace
+
+/**
+ * @brief Get a monitored task, creating it if it doesn't exist yet
+ *
+ * @param name the name of the task. Must outlive the program, like a string literal
+ * @param stackDepth the stack depth the task was created with, in words. 0 for a shared entry
+ * @return MonitoredTask* the task, or nullptr if the table is full
+ */
+MonitoredTask* monitoredTask(const char* name, uint32_t stackDepth) {
+    taskMutex().take();
+    MonitoredTask* task = nullptr;
+    for (int i = 0; i < taskCount; i++) {
+        if (std::strcmp(tasks[i].name, name) == 0) task = &tasks[i];
+    }
+    if (task == nullptr && taskCount < MAX_MONITORED_TASKS) {
+        task = &tasks[taskCount++];
+        task->name = name;
+        task->stackSize = stackDepth * sizeof(uint32_t);
+    }
+    taskMutex().give();
+    return task;
+}
+
+/**
+ * @brief Get the monitored task that motion loops count their work under, whichever task they run in
+ *
+ * @return MonitoredTask* the task, or nullptr if the table is full
+ */
+MonitoredTask* motionWork() {
+    // async motions run in tasks that are deleted when the motion ends, so the entry can't keep their handles
+    static MonitoredTask* const task = monitoredTask("motion", 0);
+    return task;
+}
+
+/**
+ * @brief Start counting work
+ *
+ * @param task the monitored task. Nothing is counted if nullptr
+ */
+TaskWork::TaskWork(MonitoredTask* task)
+    : task(task),
+      start(task == nullptr ? 0 : profileNow()) {
+    if (task != nullptr && task->stackSize != 0) task->task = pros::c::task_get_current();
+}
+
+/**
+ * @brief Stop counting work
+ *
+ */
+void TaskWork::stop() {
+    if (task == nullptr) return;
+    const uint32_t ns = profileElapsed(start);
+    task->busy += ns;
+    uint32_t longest = task->longest;
+    while (ns > longest && !task->longest.compare_exchange_weak(longest, ns)) {}
+    task = nullptr;
+}
+
+/**
+ * @brief Sample every monitored task, and start a new sample period
+ *
+ * @return std::vector<TaskStats> the tasks, in the order they were first monitored
+ */
+std::vector<TaskStats> sampleTasks() {
+    const uint32_t now = getClock().millis();
+    const uint32_t period = std::max<uint32_t>(now - lastSample, 1);
+    lastSample = now;
+    std::vector<TaskStats> stats;
+    taskMutex().take();
+    for (int i = 0; i < taskCount; i++) {
+        MonitoredTask& task = tasks[i];
+        int32_t stackFree = -1;
+        const pros::task_t handle = task.task;
+        if (uxTaskGetStackHighWaterMark != nullptr && handle != nullptr) {
+            stackFree = uxTaskGetStackHighWaterMark(handle) * sizeof(uint32_t);
+        }
+        // take the work done so far, so work finished while sampling counts towards the next sample
+        const uint64_t busy = task.busy.exchange(0);
+        const uint32_t longest = task.longest.exchange(0);
+        stats.push_back({task.name, busy / (period * 1e6f), longest / 1000, stackFree, task.stackSize});
+    }
+    taskMutex().give();
+    return stats;
+}
+
+/**
+ * @brief Start a low priority task that samples the monitored tasks and publishes them through telemetry
+ *
+ * @param period time between samples, in milliseconds
+ * @param cpuWarning CPU share, from 0 to 1, above which a task is reported as overloaded
+ * @param stackWarning free stack, in bytes, below which a task is reported as close to overflowing
+ */
+void startTaskMonitor(uint32_t period, float cpuWarning, int32_t stackWarning) {
+    if (monitorTask != nullptr || !getClock().supportsTasks()) return;
+    lastSample = getClock().millis();
+    if (uxTaskGetStackHighWaterMark == nullptr) {
+        LEMLIB_WARN(infoSink(), "task monitor: the kernel doesn't report free stack, so it won't be monitored");
+    }
+    monitorTask = new pros::Task(
+        [=] {
+            while (true) {
+                getClock().delay(period);
+                TaskWork work(monitoredTask("lemlib monitor"));
+                for (const TaskStats& task : sampleTasks()) {
+                    // a channel only keeps its latest record, so every task gets its own
+                    TaskRecord record {{}, task.cpu, task.longest, task.stackFree, task.stackSize};
+                    std::strncpy(record.name, task.name, sizeof(record.name) - 1);
+                    telemetryChannel(std::string("task ") + task.name, RecordType::TASK).publish(record);
+                    if (task.cpu > cpuWarning) {
+                        LEMLIB_WARN(infoSink(), "task {} is overloaded: {:.0f}% cpu", task.name, task.cpu * 100);
+                    }
+                    if (task.stackFree >= 0 && task.stackFree < stackWarning) {
+                        LEMLIB_WARN(infoSink(), "task {} is close to overflowing its stack: {} of {} bytes free",
+                                    task.name, task.stackFree, task.stackSize);
+                    }
+                }
+            }
+        },
+        TASK_PRIORITY_MIN + 1, TASK_STACK_DEPTH_DEFAULT, "lemlib monitor");
+}
+} // namespace lemlib
@@ -0,0 +1,405 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include "pros/rtos.hpp"
+#include "lemlib/telemetry.hpp"
+#include "lemlib/chassis/odom.hpp"
+#include "lemlib/taskMonitor.hpp"
+#include "lemlib/util.hpp"
+#include "lemlib/clock.hpp"
+
+namespace lemlib {
+namespace {
+pros::Task* telemetryTask = nullptr;
+
+// latest state of the running motion, guarded by motionMutex
+MotionStateRecord motionState {};
+ControllerRecord controllerOutput {};
+
+/**
+ * @brief Get the mutex that protects the motion state
+ *
+ * @return pros::Mutex&
+ */
+pros::Mutex& motionMutex() {
+    static pros::Mutex mutex;
+    return mutex;
+}
+
+/**
+ * @brief Get the list of telemetry channels, and the mutex that protects it
+ *
+ */
+std::vector<std::unique_ptr<TelemetryChannel>>& channels() {
+    static std::vector<std::unique_ptr<TelemetryChannel>> list;
+    return list;
+}
+
+pros::Mutex& channelsMutex() {
+    static pros::Mutex mutex;
+    return mutex;
+}
+
+/**
+ * @brief Get the name of the channel a sampled record is published to
+ *
+ */
+const char* channelName(RecordType type) {
+    switch (type) {
+        case RecordType::POSE: return "pose";
+        case RecordType::SPEED: return "speed";
+        case RecordType::MOTION: return "motion";
+        case RecordType::CONTROLLER: return "controller";
+        case RecordType::POSE_STREAM: return "pose stream";
+        default: return "text";
+    }
+}
+
+/**
+ * @brief Get the current value of a record
+ *
+ * @param type the type of the record. Not TEXT, which has no current value
+ * @param payload where to write the record. Must have room for MAX_CHANNEL_RECORD_SIZE bytes
+ * @return size_t size of the record in bytes
+ */
+size_t sampleRecord(RecordType type, uint8_t* payload) {
+    switch (type) {
+        case RecordType::POSE: {
+            const Pose pose = getPose();
+            const PoseRecord record {pose.x, pose.y, pose.theta};
+            std::memcpy(payload, &record, sizeof(record));
+            return sizeof(record);
+        }
+        case RecordType::SPEED: {
+            const Pose speed = getSpeed();
+            const SpeedRecord record {speed.x, speed.y, speed.theta};
+            std::memcpy(payload, &record, sizeof(record));
+            return sizeof(record);
+        }
+        case RecordType::MOTION: {
+            motionMutex().take();
+            std::memcpy(payload, &motionState, sizeof(motionState));
+            motionMutex().give();
+            return sizeof(motionState);
+        }
+        case RecordType::CONTROLLER: {
+            motionMutex().take();
+            std::memcpy(payload, &controllerOutput, sizeof(controllerOutput));
+            motionMutex().give();
+            return sizeof(controllerOutput);
+        }
+        default: return 0;
+    }
+}
+
+/**
+ * @brief CRC-8 with polynomial 0x07, the one used by SMBus
+ *
+ */
+uint8_t crc8(const uint8_t* data, size_t size) {
+    uint8_t crc = 0;
+    for (size_t i = 0; i < size; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) crc = crc & 0x80 ? (crc << 1) ^ 0x07 : crc << 1;
+    }
+    return crc;
+}
+} // namespace
+
+size_t cobsEncode(const uint8_t* data, size_t size, uint8_t* out) {
+    size_t code = 0;
+    size_t written = 1;
+    for (size_t i = 0; i < size; i++) {
+        if (data[i] == 0) {
+            out[code] = written - code;
+            code = written++;
+        } else {
+            out[written++] = data[i];
+        }
+    }
+    out[code] = written - code;
+    return written;
+}
+
+size_t cobsDecode(const uint8_t* data, size_t size, uint8_t* out) {
+    size_t written = 0;
+    size_t i = 0;
+    while (i < size) {
+        const uint8_t code = data[i++];
+        if (code == 0 || i + code - 1 > size) return 0;
+        for (uint8_t j = 1; j < code; j++) {
+            if (data[i] == 0) return 0;
+            out[written++] = data[i++];
+        }
+        // a zero was removed here, unless this was the last block
+        if (i < size) out[written++] = 0;
+    }
+    return written;
+}
+
+size_t encodeRecord(RecordType type, uint32_t time, const void* payload, size_t size, uint8_t* frame) {
+    uint8_t raw[MAX_RECORD_SIZE + 6];
+    raw[0] = static_cast<uint8_t>(type);
+    std::memcpy(raw + 1, &time, sizeof(time));
+    std::memcpy(raw + 5, payload, size);
+    raw[5 + size] = crc8(raw, 5 + size);
+    frame[0] = 0;
+    const size_t encoded = cobsEncode(raw, 6 + size, frame + 1);
+    frame[1 + encoded] = 0;
+    return encoded + 2;
+}
+
+int decodeRecord(const uint8_t* data, size_t size, RecordType& type, uint32_t& time, uint8_t* payload) {
+    uint8_t raw[256];
+    if (size == 0 || size > sizeof(raw)) return -1;
+    const size_t decoded = cobsDecode(data, size, raw);
+    if (decoded < 6 || crc8(raw, decoded - 1) != raw[decoded - 1]) return -1;
+    type = static_cast<RecordType>(raw[0]);
+    std::memcpy(&time, raw + 1, sizeof(time));
+    std::memcpy(payload, raw + 5, decoded - 6);
+    return decoded - 6;
+}
+
+size_t encodeSample(RecordType type, uint32_t time, uint8_t* frame) {
+    uint8_t record[MAX_CHANNEL_RECORD_SIZE];
+    const size_t size = sampleRecord(type, record);
+    if (size == 0) return 0;
+    return encodeRecord(type, time, record, size, frame);
+}
+
+TelemetryChannel::TelemetryChannel(const std::string& name, RecordType type)
+    : name(name),
+      type(type) {}
+
+void TelemetryChannel::publish(const void* payload, size_t size) {
+    const uint32_t now = getClock().millis();
+    mutex.take();
+    // decimation counts every record published, so it thins out the records evenly
+    if (stats.published++ % std::max<uint32_t>(config.decimation, 1) != 0) {
+        mutex.give();
+        return;
+    }
+    if (pending) stats.coalesced++;
+    this->size = std::min(size, MAX_CHANNEL_RECORD_SIZE);
+    std::memcpy(record, payload, this->size);
+    time = now;
+    pending = true;
+    mutex.give();
+}
+
+size_t TelemetryChannel::encodePending(uint32_t now, uint8_t* frame) {
+    mutex.take();
+    // the record stays pending while the channel is rate limited, and newer records replace it
+    const bool due = config.maxRate <= 0 || !sentBefore || now - lastSent >= 1000 / config.maxRate;
+    if (!pending || !config.enabled || !due) {
+        mutex.give();
+        return 0;
+    }
+    const size_t frameSize = encodeRecord(type, time, record, size, frame);
+    pending = false;
+    lastSent = now;
+    sentBefore = true;
+    stats.sent++;
+    mutex.give();
+    return frameSize;
+}
+
+void TelemetryChannel::configure(const ChannelConfig& config) {
+    mutex.take();
+    this->config = config;
+    mutex.give();
+}
+
+ChannelConfig TelemetryChannel::getConfig() {
+    mutex.take();
+    const ChannelConfig copy = config;
+    mutex.give();
+    return copy;
+}
+
+ChannelStats TelemetryChannel::getStats() {
+    mutex.take();
+    const ChannelStats copy = stats;
+    mutex.give();
+    return copy;
+}
+
+const std::string& TelemetryChannel::getName() const { return name; }
+
+RecordType TelemetryChannel::getType() const { return type; }
+
+PoseStreamEncoder::PoseStreamEncoder(uint32_t period, uint8_t deltasPerRecord, uint32_t keyframeInterval)
+    : period(period),
+      deltasPerRecord(std::clamp<uint8_t>(deltasPerRecord, 1, MAX_POSE_STREAM_DELTAS)),
+      keyframeInterval(keyframeInterval) {}
+
+size_t PoseStreamEncoder::encode(const PoseRecord& pose, uint8_t* payload) {
+    const float values[3] = {pose.x, pose.y, pose.theta};
+    int32_t rounded[3];
+    bool fits = true;
+    for (int i = 0; i < 3; i++) {
+        rounded[i] = std::lround(values[i] / POSE_STREAM_RESOLUTION);
+        fits = fits && std::abs(int64_t(rounded[i]) - last[i]) <= INT16_MAX;
+    }
+
+    // a keyframe has sequence number, 0, x, y, theta, period
+    if (keyframeDue || (!fits && count == 0)) {
+        payload[0] = sequence++;
+        payload[1] = 0;
+        std::memcpy(payload + 2, rounded, sizeof(rounded));
+        const uint16_t shortPeriod = period;
+        std::memcpy(payload + 14, &shortPeriod, sizeof(shortPeriod));
+        std::memcpy(last, rounded, sizeof(last));
+        keyframeDue = false;
+        sinceKeyframe = 0;
+        return 16;
+    }
+    if (fits) {
+        for (int i = 0; i < 3; i++) deltas[count][i] = rounded[i] - last[i];
+        std::memcpy(last, rounded, sizeof(last));
+        count++;
+    } else {
+        // send what there is, and this pose is lost. Only a jump, like setPose(), is too big for a delta
+        keyframeDue = true;
+    }
+    if (count < deltasPerRecord && fits) return 0;
+
+    // a delta record has sequence number, number of poses, then dx, dy, dtheta of each pose
+    payload[0] = sequence++;
+    payload[1] = count;
+    std::memcpy(payload + 2, deltas, count * sizeof(deltas[0]));
+    const size_t size = 2 + count * sizeof(deltas[0]);
+    count = 0;
+    if (++sinceKeyframe >= keyframeInterval) keyframeDue = true;
+    return size;
+}
+
+void PoseStreamEncoder::reset() {
+    count = 0;
+    keyframeDue = true;
+}
+
+int PoseStreamDecoder::decode(uint32_t time, const uint8_t* payload, size_t size, uint32_t* times,
+                              PoseRecord* poses) {
+    if (size < 2) return 0;
+    const uint8_t recordSequence = payload[0];
+    const uint8_t count = payload[1];
+    // deltas only make sense on top of the record before them
+    const bool inOrder = synced && recordSequence == uint8_t(sequence + 1);
+    sequence = recordSequence;
+    if (count == 0 && size == 16) {
+        std::memcpy(last, payload + 2, sizeof(last));
+        uint16_t shortPeriod;
+        std::memcpy(&shortPeriod, payload + 14, sizeof(shortPeriod));
+        period = shortPeriod;
+        synced = true;
+        times[0] = time;
+        poses[0] = {last[0] * POSE_STREAM_RESOLUTION, last[1] * POSE_STREAM_RESOLUTION,
+                    last[2] * POSE_STREAM_RESOLUTION};
+        return 1;
+    }
+    if (!inOrder || count > MAX_POSE_STREAM_DELTAS || size != 2 + count * 3 * sizeof(int16_t)) {
+        synced = false;
+        return 0;
+    }
+    // the frame is stamped when the last pose was added, and the poses are a period apart
+    for (int i = 0; i < count; i++) {
+        int16_t delta[3];
+        std::memcpy(delta, payload + 2 + i * sizeof(delta), sizeof(delta));
+        for (int j = 0; j < 3; j++) last[j] += delta[j];
+        times[i] = time - (count - 1 - i) * period;
+        poses[i] = {last[0] * POSE_STREAM_RESOLUTION, last[1] * POSE_STREAM_RESOLUTION,
+                    last[2] * POSE_STREAM_RESOLUTION};
+    }
+    return count;
+}
+
+TelemetryChannel& telemetryChannel(const std::string& name, RecordType type) {
+    channelsMutex().take();
+    for (const std::unique_ptr<TelemetryChannel>& channel : channels()) {
+        if (channel->getName() == name) {
+            channelsMutex().give();
+            return *channel;
+        }
+    }
+    channels().push_back(std::make_unique<TelemetryChannel>(name, type));
+    TelemetryChannel& channel = *channels().back();
+    channelsMutex().give();
+    return channel;
+}
+
+bool configureTelemetryChannel(const std::string& name, const ChannelConfig& config) {
+    channelsMutex().take();
+    for (const std::unique_ptr<TelemetryChannel>& channel : channels()) {
+        if (channel->getName() == name) {
+            channel->configure(config);
+            channelsMutex().give();
+            return true;
+        }
+    }
+    channelsMutex().give();
+    return false;
+}
+
+void publishMotion(const MotionStateRecord& state, const ControllerRecord& controller) {
+    motionMutex().take();
+    motionState = state;
+    motionState.running = 1;
+    controllerOutput = controller;
+    motionMutex().give();
+}
+
+void publishMotionEnd() {
+    motionMutex().take();
+    motionState.running = 0;
+    controllerOutput = {};
+    motionMutex().give();
+}
+
+void startBinaryTelemetry(uint32_t period, std::vector<RecordType> records) {
+    if (telemetryTask != nullptr || !getClock().supportsTasks()) return;
+    std::vector<TelemetryChannel*> sampled;
+    for (RecordType type : records) sampled.push_back(&telemetryChannel(channelName(type), type));
+    telemetryTask = new pros::Task(
+        [=] {
+            MonitoredTask* const monitor = monitoredTask("lemlib telemetry");
+            uint32_t prevTime = getClock().millis();
+            std::vector<uint8_t> frames;
+            uint8_t record[MAX_CHANNEL_RECORD_SIZE];
+            PoseStreamEncoder poseStream(period);
+            while (true) {
+                TaskWork work(monitor);
+                for (TelemetryChannel* channel : sampled) {
+                    size_t recordSize;
+                    if (channel->getType() == RecordType::POSE_STREAM) {
+                        const Pose pose = getPose();
+                        recordSize = poseStream.encode({pose.x, pose.y, pose.theta}, record);
+                    } else {
+                        recordSize = sampleRecord(channel->getType(), record);
+                    }
+                    if (recordSize > 0) channel->publish(record, recordSize);
+                }
+                const uint32_t time = getClock().millis();
+                size_t size = 0;
+                channelsMutex().take();
+                // channels can be added while the program runs, so make room for all of them. This only allocates
+                // when a channel has been added
+                frames.resize(channels().size() * MAX_FRAME_SIZE);
+                for (const std::unique_ptr<TelemetryChannel>& channel : channels()) {
+                    size += channel->encodePending(time, frames.data() + size);
+                }
+                channelsMutex().give();
+                // one write per tick, so frames from this task are never split up
+                if (size > 0) {
+                    std::fwrite(frames.data(), 1, size, stdout);
+                    std::fflush(stdout);
+                }
+                work.stop();
+                getClock().delayUntil(&prevTime, period);
+            }
+        },
+        TASK_PRIORITY_MIN + 1, TASK_STACK_DEPTH_DEFAULT, "lemlib telemetry");
+}
+} // namespace lemlib
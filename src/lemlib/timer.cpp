@@ -1,5 +1,6 @@
 #include "pros/rtos.hpp"
 #include "lemlib/timer.hpp"
+#include "lemlib/clock.hpp"
 
 using namespace lemlib;
 
@@ -11,14 +12,14 @@ using namespace lemlib;
  */
 Timer::Timer(uint32_t time)
     : period(time) {
-    lastTime = pros::millis();
+    lastTime = getClock().millis();
 }
 
 /**
  * Get the amount of time the timer is set to wait
  */
 uint32_t Timer::getTimeSet() {
-    const uint32_t time = pros::millis(); // get time from RTOS
+    const uint32_t time = getClock().millis(); // get time from the clock
     if (!paused) timeWaited += time - lastTime; // don't update if paused
     lastTime = time; // update last time
     return period;
@@ -28,7 +29,7 @@ uint32_t Timer::getTimeSet() {
  * Get the amount of time left on the timer
  */
 uint32_t Timer::getTimeLeft() {
-    const uint32_t time = pros::millis(); // get time from RTOS
+    const uint32_t time = getClock().millis(); // get time from the clock
     if (!paused) timeWaited += time - lastTime; // don't update is paused
     lastTime = time; // update last time
     const int delta = period - timeWaited; // calculate how much time is left
@@ -39,7 +40,7 @@ uint32_t Timer::getTimeLeft() {
  * Get the amount of time passed on the timer
  */
 uint32_t Timer::getTimePassed() {
-    const uint32_t time = pros::millis(); // get time from RTOS
+    const uint32_t time = getClock().millis(); // get time from the clock
     if (!paused) timeWaited += time - lastTime; // don't update is paused
     lastTime = time; // update last time;
     return timeWaited;
@@ -49,7 +50,7 @@ uint32_t Timer::getTimePassed() {
  * Whether the timer is done or not
  */
 bool Timer::isDone() {
-    const uint32_t time = pros::millis(); // get time from RTOS
+    const uint32_t time = getClock().millis(); // get time from the clock
     if (!paused) timeWaited += time - lastTime; // don't update is paused
     lastTime = time; // update last time
     const int delta = period - timeWaited; // calculate how much time is left
@@ -69,14 +70,14 @@ void Timer::set(uint32_t time) {
  */
 void Timer::reset() {
     timeWaited = 0;
-    lastTime = pros::millis();
+    lastTime = getClock().millis();
 }
 
 /**
  * Pause the timer
  */
 void Timer::pause() {
-    if (!paused) lastTime = pros::millis();
+    if (!paused) lastTime = getClock().millis();
     paused = true;
 }
 
@@ -84,7 +85,7 @@ void Timer::pause() {
  * Resume the timer
  */
 void Timer::resume() {
-    if (paused) lastTime = pros::millis();
+    if (paused) lastTime = getClock().millis();
     paused = false;
 }
 
@@ -92,6 +93,6 @@ void Timer::resume() {
  * Wait until the timer is done
  */
 void Timer::waitUntilDone() {
-    do pros::delay(5);
+    do getClock().delay(5);
     while (!this->isDone());
 }
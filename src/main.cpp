@@ -92,8 +92,40 @@ lemlib::OdomSensors sensors(nullptr, // vertical tracking wheel 1, set to null
 // create the chassis
 lemlib::Chassis chassis(drivetrain, linearController, angularController, sensors);
 
+// the lift holds itself at a target in the background, so it can move while the robot drives. It is measured with the
+// lift motor's encoder, so its angles are degrees of the motor like the old move_absolute targets, and the routes'
+// tare_position calls still zero it. Negative power raises this lift, which the lift handles as long as kG is negative
+// too. Drive the motor through lift.setVoltage and lift.setVelocity, so the lift lets go of it first.
+// TODO: gravity feedforward is off until kG is measured on the robot. Find the motor angle where the lift is
+// horizontal and set horizontalAngle to it, then hold the lift there and make kG more negative until it stays up on
+// its own. The feedforward takes one motor degree as one degree of the lift, so if the lift is geared, set gearRatio
+// to motor degrees per lift degree and divide the targets by it first
+lemlib::Lift lift(&rightside, nullptr,
+                  {.kP = 0.8, // proportional gain
+                   .kD = 2, // derivative gain
+                   .kG = 0, // power to hold the lift up when it is horizontal. Not measured yet, see above
+                   .maxVelocity = 3600, // 600 rpm
+                   .maxAcceleration = 18000, // reaches full speed in 200 ms
+                   .settleRange = 3, // degrees
+                   .settleTime = 50, // milliseconds
+                   .gearRatio = 1});
+
 bool auton_done = false;
 
+/**
+ * Records the pose, motion state and controller outputs at 100 Hz to a new file on the SD card. Called when the
+ * program starts and when it is connected to field control, so each match gets its own file even if the program was
+ * started long before it. Not called from autonomous, so nothing can delay the start of the route
+ */
+void openFlightRecord() {
+    if (!pros::usd::is_installed()) return;
+    static lemlib::FlightRecorderSink recorder;
+    recorder.startSampling(10);
+    recorder.open(fmt::format("lateral kP {} kD {} slew {}, angular kP {} kD {} slew {}", linearController.kP,
+                              linearController.kD, linearController.slew, angularController.kP, angularController.kD,
+                              angularController.slew));
+}
+
 /**
  * Runs initialization code. This occurs as soon as the program is started.
  *
@@ -101,9 +133,21 @@ bool auton_done = false;
  * to keep execution time for this mode under a few seconds.
  */
 void initialize() {
+    // decompress any compressed assets in static/, before anything uses them
+    lemlib::decompressAssets();
     pros::lcd::initialize(); // initialize brain screen
     chassis.calibrate(); // calibrate sensors
     chassis.setPose(0, 0, 0);
+    // compensate drive output so autons behave the same as the battery drains
+    lemlib::setVoltageCompensation(12000);
+    // publish cpu and stack usage of LemLib's tasks and the screen task every second
+    lemlib::startTaskMonitor(1000);
+    // stream the pose, compressed so 100 Hz fits over the radio, and the motion state. decode it with
+    // host/build/telemetry
+    lemlib::startBinaryTelemetry(10, {lemlib::RecordType::POSE_STREAM, lemlib::RecordType::MOTION});
+    // the motion state changes slowly, so send it at 20 Hz. Channels can be reconfigured at any time
+    lemlib::configureTelemetryChannel("motion", {.maxRate = 20});
+    openFlightRecord();
 
     rightside.tare_position();
     rotationalSensor.reset_position();
@@ -113,19 +157,24 @@ void initialize() {
     // lemlib::bufferedStdout().setRate(...);
     // If you use bluetooth or a wired connection, you will want to have a rate of 10ms
 
+    // format log messages on the logger's task, so logging from control loops is cheap
+    lemlib::infoSink()->setDeferred(true);
+    lemlib::telemetrySink()->setDeferred(true);
+
     // for more information on how the formatting for the loggers
     // works, refer to the fmtlib docs
 
-    // thread to for brain screen and position logging
+    // thread for the brain screen
     pros::Task screenTask([&]() {
         lemlib::Pose pose(0, 0, 0);
+        lemlib::MonitoredTask* const monitor = lemlib::monitoredTask("screen");
         while (true) {
+            lemlib::TaskWork work(monitor);
             // print robot location to the brain screen
             pros::lcd::print(0, "X: %f", chassis.getPose().x); // x
             pros::lcd::print(1, "Y: %f", chassis.getPose().y); // y
             pros::lcd::print(2, "Theta: %f", chassis.getPose().theta); // heading
-            // log position telemetry
-            lemlib::telemetrySink()->info("Chassis pose: {}", chassis.getPose());
+            work.stop();
             // delay to save resources
             pros::delay(50);
         }
@@ -136,77 +185,20 @@ void initialize() {
  * Runs while the robot is disabled
  */
 void disabled() {}
-void moveLiftToAngle(double targetAngle) {
-    rightside.set_brake_mode(pros::E_MOTOR_BRAKE_HOLD);
-    if (rotationalSensor.get_position() < targetAngle) {
-        // Move up
-        rightside.move_velocity(120000);
-        while (rotationalSensor.get_position() < targetAngle) {
-            pros::delay(1);
-        }
-    } else {
-        // Move down
-        rightside.move_velocity(-120000);
-        while (rotationalSensor.get_position() > targetAngle) {
-            pros::delay(1);
-        }
-    }
-    rightside.move_velocity(0);  // Stop motor when target is reached
-}
-
-void moveLiftToPos(double targetPosition, int speed) {
-    if (rotationalSensor.get_position() < targetPosition) {
-        // Move up
-        rightside.move_velocity(speed);
-        while (rotationalSensor.get_position() < targetPosition) {
-            pros::delay(10);
-        }
-    } else {
-        // Move down
-        rightside.move_velocity(-speed);
-        while (rotationalSensor.get_position() > targetPosition) {
-            pros::delay(10);
-        }
-    }
-    rightside.move_velocity(0);  // Stop motor when target is reached
-}
-
 void moveDrive(int ms) {
-    lB.move_velocity(6000);
-    lM.move_velocity(6000);
-    lF.move_velocity(6000);
-    rB.move_velocity(6000);
-    rM.move_velocity(6000);
-    rF.move_velocity(6000);
+    lemlib::queueVelocity(&leftMotors, 600);
+    lemlib::queueVelocity(&rightMotors, 600);
     pros::delay(ms);
-    lB.move_velocity(0);
-    lM.move_velocity(0);
-    lF.move_velocity(0);
-    rB.move_velocity(0);
-    rM.move_velocity(0);
-    rF.move_velocity(0);
+    lemlib::queueVelocity(&leftMotors, 0);
+    lemlib::queueVelocity(&rightMotors, 0);
 }
 
 void moveDriveBackward(int ms) {
-    lB.move_velocity(-6000);
-    lM.move_velocity(-6000);
-    lF.move_velocity(-6000);
-    rB.move_velocity(-6000);
-    rM.move_velocity(-6000);
-    rF.move_velocity(-6000);
+    lemlib::queueVelocity(&leftMotors, -600);
+    lemlib::queueVelocity(&rightMotors, -600);
     pros::delay(ms);
-    lB.move_velocity(0);
-    lM.move_velocity(0);
-    lF.move_velocity(0);
-    rB.move_velocity(0);
-    rM.move_velocity(0);
-    rF.move_velocity(0);
-}
-
-void moveLiftToPosition(int targetPosition, int velocity) {
-    rightside.set_brake_mode(pros::E_MOTOR_BRAKE_HOLD);
-    rightside.move_absolute(targetPosition, velocity);
-    while (std::abs(rightside.get_position() - targetPosition) > 3) { pros::delay(10); }
+    lemlib::queueVelocity(&leftMotors, 0);
+    lemlib::queueVelocity(&rightMotors, 0);
 }
 
 void winpointauton() {
@@ -697,7 +689,7 @@ void disruptor() {
 /**
  * runs after initialize if the robot is connected to field control
  */
-void competition_initialize() {}
+void competition_initialize() { openFlightRecord(); }
 
 // get a path used for pure pursuit
 // this needs to be put outside a function
@@ -716,9 +708,9 @@ void ladyBrownUp(int ms) {
     pros::delay(80);
     intakefirst.move_velocity(0);
     rightside.set_brake_mode(pros::E_MOTOR_BRAKE_HOLD);
-    rightside.move_voltage(-12000);
+    lift.setVoltage(-12000);
     pros::delay(ms);
-    rightside.move_voltage(0);   
+    lift.setVoltage(0);   
 }
 
 
@@ -728,9 +720,9 @@ void redallianceonestake() {
     rightside.set_brake_mode(pros::E_MOTOR_BRAKE_HOLD);
     chassis.moveToPoint(0, 3.25, 1000);
     chassis.waitUntilDone();
-    rightside.move_voltage(-12000);
+    lift.setVoltage(-12000);
     pros::delay(750);
-    rightside.move_voltage(0);
+    lift.setVoltage(0);
     pros::delay(100);
     chassis.moveToPoint(1, -3, 1000, false);
     chassis.turnTo(6, 1, 1000);
@@ -744,9 +736,9 @@ void redallianceonestake() {
     intake.move_voltage(-12000);
     intakefirst.move_voltage(-12000);
     chassis.turnTo(24, -46, 1000, true, 100);
-    rightside.move_velocity(12000);
+    lift.setVelocity(12000);
     pros::delay(1000);
-    rightside.move_velocity(0);
+    lift.setVelocity(0);
     chassis.moveToPoint(11.2, -32.9, 1000, true);
     rightside.tare_position();
     chassis.waitUntilDone();
@@ -874,9 +866,9 @@ void redalliancetwostake() {
     rightside.set_brake_mode(pros::E_MOTOR_BRAKE_HOLD);
     chassis.moveToPoint(0, 2.95, 1000);
     chassis.waitUntilDone();
-    rightside.move_voltage(-12000);
+    lift.setVoltage(-12000);
     pros::delay(750);
-    rightside.move_voltage(0);
+    lift.setVoltage(0);
     pros::delay(100);
     chassis.moveToPoint(0, -3, 1000, false);
     chassis.turnTo(-6, 0, 1000);
@@ -891,9 +883,9 @@ void redalliancetwostake() {
 
     chassis.turnTo(-48, -20, 1000, true, 80);
     chassis.waitUntilDone();
-    rightside.move_velocity(120000);
+    lift.setVelocity(120000);
     pros::delay(300);
-    rightside.move_velocity(0);
+    lift.setVelocity(0);
     chassis.moveToPoint(-20.7, -24, 1000, true, 90);
     chassis.waitUntilDone();
     pros::delay(100);
@@ -916,9 +908,9 @@ void redalliancetwostakestop() {
     pros::delay(4000);
     chassis.moveToPoint(0, 4, 1000);
     chassis.waitUntilDone();
-    rightside.move_voltage(-12000);
+    lift.setVoltage(-12000);
     pros::delay(750);
-    rightside.move_voltage(0);
+    lift.setVoltage(0);
     pros::delay(100);
     chassis.moveToPoint(0, -3, 1000, false);
     chassis.turnTo(-6, 0, 1000);
@@ -932,9 +924,9 @@ void redalliancetwostakestop() {
     intakefirst.move_voltage(-12000);
     chassis.turnTo(-48, -20, 1000, true, 80);
     chassis.waitUntilDone();
-    rightside.move_velocity(120000);
+    lift.setVelocity(120000);
     pros::delay(300);
-    rightside.move_velocity(0);
+    lift.setVelocity(0);
     chassis.moveToPoint(-21, -24, 1000, true, 90);
     chassis.waitUntilDone();
     pros::delay(100);
@@ -963,9 +955,9 @@ void blueallianceonestake() {
     rightside.set_brake_mode(pros::E_MOTOR_BRAKE_HOLD);
     chassis.moveToPoint(0, 3.07, 1000);
     chassis.waitUntilDone();
-    rightside.move_voltage(-12000);
+    lift.setVoltage(-12000);
     pros::delay(750);
-    rightside.move_voltage(0);
+    lift.setVoltage(0);
     pros::delay(100);
     chassis.moveToPoint(0, -3, 1000, false);
     chassis.turnTo(-6, 0.5, 1000);
@@ -978,9 +970,9 @@ void blueallianceonestake() {
     pros::delay(150);
     chassis.turnTo(-27, -46, 1000, true);
     chassis.waitUntilDone();
-    rightside.move_velocity(12000);
+    lift.setVelocity(12000);
     pros::delay(1100);
-    rightside.move_velocity(0);
+    lift.setVelocity(0);
     intake.move_voltage(-12000);
     intakefirst.move_voltage(-12000);
     chassis.moveToPoint(-20.1, -35, 1000, true);
@@ -1006,9 +998,9 @@ void bluealliancetwostake() {
     rightside.set_brake_mode(pros::E_MOTOR_BRAKE_HOLD);
     chassis.moveToPoint(0, 3.3, 1000);
     chassis.waitUntilDone();
-    rightside.move_voltage(-12000);
+    lift.setVoltage(-12000);
     pros::delay(750);
-    rightside.move_voltage(0);
+    lift.setVoltage(0);
     pros::delay(100);
     chassis.moveToPoint(0, -3, 1000, false);
     chassis.turnTo(6, 0, 1000);
@@ -1023,9 +1015,9 @@ void bluealliancetwostake() {
 
     chassis.turnTo(48, -20, 1000, true);
     chassis.waitUntilDone();
-    rightside.move_velocity(120000);
+    lift.setVelocity(120000);
     pros::delay(300);
-    rightside.move_velocity(0);
+    lift.setVelocity(0);
     chassis.moveToPoint(16.3, -24, 1000, true, 80);
     chassis.waitUntilDone();
     pros::delay(100);
@@ -1045,9 +1037,9 @@ void bluealliancetwostake() {
     clamper.set_value(1);
     pros::delay(400);
     chassis.moveToPoint(0, -27, 1000, true, 95);
-    rightside.move_voltage(12000);
+    lift.setVoltage(12000);
     pros::delay(1000);
-    rightside.move_voltage(0);
+    lift.setVoltage(0);
 }
 
 
@@ -1057,9 +1049,9 @@ void bluealliancetwostakestop() {
     rightside.set_brake_mode(pros::E_MOTOR_BRAKE_HOLD);
     chassis.moveToPoint(0, 3.1, 1000);
     chassis.waitUntilDone();
-    rightside.move_voltage(-12000);
+    lift.setVoltage(-12000);
     pros::delay(750);
-    rightside.move_voltage(0);
+    lift.setVoltage(0);
     pros::delay(100);
     chassis.moveToPoint(0, -3, 1000, false);
     chassis.turnTo(6, 0, 1000);
@@ -1075,9 +1067,9 @@ void bluealliancetwostakestop() {
 
     chassis.turnTo(48, -20, 1500, true, 70);
     chassis.waitUntilDone();
-    rightside.move_velocity(120000);
+    lift.setVelocity(120000);
     pros::delay(300);
-    rightside.move_velocity(0);
+    lift.setVelocity(0);
     chassis.moveToPoint(17.3, -24, 1000, true, 80);
     chassis.waitUntilDone();
     pros::delay(400);
@@ -1085,9 +1077,9 @@ void bluealliancetwostakestop() {
     chassis.waitUntilDone();
     clamper.set_value(0);
     pros::delay(200);
-    rightside.move_voltage(12000);
+    lift.setVoltage(12000);
     pros::delay(1000);
-    rightside.move_voltage(0);
+    lift.setVoltage(0);
 }
 
 void skillsRoute() {
@@ -1115,9 +1107,10 @@ void skillsRoute() {
     chassis.moveToPoint(29, 23, 1000);
     chassis.waitUntilDone();
     chassis.turnTo(29, 45, 1000);
-    moveLiftToPosition(-297, 12000);
+    lift.setTarget(-297);
     chassis.moveToPoint(29, 39, 1000); 
     chassis.waitUntilDone();
+    lift.waitUntilSettled();
     pros::delay(400);
     chassis.moveToPoint(27, 17, 1000, false);
     chassis.waitUntilDone();
@@ -1131,9 +1124,9 @@ void skillsRoute() {
     pros::delay(105);
     intake.move_velocity(0);
     intakefirst.move_velocity(0);
-    rightside.move_voltage(-12000);
+    lift.setVoltage(-12000);
     pros::delay(250);
-    rightside.move_voltage(0);
+    lift.setVoltage(0);
     chassis.waitUntilDone();
     intakefirst.move_velocity(-12000);
     intake.move_velocity(-12000);
@@ -1141,13 +1134,13 @@ void skillsRoute() {
     chassis.waitUntilDone();
     chassis.turnTo(99, 10.95, 1000);
     chassis.waitUntilDone();
-    rightside.move_velocity(-12000);
+    lift.setVelocity(-12000);
     pros::delay(1300);
-    rightside.move_velocity(0);
+    lift.setVelocity(0);
     pros::delay(200);
-    rightside.move_velocity(120000);
+    lift.setVelocity(120000);
     pros::delay(1000);
-    rightside.move_velocity(0);
+    lift.setVelocity(0);
     intake.move_voltage(-12000);
     intakefirst.move_voltage(-12000);
     chassis.moveToPoint(27, 14.7, 1000, false);
@@ -1309,8 +1302,9 @@ void rednegative() {
     chassis.moveToPoint(3, -2, 1000, true);
     chassis.waitUntilDone();
     chassis.turnTo(-12, -0.4, 1000);
-    moveLiftToPosition(-300, 12000);
+    lift.setTarget(-300);
     chassis.waitUntilDone();
+    lift.waitUntilSettled();
     chassis.moveToPoint(-8,-0.4, 3000);
     chassis.waitUntilDone();
     runIntake = false;
@@ -1318,7 +1312,7 @@ void rednegative() {
     intakefirst.move_velocity(0);
     ladyBrownUp(1000);
     chassis.moveToPoint(0, -6, 1000, false);
-    rightside.move_velocity(12000);
+    lift.setVelocity(12000);
 
     
     // ladyBrownUp(1000);
@@ -1370,6 +1364,7 @@ rednegative();
  * Runs in driver control
  */
 void opcontrol() {
+    lift.stop();
     rightside.tare_position();
     intake.set_reversed(true);
 
@@ -1384,6 +1379,7 @@ void opcontrol() {
     static bool leftwingtoggle {false};
     static bool intaketoggle {false};
     static bool hangToggle {false};
+    bool manualLift = false;
     // controller
     // loop to continuously update motors
     while (true) {
@@ -1400,6 +1396,7 @@ void opcontrol() {
 
         if (controller.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_LEFT)) { 
 
+    lift.stop();
     rightside.tare_position();
             
          }
@@ -1414,16 +1411,17 @@ void opcontrol() {
             }
         }
 
+        // the lift moves in the background, so driving doesn't stop while it does
         if (controller.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_DOWN)) {
         count = 0;
-        moveLiftToPosition(-313, 6000);
+        lift.setTarget(-313);
         }
 
          if (controller.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_RIGHT)) {
-        moveLiftToPosition(-502, 12000);
+        lift.setTarget(-502);
         }
 
-        if (controller.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_Y)) { moveLiftToPosition(0, 12000); }
+        if (controller.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_Y)) { lift.setTarget(0); }
 
         if (controller.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_UP)) {
             if (!hangToggle) {
@@ -1460,9 +1458,11 @@ void opcontrol() {
         }
 
         if (controller.get_digital(pros::E_CONTROLLER_DIGITAL_L2)) {
+            manualLift = true;
             rightside.set_brake_mode(pros::E_MOTOR_BRAKE_HOLD);
-            rightside.move_voltage(12000);
+            lift.setVoltage(12000);
         } else if (controller.get_digital(pros::E_CONTROLLER_DIGITAL_L1)) {
+                manualLift = true;
             
                 if (count == 1) {
                     intakefirst.move_velocity(500);
@@ -1471,11 +1471,13 @@ void opcontrol() {
                 }
                 count += 1;
                 rightside.set_brake_mode(pros::E_MOTOR_BRAKE_HOLD);
-                rightside.move_voltage(-12000);
+                lift.setVoltage(-12000);
             
            
-        } else {
-            rightside.move_velocity(0);
+        } else if (manualLift) {
+            // hold the lift where the driver let go of it
+            manualLift = false;
+            lift.setTarget(lift.getAngle());
         }
 
         pros::delay(10);